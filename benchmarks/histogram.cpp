@@ -0,0 +1,190 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include <boost/program_options.hpp>
+
+#include <handystats/chrono.hpp>
+#include <handystats/statistics.hpp>
+#include <handystats/log_linear_histogram.hpp>
+
+uint64_t samples = 1000000;
+uint64_t max_bins = 1000;
+
+static double elapsed_nsec(const handystats::chrono::time_point& start_time, const handystats::chrono::time_point& end_time) {
+	return handystats::chrono::duration::convert_to(handystats::chrono::time_unit::NSEC, end_time - start_time).count();
+}
+
+// Timer-like workload: samples are log-normally spread, timestamps advance by 1 usec.
+// Returns average time of statistics::update in nanoseconds.
+double measure_update(handystats::statistics& stats, const std::vector<double>& values) {
+	const auto base_time = handystats::chrono::tsc_clock::now();
+	const handystats::chrono::duration step(1, handystats::chrono::time_unit::USEC);
+
+	const auto start_time = handystats::chrono::tsc_clock::now();
+
+	for (size_t index = 0; index < values.size(); ++index) {
+		stats.update(values[index], base_time + step * int64_t(index));
+	}
+
+	const auto end_time = handystats::chrono::tsc_clock::now();
+
+	return elapsed_nsec(start_time, end_time) / values.size();
+}
+
+// Returns average time of p50, p90, p99 and p999 extraction (in a single pass) in nanoseconds.
+double measure_quantiles(const handystats::statistics& stats) {
+	const size_t ROUNDS = 1000;
+	double sink = 0;
+
+	const auto start_time = handystats::chrono::tsc_clock::now();
+
+	const std::vector<double> probabilities = {0.5, 0.9, 0.99, 0.999};
+
+	for (size_t round = 0; round < ROUNDS; ++round) {
+		const auto& quantile = stats.get<handystats::statistics::tag::quantile>();
+		const auto& values = quantile.at(probabilities);
+		sink += values[0] + values[1] + values[2] + values[3];
+	}
+
+	const auto end_time = handystats::chrono::tsc_clock::now();
+
+	if (sink < 0) {
+		std::cerr << sink << std::endl;
+	}
+
+	return elapsed_nsec(start_time, end_time) / ROUNDS;
+}
+
+// Returns average time of merging snapshot into accumulated statistics in nanoseconds.
+double measure_merge(const handystats::statistics& stats, const handystats::config::statistics& opts) {
+	const size_t ROUNDS = 1000;
+	handystats::statistics merged(opts);
+
+	const auto start_time = handystats::chrono::tsc_clock::now();
+
+	for (size_t round = 0; round < ROUNDS; ++round) {
+		merged.merge(stats);
+	}
+
+	const auto end_time = handystats::chrono::tsc_clock::now();
+
+	return elapsed_nsec(start_time, end_time) / ROUNDS;
+}
+
+int main(int argc, char** argv) {
+	namespace po = boost::program_options;
+	po::options_description desc("Options");
+	desc.add_options()
+		("help", "Print help messages")
+		("samples", po::value<uint64_t>(&samples)->default_value(samples),
+			"Number of samples per run"
+		)
+		("max-bins", po::value<uint64_t>(&max_bins)->default_value(max_bins),
+			"Maximum number of histogram bins"
+		)
+	;
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	}
+	catch(po::error& e) {
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << desc << std::endl;
+		return 1;
+	}
+
+	std::vector<double> values(samples);
+	for (auto& value : values) {
+		value = std::exp(10.0 * rand() / RAND_MAX);
+	}
+
+	std::cout << "histogram statistics, ns" << std::endl;
+	std::cout << std::setw(10) << "bins" << std::setw(16) << "update" << std::setw(16) << "4 quantiles" << std::setw(16) << "merge" << std::endl;
+
+	const uint64_t bins_steps[] = {10, 30, 100, 300, 1000, 3000, 10000};
+	for (const uint64_t& bins : bins_steps) {
+		if (bins > max_bins) {
+			break;
+		}
+
+		handystats::config::statistics opts;
+		opts.histogram_bins = bins;
+		opts.moving_interval = handystats::chrono::duration(1, handystats::chrono::time_unit::SEC);
+		opts.tags = handystats::statistics::tag::quantile;
+
+		handystats::statistics stats(opts);
+
+		const double update_time = measure_update(stats, values);
+		const double quantiles_time = measure_quantiles(stats);
+		const double merge_time = measure_merge(stats, opts);
+
+		std::cout << std::setw(10) << bins
+			<< std::setw(16) << std::fixed << std::setprecision(1) << update_time
+			<< std::setw(16) << std::fixed << std::setprecision(0) << quantiles_time
+			<< std::setw(16) << std::fixed << std::setprecision(0) << merge_time
+			<< std::endl;
+	}
+
+	std::cout << std::endl << "log-linear histogram statistics, ns" << std::endl;
+	std::cout << std::setw(10) << "digits" << std::setw(16) << "update" << std::setw(16) << "4 quantiles" << std::setw(16) << "merge" << std::endl;
+
+	for (size_t digits = handystats::log_linear_histogram::MIN_SIGNIFICANT_DIGITS;
+			digits <= handystats::log_linear_histogram::MAX_SIGNIFICANT_DIGITS;
+			++digits)
+	{
+		handystats::config::statistics opts;
+		opts.histogram_type = handystats::config::statistics::LOG_LINEAR;
+		opts.histogram_significant_digits = digits;
+		opts.moving_interval = handystats::chrono::duration(1, handystats::chrono::time_unit::SEC);
+		opts.tags = handystats::statistics::tag::quantile;
+
+		handystats::statistics stats(opts);
+
+		const double update_time = measure_update(stats, values);
+		const double quantiles_time = measure_quantiles(stats);
+		const double merge_time = measure_merge(stats, opts);
+
+		std::cout << std::setw(10) << digits
+			<< std::setw(16) << std::fixed << std::setprecision(1) << update_time
+			<< std::setw(16) << std::fixed << std::setprecision(0) << quantiles_time
+			<< std::setw(16) << std::fixed << std::setprecision(0) << merge_time
+			<< std::endl;
+	}
+
+	std::cout << std::endl << "quantile sketch statistics, ns" << std::endl;
+	std::cout << std::setw(10) << "accuracy" << std::setw(16) << "update" << std::setw(16) << "4 quantiles" << std::setw(16) << "merge" << std::endl;
+
+	const double accuracy_steps[] = {0.05, 0.01, 0.005};
+	for (const double& accuracy : accuracy_steps) {
+		handystats::config::statistics opts;
+		opts.histogram_type = handystats::config::statistics::SKETCH;
+		opts.sketch_relative_accuracy = accuracy;
+		opts.moving_interval = handystats::chrono::duration(1, handystats::chrono::time_unit::SEC);
+		opts.tags = handystats::statistics::tag::quantile;
+
+		handystats::statistics stats(opts);
+
+		const double update_time = measure_update(stats, values);
+		const double quantiles_time = measure_quantiles(stats);
+		const double merge_time = measure_merge(stats, opts);
+
+		std::cout << std::setw(10) << std::setprecision(3) << accuracy
+			<< std::setw(16) << std::fixed << std::setprecision(1) << update_time
+			<< std::setw(16) << std::fixed << std::setprecision(0) << quantiles_time
+			<< std::setw(16) << std::fixed << std::setprecision(0) << merge_time
+			<< std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include <boost/program_options.hpp>
+
+#include <handystats/chrono.hpp>
+
+#include "events/event_message_impl.hpp"
+#include "events/counter_impl.hpp"
+#include "message_queue_impl.hpp"
+#include "config_impl.hpp"
+
+uint64_t max_threads = std::thread::hardware_concurrency();
+uint64_t pushes = 50000;
+// large enough by default for producers not to be throttled by the consumer
+uint64_t ring_capacity = 65536;
+uint64_t log_capacity = 1 << 22;
+
+// Average cost of message_queue::push() in nanoseconds
+// with given number of producer threads and a single consumer.
+double measure_push_cost(const handystats::config::message_queue::topology_type& topology, const size_t& threads) {
+	handystats::config::message_queue_opts.topology = topology;
+	handystats::config::message_queue_opts.ring_capacity = ring_capacity;
+	handystats::config::message_queue_opts.log_capacity = log_capacity;
+
+	handystats::message_queue::initialize();
+
+	std::atomic<bool> stop_flag(false);
+	std::thread consumer(
+			[&stop_flag] () {
+				while (true) {
+					auto* message = handystats::message_queue::pop();
+					if (message) {
+						handystats::message_queue::release(&message, 1);
+					}
+					else if (stop_flag.load(std::memory_order_acquire) && handystats::message_queue::empty()) {
+						break;
+					}
+				}
+			}
+		);
+
+	std::vector<std::thread> producers(threads);
+	std::vector<double> push_cost(threads);
+	std::atomic<size_t> ready(0);
+
+	for (size_t index = 0; index < threads; ++index) {
+		producers[index] = std::thread(
+				[index, threads, &ready, &push_cost] () {
+					std::vector<handystats::events::event_message*> messages(pushes);
+					for (auto& message : messages) {
+						message = handystats::events::counter::create_increment_event(
+								std::string("bench.counter"), 1, handystats::chrono::tsc_clock::now()
+							);
+					}
+
+					++ready;
+					while (ready.load() < threads) {
+						std::this_thread::yield();
+					}
+
+					auto start_time = handystats::chrono::tsc_clock::now();
+					for (auto* message : messages) {
+						handystats::message_queue::push(message);
+					}
+					auto end_time = handystats::chrono::tsc_clock::now();
+
+					push_cost[index] =
+						double(
+							handystats::chrono::duration::convert_to(
+								handystats::chrono::time_unit::NSEC, end_time - start_time
+							).count()
+						) / pushes;
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	stop_flag.store(true, std::memory_order_release);
+	consumer.join();
+
+	handystats::message_queue::finalize();
+
+	double total_cost = 0;
+	for (auto& cost : push_cost) {
+		total_cost += cost;
+	}
+	return total_cost / threads;
+}
+
+int main(int argc, char** argv) {
+	namespace po = boost::program_options;
+	po::options_description desc("Options");
+	desc.add_options()
+		("help", "Print help messages")
+		("max-threads", po::value<uint64_t>(&max_threads)->default_value(max_threads),
+			"Maximum number of producer threads"
+		)
+		("pushes", po::value<uint64_t>(&pushes)->default_value(pushes),
+			"Number of pushes per producer thread"
+		)
+		("ring-capacity", po::value<uint64_t>(&ring_capacity)->default_value(ring_capacity),
+			"Per-thread ring capacity"
+		)
+		("log-capacity", po::value<uint64_t>(&log_capacity)->default_value(log_capacity),
+			"Per-thread log capacity in bytes"
+		)
+	;
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	}
+	catch(po::error& e) {
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << desc << std::endl;
+		return 1;
+	}
+
+	if (max_threads == 0 || pushes == 0) {
+		std::cerr << "ERROR: number of threads and pushes must be greater than 0" << std::endl;
+		return 1;
+	}
+
+	std::cout << "push cost, ns" << std::endl;
+	std::cout << std::setw(10) << "threads" << std::setw(12) << "global" << std::setw(12) << "per-thread" << std::setw(12) << "packed" << std::setw(12) << "per-cpu" << std::endl;
+
+	for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+		std::cout << std::setw(10) << threads
+			<< std::setw(12) << std::fixed << std::setprecision(1)
+			<< measure_push_cost(handystats::config::message_queue::GLOBAL, threads)
+			<< std::setw(12) << std::fixed << std::setprecision(1)
+			<< measure_push_cost(handystats::config::message_queue::PER_THREAD, threads)
+			<< std::setw(12) << std::fixed << std::setprecision(1)
+			<< measure_push_cost(handystats::config::message_queue::PACKED, threads)
+			<< std::setw(12) << std::fixed << std::setprecision(1)
+			<< measure_push_cost(handystats::config::message_queue::PER_CPU, threads)
+			<< std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+#include <boost/program_options.hpp>
+
+#include <handystats/chrono.hpp>
+#include <handystats/metrics.hpp>
+
+#include "metrics_table_impl.hpp"
+
+uint64_t max_metrics = 50000;
+uint64_t events = 1000000;
+
+// Processor-like workload: lookup metric by event's name and update it.
+// Returns throughput in events per second.
+template <typename Lookup>
+double measure_throughput(const std::vector<std::string>& event_names, Lookup lookup) {
+	auto start_time = handystats::chrono::tsc_clock::now();
+
+	for (auto name_iter = event_names.cbegin(); name_iter != event_names.cend(); ++name_iter) {
+		auto& metric_ptr = lookup(*name_iter);
+		auto* counter = boost::get<handystats::metrics::counter*>(metric_ptr);
+		if (!counter) {
+			metric_ptr = counter = new handystats::metrics::counter();
+		}
+		counter->increment(1, start_time);
+	}
+
+	auto end_time = handystats::chrono::tsc_clock::now();
+
+	return event_names.size() /
+		(double(handystats::chrono::duration::convert_to(handystats::chrono::time_unit::NSEC, end_time - start_time).count()) / 1e9);
+}
+
+template <typename Map>
+void delete_metrics(Map& metrics) {
+	for (auto metric_iter = metrics.begin(); metric_iter != metrics.end(); ++metric_iter) {
+		delete boost::get<handystats::metrics::counter*>(metric_iter->second);
+	}
+}
+
+int main(int argc, char** argv) {
+	namespace po = boost::program_options;
+	po::options_description desc("Options");
+	desc.add_options()
+		("help", "Print help messages")
+		("max-metrics", po::value<uint64_t>(&max_metrics)->default_value(max_metrics),
+			"Maximum number of distinct metrics"
+		)
+		("events", po::value<uint64_t>(&events)->default_value(events),
+			"Number of processed events per run"
+		)
+	;
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	}
+	catch(po::error& e) {
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << desc << std::endl;
+		return 1;
+	}
+
+	std::cout << "processor throughput, events/s" << std::endl;
+	std::cout << std::setw(10) << "metrics" << std::setw(16) << "std::map" << std::setw(16) << "metrics_table" << std::endl;
+
+	for (uint64_t metrics_count = 1000; metrics_count <= max_metrics; metrics_count *= 2) {
+		std::vector<std::string> event_names(events);
+		for (auto& name : event_names) {
+			name = "benchmark.metrics_table.counter." + std::to_string(rand() % metrics_count);
+		}
+
+		std::map<std::string, handystats::metrics::metric_ptr_variant> metrics_map;
+		const double map_throughput =
+			measure_throughput(event_names,
+					[&metrics_map] (const std::string& name) -> handystats::metrics::metric_ptr_variant& {
+						return metrics_map[name];
+					}
+				);
+		delete_metrics(metrics_map);
+
+		handystats::internal::metrics_table metrics_table;
+		const double table_throughput =
+			measure_throughput(event_names,
+					[&metrics_table] (const std::string& name) -> handystats::metrics::metric_ptr_variant& {
+						return metrics_table[name];
+					}
+				);
+		delete_metrics(metrics_table);
+
+		std::cout << std::setw(10) << metrics_count
+			<< std::setw(16) << std::fixed << std::setprecision(0) << map_throughput
+			<< std::setw(16) << std::fixed << std::setprecision(0) << table_throughput
+			<< std::endl;
+	}
+
+	return 0;
+}
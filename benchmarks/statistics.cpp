@@ -0,0 +1,113 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+
+#include <boost/program_options.hpp>
+
+#include <handystats/chrono.hpp>
+#include <handystats/statistics.hpp>
+
+uint64_t samples = 10000000;
+
+using handystats::statistics;
+
+// Returns average time of statistics::update in nanoseconds,
+// samples are log-normally spread, timestamps advance by 1 usec.
+double measure_update(const handystats::config::statistics& opts, const std::vector<double>& values) {
+	statistics stats(opts);
+
+	const auto base_time = handystats::chrono::tsc_clock::now();
+	// step is taken in timestamps' unit, so that timestamps are not converted in the loop
+	const handystats::chrono::duration step =
+		handystats::chrono::duration::convert_to(
+				base_time.time_since_epoch().unit(),
+				handystats::chrono::duration(1, handystats::chrono::time_unit::USEC)
+			);
+
+	const auto start_time = handystats::chrono::tsc_clock::now();
+
+	for (size_t index = 0; index < samples; ++index) {
+		stats.update(values[index % values.size()], base_time + step * int64_t(index));
+	}
+
+	const auto end_time = handystats::chrono::tsc_clock::now();
+
+	return double(handystats::chrono::duration::convert_to(handystats::chrono::time_unit::NSEC, end_time - start_time).count()) /
+		samples;
+}
+
+int main(int argc, char** argv) {
+	namespace po = boost::program_options;
+	po::options_description desc("Options");
+	desc.add_options()
+		("help", "Print help messages")
+		("samples", po::value<uint64_t>(&samples)->default_value(samples),
+			"Number of updates per configuration"
+		)
+	;
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	}
+	catch(po::error& e) {
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << desc << std::endl;
+		return 1;
+	}
+
+	std::vector<double> values(1 << 16);
+	for (auto& value : values) {
+		value = std::exp(10.0 * rand() / RAND_MAX);
+	}
+
+	const statistics::tag::type default_tags = handystats::config::statistics().tags;
+
+	std::vector<std::pair<std::string, handystats::config::statistics>> configurations;
+
+	handystats::config::statistics opts;
+	configurations.push_back(std::make_pair("default (gauge, timer)", opts));
+
+	opts.tags = statistics::tag::value | statistics::tag::timestamp;
+	configurations.push_back(std::make_pair("value", opts));
+
+	opts.tags = statistics::tag::rate;
+	configurations.push_back(std::make_pair("counter rate", opts));
+
+	opts.tags = default_tags | statistics::tag::rate;
+	configurations.push_back(std::make_pair("default + rate", opts));
+
+	opts.tags = default_tags | statistics::tag::quantile;
+	configurations.push_back(std::make_pair("timer with histogram", opts));
+
+	opts.histogram_type = handystats::config::statistics::LOG_LINEAR;
+	configurations.push_back(std::make_pair("timer with log-linear", opts));
+
+	opts.histogram_type = handystats::config::statistics::SKETCH;
+	configurations.push_back(std::make_pair("timer with sketch", opts));
+
+	opts = handystats::config::statistics();
+	opts.tags = default_tags | statistics::tag::moving_min | statistics::tag::moving_max | statistics::tag::rate;
+	opts.moving_window = handystats::config::statistics::BUCKETS;
+	configurations.push_back(std::make_pair("windowed", opts));
+
+	std::cout << "statistics update, ns" << std::endl;
+	for (auto configuration = configurations.cbegin(); configuration != configurations.cend(); ++configuration) {
+		std::cout << std::setw(28) << std::left << configuration->first
+			<< std::setw(10) << std::right << std::fixed << std::setprecision(1)
+			<< measure_update(configuration->second, values)
+			<< std::endl;
+	}
+
+	return 0;
+}
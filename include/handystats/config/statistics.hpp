@@ -3,6 +3,8 @@
 #ifndef HANDYSTATS_CONFIG_INCREMENTAL_STATISTICS_HPP_
 #define HANDYSTATS_CONFIG_INCREMENTAL_STATISTICS_HPP_
 
+#include <vector>
+
 #include <handystats/chrono.hpp>
 #include <handystats/rapidjson/document.h>
 
@@ -10,9 +12,38 @@ namespace handystats { namespace config {
 
 struct statistics {
 	chrono::duration moving_interval;
+
+	enum moving_window_kind {
+		// moving statistics are decayed linearly since the last update
+		DECAY,
+		// moving statistics are exact sums over moving_buckets sub-intervals of moving interval
+		BUCKETS
+	};
+	moving_window_kind moving_window;
+	size_t moving_buckets;
+	// additional windows of moving statistics, reported separately,
+	// each window is exact sum of its own moving_buckets buckets of moving_buckets-th part of its interval,
+	// i.e. every window costs moving_buckets * 48 bytes (480 bytes with default 10 buckets) per statistics
+	std::vector<chrono::duration> moving_intervals;
+
+	enum histogram_kind {
+		// bins of arbitrary centers, closest bins are merged down to histogram_bins
+		ADAPTIVE,
+		// fixed log-linear buckets of histogram_significant_digits precision
+		LOG_LINEAR,
+		// relative-error quantile sketch of at most sketch_max_buckets buckets
+		SKETCH
+	};
+	histogram_kind histogram_type;
 	size_t histogram_bins;
+	size_t histogram_significant_digits;
+	double sketch_relative_accuracy;
+	size_t sketch_max_buckets;
+
 	int tags;
 	chrono::time_unit rate_unit;
+	// probabilities of quantiles reported with quantile tag
+	std::vector<double> quantiles;
 
 	statistics();
 	void configure(const rapidjson::Value& config);
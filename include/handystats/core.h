@@ -41,6 +41,9 @@ void handystats_initialize();
 HANDYSTATS_EXTERN_C
 void handystats_finalize();
 
+HANDYSTATS_EXTERN_C
+void handystats_flush_thread();
+
 HANDYSTATS_EXTERN_C
 int handystats_config_file(const char* filename);
 
@@ -55,6 +58,8 @@ int handystats_config_json(const char* config);
 
 		#define HANDY_FINALIZE(...) handystats_finalize(__VA_ARGS__)
 
+		#define HANDY_FLUSH_THREAD(...) handystats_flush_thread(__VA_ARGS__)
+
 		#define HANDY_CONFIG_FILE(...) handystats_config_file(__VA_ARGS__)
 
 		#define HANDY_CONFIG_JSON(...) handystats_config_json(__VA_ARGS__)
@@ -65,6 +70,8 @@ int handystats_config_json(const char* config);
 
 		#define HANDY_FINALIZE(...)
 
+		#define HANDY_FLUSH_THREAD(...)
+
 		#define HANDY_CONFIG_FILE(...)
 
 		#define HANDY_CONFIG_JSON(...)
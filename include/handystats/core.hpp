@@ -8,12 +8,30 @@
 /*
  * {
  *     "core": {
- *         "enable": <boolean value>
+ *         "enable": <boolean value>,
+ *         "mode": <"queued" | "inline">,
+ *         "processor-threads": <integer value, number of metrics shards with own processor thread (own lock in inline mode)>,
+ *         "idle-spins": <integer value, empty queue polls before yielding>,
+ *         "idle-yields": <integer value, yields before parking>,
+ *         "idle-park-timeout": <value in msec, parking costs the processor a membarrier(2) call,
+ *                               so that producers of per-thread and packed topologies push without a full fence
+ *                               (where membarrier isn't available they pay a full fence per push)>,
+ *         "processor-affinity": [<cpu index>, <cpu index>, ...],
+ *         "processor-policy": <"other" | "batch" | "idle">,
+ *         "processor-nice": <integer value from -20 to 19>
  *     },
  *     "statistics": {
  *         "moving-interval": <value in msec>,
- *         "histogram-bins": <integer value>,
+ *         "moving-window": <"decay" | "buckets">,
+ *         "moving-buckets": <integer value, number of sub-intervals of moving interval in buckets window>,
+ *         "moving-intervals": [<value in msec>, ...] (each window is moving-buckets buckets of 48 bytes),
+ *         "histogram-type": <"adaptive" | "log-linear" | "sketch">,
+ *         "histogram-bins": <integer value, max number of adaptive histogram bins>,
+ *         "histogram-significant-digits": <integer value from 1 to 4, precision of log-linear histogram>,
+ *         "sketch-relative-accuracy": <value in (0, 1), quantile sketch's relative error>,
+ *         "sketch-max-buckets": <integer value, max number of quantile sketch's buckets (2048 by default, 12 bytes each)>,
  *         "tags": ["<tag name>", "<tag name>", ...],
+ *         "quantiles": [<probability>, <probability>, ...],
  *         "rate-unit": <"ns" | "us" | "ms" | "s" | "m" | "h">
  *     },
  *     "metrics": {
@@ -29,7 +47,20 @@
  *         }
  *     },
  *     "metrics-dump": {
- *         "interval": <value in msec>
+ *         "interval": <value in msec>,
+ *         "self-stats": <true | false, dump of handystats.self.* event path metrics, true by default>
+ *     },
+ *     "message-queue": {
+ *         "topology": <"global" | "per-thread" | "packed" | "per-cpu">,
+ *         "ring-capacity": <integer value, per-thread ring size in messages>,
+ *         "log-capacity": <integer value, per-thread log size in bytes for packed topology>,
+ *         "batch-size": <integer value, max number of messages processed at once>,
+ *         "capacity": <integer value, soft limit of messages in global queue (in each queue for per-cpu), 0 for unbounded>,
+ *         "overload-policy": <"block" | "drop-newest" | "sample">,
+ *         "block-timeout": <value in msec, 0 for no limit>,
+ *         "sample-every": <integer value N, only every N-th message is accepted while queue is more than half full>,
+ *         "producer-buffer": <integer value, messages collected by thread before publishing, 0 to disable>,
+ *         "producer-buffer-age": <value in msec, max age of buffered messages, buffers of idle threads are flushed by the processor>
  *     }
  * }
  */
@@ -41,6 +72,9 @@ void initialize();
 
 void finalize();
 
+// Publishes events buffered by the calling thread (see message-queue producer-buffer option)
+void flush_thread();
+
 bool config_file(const char* filename);
 bool config_json(const char* config);
 bool config_json(const rapidjson::Value& config);
@@ -54,6 +88,8 @@ bool config_json(const rapidjson::Value& config);
 
 	#define HANDY_FINALIZE(...) handystats::finalize(__VA_ARGS__)
 
+	#define HANDY_FLUSH_THREAD(...) handystats::flush_thread(__VA_ARGS__)
+
 	#define HANDY_CONFIG_FILE(...) handystats::config_file(__VA_ARGS__)
 
 	#define HANDY_CONFIG_JSON(...) handystats::config_json(__VA_ARGS__)
@@ -64,6 +100,8 @@ bool config_json(const rapidjson::Value& config);
 
 	#define HANDY_FINALIZE(...)
 
+	#define HANDY_FLUSH_THREAD(...)
+
 	#define HANDY_CONFIG_FILE(...)
 
 	#define HANDY_CONFIG_JSON(...)
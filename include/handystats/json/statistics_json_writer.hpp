@@ -5,6 +5,7 @@
 
 #include <string>
 #include <algorithm>
+#include <cstdio>
 
 #include <handystats/rapidjson/document.h>
 #include <handystats/rapidjson/stringbuffer.h>
@@ -15,6 +16,47 @@
 
 namespace handystats { namespace json {
 
+// p50 for 0.5, p999 for 0.999, p9_91 for 0.0991.
+// Percents of at least 10 have two integer digits, so their point is dropped,
+// fractional percents below 10 keep it as '_' (otherwise 0.0991 would be named as 0.991).
+inline std::string quantile_name(const double& probability) {
+	char percent[32];
+	snprintf(percent, sizeof(percent), "%.10g", probability * 100);
+
+	const bool keep_point = probability * 100 < 10;
+
+	std::string name("p");
+	for (const char* symbol = percent; *symbol; ++symbol) {
+		if (*symbol != '.') {
+			name += *symbol;
+		}
+		else if (keep_point) {
+			name += '_';
+		}
+	}
+	return name;
+}
+
+// 1s for 1000 msec, 5m for 300000 msec, 1500ms for 1500 msec
+inline std::string interval_name(const chrono::duration& interval) {
+	const int64_t& msec = chrono::duration::convert_to(chrono::time_unit::MSEC, interval).count();
+
+	char name[32];
+	if (msec % (60 * 60 * 1000) == 0) {
+		snprintf(name, sizeof(name), "%lldh", (long long)(msec / (60 * 60 * 1000)));
+	}
+	else if (msec % (60 * 1000) == 0) {
+		snprintf(name, sizeof(name), "%lldm", (long long)(msec / (60 * 1000)));
+	}
+	else if (msec % 1000 == 0) {
+		snprintf(name, sizeof(name), "%llds", (long long)(msec / 1000));
+	}
+	else {
+		snprintf(name, sizeof(name), "%lldms", (long long)msec);
+	}
+	return std::string(name);
+}
+
 template <typename Allocator>
 inline void write_to_json_value(const statistics* const obj, rapidjson::Value* json_value, Allocator& allocator) {
 	if (!obj) {
@@ -75,11 +117,12 @@ inline void write_to_json_value(const statistics* const obj, rapidjson::Value* j
 	}
 	if (obj->enabled(statistics::tag::quantile)) {
 		auto quantile = obj->get<statistics::tag::quantile>();
-		json_value->AddMember("p25", quantile.at(0.25), allocator);
-		json_value->AddMember("p50", quantile.at(0.50), allocator);
-		json_value->AddMember("p75", quantile.at(0.75), allocator);
-		json_value->AddMember("p90", quantile.at(0.90), allocator);
-		json_value->AddMember("p95", quantile.at(0.95), allocator);
+		const auto& probabilities = quantile.probabilities();
+		const auto& values = quantile.values();
+		for (size_t index = 0; index < probabilities.size(); ++index) {
+			rapidjson::Value quantile_value(values[index]);
+			json_value->AddMember(quantile_name(probabilities[index]).c_str(), allocator, quantile_value, allocator);
+		}
 	}
 	if (obj->enabled(statistics::tag::timestamp)) {
 		rapidjson::Value timestamp_value;
@@ -92,6 +135,37 @@ inline void write_to_json_value(const statistics* const obj, rapidjson::Value* j
 	if (obj->enabled(statistics::tag::entropy)) {
 		json_value->AddMember("entropy", obj->get<statistics::tag::entropy>(), allocator);
 	}
+	if (obj->enabled(statistics::tag::moving_min)) {
+		json_value->AddMember("moving-min", obj->get<statistics::tag::moving_min>(), allocator);
+	}
+	if (obj->enabled(statistics::tag::moving_max)) {
+		json_value->AddMember("moving-max", obj->get<statistics::tag::moving_max>(), allocator);
+	}
+
+	// each of moving intervals is a block of its moving statistics
+	const auto& windows = obj->moving_windows();
+	for (auto window = windows.cbegin(); window != windows.cend(); ++window) {
+		rapidjson::Value window_value(rapidjson::kObjectType);
+		if (obj->enabled(statistics::tag::moving_count)) {
+			window_value.AddMember("moving-count", window->moving_count, allocator);
+		}
+		if (obj->enabled(statistics::tag::moving_sum)) {
+			window_value.AddMember("moving-sum", window->moving_sum, allocator);
+		}
+		if (obj->enabled(statistics::tag::moving_avg)) {
+			window_value.AddMember("moving-avg", window->moving_avg, allocator);
+		}
+		if (obj->enabled(statistics::tag::rate)) {
+			window_value.AddMember("rate", window->rate, allocator);
+		}
+		if (obj->enabled(statistics::tag::moving_min)) {
+			window_value.AddMember("moving-min", window->moving_min, allocator);
+		}
+		if (obj->enabled(statistics::tag::moving_max)) {
+			window_value.AddMember("moving-max", window->moving_max, allocator);
+		}
+		json_value->AddMember(interval_name(window->interval).c_str(), allocator, window_value, allocator);
+	}
 }
 
 template<typename StringBuffer, typename Allocator>
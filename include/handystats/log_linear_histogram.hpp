@@ -0,0 +1,92 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_LOG_LINEAR_HISTOGRAM_HPP_
+#define HANDYSTATS_LOG_LINEAR_HISTOGRAM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <handystats/weighted_buckets.hpp>
+
+namespace handystats {
+
+/*
+ * Histogram with fixed log-linear buckets (as in HDR histogram).
+ * Each power of two range is split into 2^k equal buckets, where 2^k >= 10^significant_digits,
+ * so bucket's width relative to its values is at most 10^-significant_digits.
+ * Bucket of positive value is the top bits of its IEEE 754 representation (exponent and k bits of mantissa),
+ * zero has its own bucket and negative values are kept in mirrored buckets.
+ *
+ * Buckets are stored sparsely by power of two ranges: only ranges with added values are allocated
+ * (2^k counts each, 8 bytes per count), so outliers far from the bulk of values cost a single range.
+ */
+class log_linear_histogram {
+public:
+	typedef value_bucket bucket;
+
+	static const size_t MIN_SIGNIFICANT_DIGITS = 1;
+	static const size_t MAX_SIGNIFICANT_DIGITS = 4;
+
+	log_linear_histogram(const size_t& significant_digits = 2);
+
+	void reset();
+
+	void add(const double& value, const double& count = 1.0);
+
+	// Multiplies all counts by factor, factor <= 0 clears the histogram
+	void scale(const double& factor);
+
+	// Buckets of other histogram are added by their centers,
+	// with the same precision bucket-to-bucket
+	void merge(const log_linear_histogram& other);
+
+	// Non-empty buckets in ascending order
+	std::vector<bucket> buckets() const;
+
+	double count() const;
+
+	// Value is interpolated within the bucket of the required count
+	double quantile(const double& probability) const;
+	// Quantiles of ascending probabilities in a single pass over buckets
+	std::vector<double> quantiles(const std::vector<double>& probabilities) const;
+
+	size_t significant_digits() const;
+
+	// Max bucket's width relative to its values
+	double relative_error() const;
+
+private:
+	// Buckets' counts of single power of two range
+	struct bucket_page {
+		uint64_t first_key;
+		std::vector<double> counts;
+	};
+
+	// Allocated power of two ranges ordered by key
+	struct bucket_range {
+		std::vector<bucket_page> pages;
+
+		double& at(const uint64_t& key, const size_t& bucket_bits);
+
+		void clear();
+		double total() const;
+		void divide(const double& divisor);
+	};
+
+	uint64_t key(const double& value) const;
+	double lower_bound(const uint64_t& key) const;
+
+	void merge_range(bucket_range& range, const bucket_range& other, const log_linear_histogram& other_histogram);
+
+	void append_buckets(const bucket_range& range, const bool& negative, std::vector<bucket>& result) const;
+
+	size_t m_significant_digits;
+	size_t m_bucket_bits;
+
+	weighted_buckets<bucket_range> m_buckets;
+};
+
+} // namespace handystats
+
+#endif // HANDYSTATS_LOG_LINEAR_HISTOGRAM_HPP_
@@ -8,6 +8,8 @@
 #include <string>
 
 #include <handystats/metrics/attribute.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metric_literal.hpp>
 
 
 namespace handystats { namespace measuring_points {
@@ -75,6 +77,38 @@ void attribute_set<std::string>(
 		const handystats::metrics::attribute::time_point& timestamp
 	);
 
+void attribute_set(
+		const handystats::metric_handle& attribute_handle,
+		const handystats::metrics::attribute::value_type& value,
+		const handystats::metrics::attribute::time_point& timestamp = handystats::metrics::attribute::clock::now()
+	);
+
+template <typename ValueType>
+void attribute_set(
+		const handystats::metric_handle& attribute_handle,
+		const ValueType& value,
+		const handystats::metrics::attribute::time_point& timestamp = handystats::metrics::attribute::clock::now()
+	)
+{
+	attribute_set(attribute_handle, handystats::metrics::attribute::value_type(value), timestamp);
+}
+
+void attribute_set(
+		const handystats::metric_literal& attribute_literal,
+		const handystats::metrics::attribute::value_type& value,
+		const handystats::metrics::attribute::time_point& timestamp = handystats::metrics::attribute::clock::now()
+	);
+
+template <typename ValueType>
+void attribute_set(
+		const handystats::metric_literal& attribute_literal,
+		const ValueType& value,
+		const handystats::metrics::attribute::time_point& timestamp = handystats::metrics::attribute::clock::now()
+	)
+{
+	attribute_set(attribute_literal, handystats::metrics::attribute::value_type(value), timestamp);
+}
+
 }} // namespace handystats::measuring_points
 
 
@@ -116,4 +150,9 @@ void attribute_set<std::string>(
 
 #endif
 
+/*
+ * HANDY_ATTRIBUTE_HANDLE resolves attribute name to handle accepted by attribute measuring points instead of the name.
+ */
+#define HANDY_ATTRIBUTE_HANDLE(...) HANDY_METRIC_HANDLE(__VA_ARGS__)
+
 #endif // HANDYSTATS_ATTRIBUTE_MEASURING_POINTS_HPP_
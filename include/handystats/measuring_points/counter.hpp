@@ -10,6 +10,8 @@
 
 #include <handystats/metrics/counter.hpp>
 #include <handystats/macro_overload.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metric_literal.hpp>
 
 
 namespace handystats { namespace measuring_points {
@@ -20,41 +22,101 @@ void counter_init(
 		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
 		);
 
+void counter_init(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& init_value = handystats::metrics::counter::value_type(),
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
+void counter_init(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& init_value = handystats::metrics::counter::value_type(),
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
 void counter_increment(
 		std::string&& counter_name,
 		const handystats::metrics::counter::value_type& value = 1,
 		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
 		);
 
+void counter_increment(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& value = 1,
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
+void counter_increment(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& value = 1,
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
 void counter_decrement(
 		std::string&& counter_name,
 		const handystats::metrics::counter::value_type& value = 1,
 		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
 		);
 
+void counter_decrement(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& value = 1,
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
+void counter_decrement(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& value = 1,
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
 void counter_change(
 		std::string&& counter_name,
 		const handystats::metrics::counter::value_type& value,
 		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
 		);
 
+void counter_change(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
+void counter_change(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp = handystats::metrics::counter::clock::now()
+		);
+
 /*
  * Helper struct.
  * On construction HANDY_COUNTER_CHANGE event with +delta value is generated.
  * On destruction HANDY_COUNTER_CHANGE event with -delta value is generated.
  */
 struct scoped_counter_helper {
-	const std::string counter_name;
+	std::string counter_name;
+	const handystats::metric_literal counter_literal;
 	const handystats::metrics::counter::value_type delta_value;
 
 	scoped_counter_helper(std::string&& counter_name, const handystats::metrics::counter::value_type& delta_value)
-		: counter_name(std::move(counter_name)), delta_value(delta_value)
+		: counter_name(std::move(counter_name)), counter_literal(), delta_value(delta_value)
 	{
 		counter_change(this->counter_name.substr(), delta_value);
 	}
 
+	scoped_counter_helper(const handystats::metric_literal& counter_literal, const handystats::metrics::counter::value_type& delta_value)
+		: counter_name(), counter_literal(counter_literal), delta_value(delta_value)
+	{
+		counter_change(counter_literal, delta_value);
+	}
+
 	~scoped_counter_helper() {
-		counter_change(counter_name.substr(), -delta_value);
+		if (counter_literal.name) {
+			counter_change(counter_literal, -delta_value);
+		}
+		else {
+			counter_change(std::move(counter_name), -delta_value);
+		}
 	}
 };
 
@@ -83,6 +145,11 @@ struct scoped_counter_helper {
 
 #endif
 
+/*
+ * HANDY_COUNTER_HANDLE resolves counter name to handle accepted by counter measuring points instead of the name.
+ */
+#define HANDY_COUNTER_HANDLE(...) HANDY_METRIC_HANDLE(__VA_ARGS__)
+
 
 /*
  * Helper scope macros.
@@ -6,6 +6,8 @@
 #include <string>
 
 #include <handystats/metrics/gauge.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metric_literal.hpp>
 
 
 namespace handystats { namespace measuring_points {
@@ -16,12 +18,36 @@ void gauge_init(
 		const handystats::metrics::gauge::time_point& timestamp = handystats::metrics::gauge::clock::now()
 	);
 
+void gauge_init(
+		const handystats::metric_handle& gauge_handle,
+		const handystats::metrics::gauge::value_type& init_value,
+		const handystats::metrics::gauge::time_point& timestamp = handystats::metrics::gauge::clock::now()
+	);
+
+void gauge_init(
+		const handystats::metric_literal& gauge_literal,
+		const handystats::metrics::gauge::value_type& init_value,
+		const handystats::metrics::gauge::time_point& timestamp = handystats::metrics::gauge::clock::now()
+	);
+
 void gauge_set(
 		std::string&& gauge_name,
 		const handystats::metrics::gauge::value_type& value,
 		const handystats::metrics::gauge::time_point& timestamp = handystats::metrics::gauge::clock::now()
 	);
 
+void gauge_set(
+		const handystats::metric_handle& gauge_handle,
+		const handystats::metrics::gauge::value_type& value,
+		const handystats::metrics::gauge::time_point& timestamp = handystats::metrics::gauge::clock::now()
+	);
+
+void gauge_set(
+		const handystats::metric_literal& gauge_literal,
+		const handystats::metrics::gauge::value_type& value,
+		const handystats::metrics::gauge::time_point& timestamp = handystats::metrics::gauge::clock::now()
+	);
+
 }} // namespace handystats::measuring_points
 
 
@@ -39,4 +65,11 @@ void gauge_set(
 
 #endif
 
+/*
+ * HANDY_GAUGE_HANDLE resolves gauge name to handle accepted by gauge measuring points instead of the name.
+ * If gauges are configured to compute only value and timestamp statistics
+ * gauge sets through handles bypass the message queue and only the last value per metrics dump is applied.
+ */
+#define HANDY_GAUGE_HANDLE(...) HANDY_METRIC_HANDLE(__VA_ARGS__)
+
 #endif // HANDYSTATS_GAUGE_MEASURING_POINTS_HPP_
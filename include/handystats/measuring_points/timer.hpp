@@ -11,6 +11,8 @@
 
 #include <handystats/metrics/timer.hpp>
 #include <handystats/macro_overload.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metric_literal.hpp>
 
 
 namespace handystats { namespace measuring_points {
@@ -21,53 +23,136 @@ void timer_init(
 		const chrono::time_point& timestamp = chrono::tsc_clock::now()
 	);
 
+void timer_init(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
+void timer_init(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
 void timer_start(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
 		const chrono::time_point& timestamp = chrono::tsc_clock::now()
 	);
 
+void timer_start(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
+void timer_start(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
 void timer_stop(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
 		const chrono::time_point& timestamp = chrono::tsc_clock::now()
 	);
 
+void timer_stop(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
+void timer_stop(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
 void timer_discard(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
 		const chrono::time_point& timestamp = chrono::tsc_clock::now()
 	);
 
+void timer_discard(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
+void timer_discard(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
 void timer_heartbeat(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
 		const chrono::time_point& timestamp = chrono::tsc_clock::now()
 	);
 
+void timer_heartbeat(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
+void timer_heartbeat(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id = metrics::timer::DEFAULT_INSTANCE_ID,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
 void timer_set(
 		std::string&& timer_name,
 		const metrics::timer::value_type& measurement,
 		const chrono::time_point& timestamp = chrono::tsc_clock::now()
 	);
 
+void timer_set(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::value_type& measurement,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
+void timer_set(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::value_type& measurement,
+		const chrono::time_point& timestamp = chrono::tsc_clock::now()
+	);
+
 /*
  * Helper struct.
  * On construction HANDY_TIMER_START event is generated.
  * On destruction HANDY_TIMER_STOP event is generated.
  */
 struct scoped_timer_helper {
-	const std::string timer_name;
+	std::string timer_name;
+	const handystats::metric_literal timer_literal;
 	const chrono::time_point start_time;
 
 	scoped_timer_helper(std::string&& timer_name, const chrono::time_point& start_time)
-		: timer_name(std::move(timer_name)), start_time(start_time)
+		: timer_name(std::move(timer_name)), timer_literal(), start_time(start_time)
+	{
+	}
+
+	scoped_timer_helper(const handystats::metric_literal& timer_literal, const chrono::time_point& start_time)
+		: timer_name(), timer_literal(timer_literal), start_time(start_time)
 	{
 	}
 
 	~scoped_timer_helper() {
 		auto end_time = chrono::tsc_clock::now();
-		timer_set(timer_name.substr(), end_time - start_time);
+		if (timer_literal.name) {
+			timer_set(timer_literal, end_time - start_time);
+		}
+		else {
+			timer_set(std::move(timer_name), end_time - start_time);
+		}
 	}
 };
 
@@ -104,6 +189,11 @@ struct scoped_timer_helper {
 
 #endif
 
+/*
+ * HANDY_TIMER_HANDLE resolves timer name to handle accepted by timer measuring points instead of the name.
+ */
+#define HANDY_TIMER_HANDLE(...) HANDY_METRIC_HANDLE(__VA_ARGS__)
+
 
 /*
  * Helper scope macros.
@@ -0,0 +1,59 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_METRIC_HANDLE_HPP_
+#define HANDYSTATS_METRIC_HANDLE_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace handystats {
+
+/*
+ * Metric name resolved once to dense integer id.
+ * Events generated through handle carry only the id instead of the metric name.
+ * Handles stay valid for the whole life of the process (across initialize/finalize).
+ */
+struct metric_handle {
+	typedef uint32_t id_type;
+
+	static const id_type INVALID_ID = id_type(-1);
+
+	id_type id;
+	// hash of the metric name, events of the handle are routed by it
+	uint64_t hash;
+
+	metric_handle()
+		: id(INVALID_ID)
+		, hash(0)
+	{}
+
+	explicit metric_handle(const id_type& id, const uint64_t& hash = 0)
+		: id(id)
+		, hash(hash)
+	{}
+
+	bool valid() const {
+		return id != INVALID_ID;
+	}
+};
+
+namespace measuring_points {
+
+metric_handle resolve_handle(const std::string& metric_name);
+
+} // namespace measuring_points
+
+} // namespace handystats
+
+
+#ifndef HANDYSTATS_DISABLE
+
+	#define HANDY_METRIC_HANDLE(metric_name) handystats::measuring_points::resolve_handle(metric_name)
+
+#else
+
+	#define HANDY_METRIC_HANDLE(metric_name) handystats::metric_handle()
+
+#endif
+
+#endif // HANDYSTATS_METRIC_HANDLE_HPP_
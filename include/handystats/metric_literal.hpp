@@ -0,0 +1,54 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_METRIC_LITERAL_HPP_
+#define HANDYSTATS_METRIC_LITERAL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace handystats {
+
+/*
+ * FNV-1a 64-bit hash suitable for constant expressions.
+ * Hashing stops at the first NUL within length, as with strlen() of the name.
+ */
+constexpr uint64_t fnv1a_hash(const char* str, const size_t& length, const uint64_t& hash = 14695981039346656037ULL) {
+	return length == 0 || *str == '\0'
+		? hash
+		: fnv1a_hash(str + 1, length - 1, (hash ^ static_cast<unsigned char>(*str)) * 1099511628211ULL);
+}
+
+/*
+ * Metric name given by string literal.
+ * Hash of the name is computed by constexpr constructor (folded at compile time for literals),
+ * only pointer to the literal and its hash are carried by events.
+ *
+ * Literals are built only with "name"_metric (using namespace handystats::literals),
+ * other character arrays and strings passed to measuring points are copied.
+ */
+struct metric_literal {
+	const char* name;
+	uint64_t hash;
+
+	constexpr metric_literal()
+		: name(nullptr)
+		, hash(0)
+	{}
+
+	constexpr metric_literal(const char* name, const size_t& length)
+		: name(name)
+		, hash(fnv1a_hash(name, length))
+	{}
+};
+
+namespace literals {
+
+constexpr metric_literal operator"" _metric(const char* name, size_t length) {
+	return metric_literal(name, length);
+}
+
+} // namespace literals
+
+} // namespace handystats
+
+#endif // HANDYSTATS_METRIC_LITERAL_HPP_
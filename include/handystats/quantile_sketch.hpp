@@ -0,0 +1,91 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_QUANTILE_SKETCH_HPP_
+#define HANDYSTATS_QUANTILE_SKETCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <handystats/weighted_buckets.hpp>
+
+namespace handystats {
+
+/*
+ * Relative-error quantile sketch (DDSketch).
+ * Value v > 0 falls into bucket i = ceil(log_gamma(v)), gamma = (1 + alpha) / (1 - alpha),
+ * bucket is represented by 2 gamma^i / (gamma + 1), which is within alpha relative error of its values.
+ * Zero has its own bucket, negative values are kept in mirrored buckets.
+ *
+ * Only non-empty buckets are stored (12 bytes each), max_buckets buckets cover values
+ * of gamma^max_buckets range: with default alpha = 0.01 and 2048 buckets it's about 10^17.
+ * Once number of buckets exceeds max_buckets the buckets closest to zero are collapsed
+ * into the lowest remaining one of their sign. After that the alpha guarantee holds only for values
+ * of at least the lowest remaining bucket's magnitude: quantiles of lower magnitudes
+ * (the lowest quantiles of positive values, the highest of negative ones)
+ * are reported as the lowest remaining bucket's value, i.e. overestimated in magnitude.
+ */
+class quantile_sketch {
+public:
+	typedef value_bucket bucket;
+
+	quantile_sketch(const double& relative_accuracy = 0.01, const size_t& max_buckets = 2048);
+
+	void reset();
+
+	void add(const double& value, const double& count = 1.0);
+
+	// Multiplies all counts by factor, factor <= 0 clears the sketch
+	void scale(const double& factor);
+
+	// Sketches of the same accuracy are merged bucket-to-bucket,
+	// otherwise other sketch's buckets are added by their values
+	void merge(const quantile_sketch& other);
+
+	// Non-empty buckets in ascending order
+	std::vector<bucket> buckets() const;
+
+	double count() const;
+
+	// Value of the bucket of the required count
+	double quantile(const double& probability) const;
+	// Quantiles of ascending probabilities in a single pass over buckets
+	std::vector<double> quantiles(const std::vector<double>& probabilities) const;
+
+	double relative_accuracy() const;
+
+	size_t max_buckets() const;
+
+private:
+	// Non-empty buckets ordered by key
+	struct bucket_store {
+		std::vector<int32_t> keys;
+		std::vector<double> counts;
+
+		void add(const int32_t& key, const double& count);
+		// merges the lowest bucket into the next one
+		void collapse_lowest();
+
+		void clear();
+		double total() const;
+		void divide(const double& divisor);
+	};
+
+	int32_t key(const double& value) const;
+	double lower_bound(const int32_t& key) const;
+	double value(const int32_t& key) const;
+
+	void add_to_store(bucket_store& store, const int32_t& key, const double& stored_count);
+
+	double m_relative_accuracy;
+	size_t m_max_buckets;
+
+	double m_gamma;
+	double m_log_gamma;
+
+	weighted_buckets<bucket_store> m_buckets;
+};
+
+} // namespace handystats
+
+#endif // HANDYSTATS_QUANTILE_SKETCH_HPP_
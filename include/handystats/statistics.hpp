@@ -5,6 +5,8 @@
 
 #include <utility>
 #include <vector>
+#include <map>
+#include <set>
 #include <string>
 #include <exception>
 #include <tuple>
@@ -12,6 +14,8 @@
 #include <handystats/common.h>
 #include <handystats/chrono.hpp>
 #include <handystats/config/statistics.hpp>
+#include <handystats/log_linear_histogram.hpp>
+#include <handystats/quantile_sketch.hpp>
 
 namespace handystats {
 
@@ -35,11 +39,30 @@ public:
 
 	// quantile extractor
 	// result of statistics::get<tag::quantile>
+	// histogram is taken once on construction, so extract all required quantiles from single extractor
 	struct quantile_extractor {
 		quantile_extractor(const statistics* const = nullptr);
 		double at(const double& probability) const;
+		// all quantiles are found in a single pass over the histogram
+		std::vector<double> at(const std::vector<double>& probabilities) const;
+
+		// configured quantiles (config::statistics::quantiles), computed once on first request
+		const std::vector<double>& probabilities() const;
+		const std::vector<double>& values() const;
 	private:
-		const statistics* const m_statistics;
+		std::vector<double> sorted_at(const std::vector<double>& probabilities) const;
+
+		std::vector<double> m_probabilities;
+		mutable std::vector<double> m_values;
+		mutable bool m_values_computed;
+
+		histogram_type m_histogram;
+		// log-linear histogram's quantiles are interpolated within bucket's bounds
+		bool m_log_linear;
+		log_linear_histogram m_log_linear_histogram;
+		// sketch's quantiles are values of its buckets
+		bool m_sketch;
+		quantile_sketch m_quantile_sketch;
 	};
 	friend struct quantile_extractor;
 
@@ -62,6 +85,8 @@ public:
 		static const type timestamp = 1 << 12;
 		static const type rate = 1 << 13;
 		static const type entropy = 1 << 14;
+		static const type moving_min = 1 << 15;
+		static const type moving_max = 1 << 16;
 
 		static type from_string(const std::string&);
 	};
@@ -87,12 +112,16 @@ public:
 		, enable_if_eq<Tag, tag::timestamp, time_point>
 		, enable_if_eq<Tag, tag::rate, double>
 		, enable_if_eq<Tag, tag::entropy, double>
+		, enable_if_eq<Tag, tag::moving_min, value_type>
+		, enable_if_eq<Tag, tag::moving_max, value_type>
 	{};
 
 	// statistics is enabled from configuration
 	// but could also be computed due to data dependency
 	bool enabled(const tag::type& t) const HANDYSTATS_NOEXCEPT;
-	bool computed(const tag::type& t) const HANDYSTATS_NOEXCEPT;
+	bool computed(const tag::type& t) const HANDYSTATS_NOEXCEPT {
+		return m_computed & t;
+	}
 
 	tag::type tags() const HANDYSTATS_NOEXCEPT;
 
@@ -106,6 +135,27 @@ public:
 	void update(const value_type& value, const time_point& timestamp = clock::now());
 	void update_time(const time_point& timestamp = clock::now());
 
+	// Moving statistics over one of config::statistics::moving_intervals
+	struct moving_window_data {
+		duration interval;
+		double moving_count;
+		double moving_sum;
+		double moving_avg;
+		value_type moving_min;
+		value_type moving_max;
+		double rate;
+	};
+	// Windows of configured moving intervals (in configuration order) as of the current timestamp,
+	// each is summed over its own ring of window buckets
+	std::vector<moving_window_data> moving_windows() const;
+
+	// Adds data of other statistics (of the same configuration) as if it was passed to this one:
+	// * value is taken from statistics with the latest data, min, max, sum and count are combined
+	// * moving statistics and histograms are brought to the latest timestamp and added,
+	//   merged decayed data then decays since the latest data timestamp
+	// * window buckets and histograms' bins are merged by their sub-intervals and centers
+	void merge(const statistics& other);
+
 	// Depricated iface, use get<tag>
 	value_type value() const;
 	value_type min() const;
@@ -155,6 +205,16 @@ private:
 	// configuration (internal form)
 	config::statistics m_config;
 
+	// Computed tags are resolved from configuration once, on construction
+	tag::type m_computed;
+	bool resolve_computed(const tag::type& t) const HANDYSTATS_NOEXCEPT;
+
+	// Update kernel is chosen by computed tags on construction,
+	// common plans have kernels specialized at compile time, the rest share generic kernel (empty plan)
+	template <tag::type Plan>
+	void update_kernel(const value_type& value, const time_point& timestamp);
+	void (statistics::*m_update_kernel)(const value_type& value, const time_point& timestamp);
+
 	template <tag::type Tag>
 	typename result_type<Tag>::type get_impl() const;
 
@@ -165,24 +225,144 @@ private:
 	size_t m_count;
 	value_type m_moving_count;
 	value_type m_moving_sum;
-	histogram_type m_histogram;
 	time_point m_timestamp;
 	value_type m_rate;
 
 	time_point m_data_timestamp;
+	// rate, moving_count and moving_sum are stored as of m_interval_timestamp
+	// and are shifted to m_timestamp on read, so that update_time() doesn't touch them
+	time_point m_interval_timestamp;
 
-	// applicable for moving_sum, moving_count
-	double shift_interval_data(
-			const double& data, const time_point& data_timestamp,
+	// Linear decay of moving interval data from one time to another,
+	// computed once for all data with the same timestamps
+	struct interval_shift {
+		bool shifted;
+		double stale_interval;
+		double moving_interval;
+
+		double apply(const double& data) const {
+			if (!shifted) return data;
+			if (stale_interval <= 0) return 0;
+			return data * stale_interval / moving_interval;
+		}
+
+		double factor() const {
+			return apply(1.0);
+		}
+	};
+
+	// Shift of data last updated at data_timestamp from its value at from_timestamp to timestamp.
+	// Shifts compose, so a single shift equals the sequence of intermediate ones.
+	interval_shift shift_interval(
+			const time_point& data_timestamp,
+			const time_point& from_timestamp,
+			const time_point& timestamp
+		) const;
+	// rate, moving_count and moving_sum shift to m_timestamp
+	interval_shift current_interval_shift() const;
+	// applicable for rate, moving_sum, moving_count, log-linear histogram and sketch
+	void update_interval_data(
+			const value_type& rate_delta, const value_type& value,
 			const time_point& timestamp
-		);
-	double update_interval_data(
-			const double& data, const time_point& data_timestamp,
-			const value_type& value, const time_point& timestamp
 		);
 
-	void shift_histogram(const time_point& timestamp);
+	// Sub-interval of moving interval (window bucket), bucket's index is timestamp / bucket width.
+	struct window_bucket {
+		int64_t index;
+		double count;
+		value_type sum;
+		value_type rate;
+		value_type min;
+		value_type max;
+	};
+	// Ring of moving_buckets buckets of interval / moving_buckets width each.
+	// Window of moving interval (in windowed mode, for moving min and max) and windows of moving intervals
+	// have rings of their own, so longer windows are kept in coarser buckets.
+	struct window_ring {
+		duration interval;
+		// in nanoseconds
+		int64_t bucket_width;
+		std::vector<window_bucket> buckets;
+	};
+	std::vector<window_ring> m_windows;
+	// ring of moving interval's window, m_windows.size() if moving interval isn't windowed
+	size_t m_moving_window;
+	// rings of moving intervals' windows (in configuration order)
+	std::vector<size_t> m_interval_windows;
+
+	bool windowed() const HANDYSTATS_NOEXCEPT;
+	// moving interval's statistics are taken from window
+	bool moving_interval_windowed() const HANDYSTATS_NOEXCEPT;
+	bool window_computed() const HANDYSTATS_NOEXCEPT;
+	// index of ring of interval's window, ring is added if there is no such one yet
+	size_t window_ring_index(const duration& interval);
+	int64_t window_index(const time_point& timestamp, const int64_t& bucket_width) const;
+	void update_window(const value_type& rate_delta, const value_type& value, const time_point& timestamp);
+	// sum of the ring's buckets as of m_timestamp
+	window_bucket current_window(const window_ring& ring) const;
+	// window covers the current partial sub-interval and the preceding full ones, in nanoseconds
+	int64_t current_window_length(const window_ring& ring) const;
+	// rate over the ring's window brought to the full interval
+	double window_rate(const window_ring& ring, const window_bucket& window) const;
+	// rate over interval in rate units
+	double rate_per_unit(const double& rate, const duration& interval) const;
+
+	// Histogram bins are kept ordered by center, bins with equal centers are ordered by creation.
+	// Bin's count is decayed lazily: count is stored as of count_timestamp
+	// and is shifted to the requested time on read (see bin_count).
+	struct bin_key {
+		value_type center;
+		uint64_t seq;
+
+		bool operator< (const bin_key& other) const {
+			return center < other.center || (center == other.center && seq < other.seq);
+		}
+	};
+	struct bin_data {
+		double count;
+		time_point timestamp;
+		time_point count_timestamp;
+	};
+	typedef std::map<bin_key, bin_data> bins_type;
+
+	// Distance between adjacent bins' centers, the closest pair is merged first (leftmost of equal ones).
+	// Gaps are kept in ordered set as arbitrary gaps are removed on insertion and merge.
+	struct gap_key {
+		value_type gap;
+		bin_key left;
+
+		bool operator< (const gap_key& other) const {
+			return gap < other.gap || (gap == other.gap && left < other.left);
+		}
+	};
+	typedef std::set<gap_key> gaps_type;
+
+	bins_type m_bins;
+	gaps_type m_gaps;
+	uint64_t m_bins_seq;
+
+	double bin_count(const bin_data& bin, const time_point& timestamp) const;
+	void insert_gap(const bins_type::const_iterator& left, const bins_type::const_iterator& right);
+	void erase_gap(const bins_type::const_iterator& left, const bins_type::const_iterator& right);
+	void merge_closest_bins(const time_point& timestamp);
 	void update_histogram(const value_type& value, const time_point& timestamp);
+	// bins over histogram_bins are merged as of counts_timestamp
+	void insert_bin(const value_type& center, const bin_data& bin, const time_point& counts_timestamp);
+
+	// Log-linear histogram is decayed as a whole as moving_count,
+	// its counts are stored as of m_interval_timestamp
+	log_linear_histogram m_log_linear_histogram;
+
+	bool log_linear() const HANDYSTATS_NOEXCEPT;
+	// log-linear histogram shifted to m_timestamp
+	log_linear_histogram current_log_linear_histogram() const;
+
+	// Quantile sketch is decayed as log-linear histogram
+	quantile_sketch m_quantile_sketch;
+
+	bool sketch() const HANDYSTATS_NOEXCEPT;
+	// sketch shifted to m_timestamp
+	quantile_sketch current_sketch() const;
 };
 
 } // namespace handystats
@@ -0,0 +1,86 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_WEIGHTED_BUCKETS_HPP_
+#define HANDYSTATS_WEIGHTED_BUCKETS_HPP_
+
+#include <cstddef>
+
+namespace handystats {
+
+// Values' range of a bucket and its count
+struct value_bucket {
+	double lower;
+	double upper;
+	double count;
+};
+
+/*
+ * Buckets of positive and negative values' magnitudes with zero bucket in between
+ * shared by log_linear_histogram and quantile_sketch.
+ * Counts are stored multiplied by weight, so that scale() doesn't touch buckets
+ * until weight reaches the limit and buckets are renormalized.
+ *
+ * Store keeps stored counts of magnitude buckets and provides
+ * clear(), total() (sum of stored counts) and divide(divisor).
+ */
+template <typename Store>
+struct weighted_buckets {
+	Store positive;
+	Store negative;
+	double zero;
+	double weight;
+
+	weighted_buckets()
+		: positive()
+		, negative()
+		, zero(0)
+		, weight(1.0)
+	{}
+
+	void reset() {
+		positive.clear();
+		negative.clear();
+		zero = 0;
+		weight = 1.0;
+	}
+
+	// Count as it's stored in the buckets
+	double stored(const double& count) const {
+		return count * weight;
+	}
+
+	// Stored count of other's bucket as it's stored in the buckets
+	double stored(const double& other_count, const weighted_buckets& other) const {
+		return other_count / other.weight * weight;
+	}
+
+	// Multiplies all counts by factor, factor <= 0 clears the buckets
+	void scale(const double& factor) {
+		if (factor <= 0) {
+			reset();
+			return;
+		}
+
+		weight /= factor;
+
+		if (weight > 1E100) {
+			positive.divide(weight);
+			negative.divide(weight);
+			zero /= weight;
+			weight = 1.0;
+		}
+	}
+
+	// Sum of stored counts
+	double total() const {
+		return zero + positive.total() + negative.total();
+	}
+
+	double count() const {
+		return total() / weight;
+	}
+};
+
+} // namespace handystats
+
+#endif // HANDYSTATS_WEIGHTED_BUCKETS_HPP_
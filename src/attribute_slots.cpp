@@ -0,0 +1,73 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <handystats/atomic.hpp>
+
+#include "events/event_message_impl.hpp"
+#include "handle_slots_impl.hpp"
+#include "self_stats_impl.hpp"
+
+#include "attribute_slots_impl.hpp"
+
+namespace handystats { namespace attribute_slots {
+
+static handle_slots::slot_table<metrics::attribute::value_type> slots;
+
+static std::atomic<bool> enabled(false);
+
+bool set(
+		const metric_handle& handle,
+		const metrics::attribute::value_type& value,
+		const chrono::time_point& timestamp
+	)
+{
+	if (!enabled.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	auto* s = slots.find(handle.id);
+	if (!s) {
+		return false;
+	}
+
+	// attribute event types follow value indices
+	self_stats::produced(events::event_destination_type::ATTRIBUTE, char(value.which()));
+
+	handle_slots::lock(*s);
+	if (!s->assigned || !(s->value == value)) {
+		// string value reuses slot's string capacity
+		s->value = value;
+		s->assigned = true;
+	}
+	// unchanged value is applied again, as queued set of the attribute could have changed it meanwhile
+	s->hash = handle.hash;
+	s->timestamp = timestamp;
+	s->dirty.store(true, std::memory_order_relaxed);
+	handle_slots::unlock(*s);
+
+	return true;
+}
+
+void collect(const size_t& shard, slot_handler handler) {
+	slots.collect(shard,
+			[&shard, handler] (
+				const metric_handle::id_type& id,
+				const metrics::attribute::value_type& value,
+				const chrono::time_point& timestamp
+			)
+			{
+				handler(shard, id, value, timestamp);
+			}
+		);
+}
+
+void initialize() {
+	enabled.store(true, std::memory_order_release);
+}
+
+void finalize() {
+	enabled.store(false, std::memory_order_release);
+
+	slots.reset();
+}
+
+}} // namespace handystats::attribute_slots
@@ -0,0 +1,43 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_ATTRIBUTE_SLOTS_IMPL_HPP_
+#define HANDYSTATS_ATTRIBUTE_SLOTS_IMPL_HPP_
+
+#include <handystats/chrono.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metrics/attribute.hpp>
+
+/*
+ * Attribute sets through metric handles.
+ * Attribute holds only the last value, so its sets bypass the message queue
+ * and are stored into per-handle slot, which is sampled by the processor on dump.
+ * Value the slot already holds is not copied again.
+ * Slot's set and queued sets of the same attribute (by name or before initialization) are ordered
+ * by timestamps when applied: the latest set wins.
+ */
+namespace handystats { namespace attribute_slots {
+
+typedef void (*slot_handler)(
+		const size_t& shard,
+		const metric_handle::id_type& id,
+		const metrics::attribute::value_type& value,
+		const chrono::time_point& timestamp
+	);
+
+// Producer side: stores the value into the attribute's slot,
+// returns false if the value should be sent through the message queue instead
+bool set(
+		const metric_handle& handle,
+		const metrics::attribute::value_type& value,
+		const chrono::time_point& timestamp
+	);
+
+// Processor side: calls handler for each attribute of the shard changed since the previous collect
+void collect(const size_t& shard, slot_handler handler);
+
+void initialize();
+void finalize();
+
+}} // namespace handystats::attribute_slots
+
+#endif // HANDYSTATS_ATTRIBUTE_SLOTS_IMPL_HPP_
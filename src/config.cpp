@@ -23,6 +23,7 @@ namespace metrics {
 }
 
 metrics_dump metrics_dump_opts;
+message_queue message_queue_opts;
 core core_opts;
 
 static void reset() {
@@ -33,6 +34,7 @@ static void reset() {
 	metrics::timer_opts = metrics::timer();
 
 	metrics_dump_opts = metrics_dump();
+	message_queue_opts = message_queue();
 	core_opts = core();
 }
 
@@ -95,6 +97,11 @@ bool config_json(const rapidjson::Value& config) {
 		config::metrics_dump_opts.configure(metrics_dump_config);
 	}
 
+	if (config.HasMember("message-queue")) {
+		const rapidjson::Value& message_queue_config = config["message-queue"];
+		config::message_queue_opts.configure(message_queue_config);
+	}
+
 	if (config.HasMember("core")) {
 		const rapidjson::Value& core_config = config["core"];
 		config::core_opts.configure(core_config);
@@ -1,9 +1,23 @@
+#include <cstring>
+#include <sched.h>
+
 #include "config/core_impl.hpp"
 
 namespace handystats { namespace config {
 
+const int core::POLICY_UNCHANGED;
+
 core::core()
 	: enable(true)
+	, mode(QUEUED)
+	, processor_threads(1)
+	, idle_spins(1000)
+	, idle_yields(10)
+	, idle_park_timeout(100, chrono::time_unit::MSEC)
+	, processor_affinity()
+	, processor_policy(POLICY_UNCHANGED)
+	, processor_nice_enabled(false)
+	, processor_nice(0)
 {}
 
 void core::configure(const rapidjson::Value& config) {
@@ -17,6 +31,81 @@ void core::configure(const rapidjson::Value& config) {
 			this->enable = enable.GetBool();
 		}
 	}
+
+	if (config.HasMember("mode")) {
+		const rapidjson::Value& mode = config["mode"];
+		if (mode.IsString()) {
+			if (strcmp(mode.GetString(), "queued") == 0) {
+				this->mode = QUEUED;
+			}
+			else if (strcmp(mode.GetString(), "inline") == 0) {
+				this->mode = INLINE;
+			}
+		}
+	}
+
+	if (config.HasMember("processor-threads")) {
+		const rapidjson::Value& processor_threads = config["processor-threads"];
+		if (processor_threads.IsUint64() && processor_threads.GetUint64() > 0) {
+			this->processor_threads = processor_threads.GetUint64();
+		}
+	}
+
+	if (config.HasMember("idle-spins")) {
+		const rapidjson::Value& idle_spins = config["idle-spins"];
+		if (idle_spins.IsUint64()) {
+			this->idle_spins = idle_spins.GetUint64();
+		}
+	}
+
+	if (config.HasMember("idle-yields")) {
+		const rapidjson::Value& idle_yields = config["idle-yields"];
+		if (idle_yields.IsUint64()) {
+			this->idle_yields = idle_yields.GetUint64();
+		}
+	}
+
+	if (config.HasMember("idle-park-timeout")) {
+		const rapidjson::Value& idle_park_timeout = config["idle-park-timeout"];
+		if (idle_park_timeout.IsUint64() && idle_park_timeout.GetUint64() > 0) {
+			this->idle_park_timeout = chrono::duration(idle_park_timeout.GetUint64(), chrono::time_unit::MSEC);
+		}
+	}
+
+	if (config.HasMember("processor-affinity")) {
+		const rapidjson::Value& processor_affinity = config["processor-affinity"];
+		if (processor_affinity.IsArray()) {
+			this->processor_affinity.clear();
+			for (rapidjson::SizeType index = 0; index < processor_affinity.Size(); ++index) {
+				if (processor_affinity[index].IsUint() && processor_affinity[index].GetUint() < CPU_SETSIZE) {
+					this->processor_affinity.push_back(processor_affinity[index].GetUint());
+				}
+			}
+		}
+	}
+
+	if (config.HasMember("processor-policy")) {
+		const rapidjson::Value& processor_policy = config["processor-policy"];
+		if (processor_policy.IsString()) {
+			if (strcmp(processor_policy.GetString(), "other") == 0) {
+				this->processor_policy = SCHED_OTHER;
+			}
+			else if (strcmp(processor_policy.GetString(), "batch") == 0) {
+				this->processor_policy = SCHED_BATCH;
+			}
+			else if (strcmp(processor_policy.GetString(), "idle") == 0) {
+				this->processor_policy = SCHED_IDLE;
+			}
+		}
+	}
+
+	if (config.HasMember("processor-nice")) {
+		const rapidjson::Value& processor_nice = config["processor-nice"];
+		if (processor_nice.IsInt() && processor_nice.GetInt() >= -20 && processor_nice.GetInt() <= 19) {
+			this->processor_nice_enabled = true;
+			this->processor_nice = processor_nice.GetInt();
+		}
+	}
 }
 
 }} // namespace handystats::config
@@ -3,6 +3,9 @@
 #ifndef HANDYSTATS_CONFIG_CORE_IMPL_HPP_
 #define HANDYSTATS_CONFIG_CORE_IMPL_HPP_
 
+#include <vector>
+
+#include <handystats/chrono.hpp>
 #include <handystats/rapidjson/document.h>
 
 namespace handystats { namespace config {
@@ -10,6 +13,37 @@ namespace handystats { namespace config {
 struct core {
 	bool enable;
 
+	enum mode_type {
+		// events are passed to processor threads through the message queue
+		QUEUED,
+		// events are applied to metrics by measuring points right away under the metrics shard's lock,
+		// background thread only makes metrics dumps
+		INLINE
+	};
+	mode_type mode;
+
+	// Number of processor threads, each processes its own shard of metrics (partitioned by name hash).
+	// Sharding is supported with global message queue topology only.
+	// In inline mode number of metrics shards, each with its own lock.
+	size_t processor_threads;
+
+	// Processor's idle strategy:
+	// poll the queue idle_spins times, then yield idle_yields times,
+	// then park until producers' wakeup, next metrics dump or idle_park_timeout expiration
+	uint64_t idle_spins;
+	uint64_t idle_yields;
+	chrono::duration idle_park_timeout;
+
+	// Processor thread's CPU affinity, empty -- not changed
+	std::vector<int> processor_affinity;
+
+	static const int POLICY_UNCHANGED = -1;
+	// Processor thread's scheduling policy (SCHED_OTHER, SCHED_BATCH or SCHED_IDLE)
+	int processor_policy;
+
+	bool processor_nice_enabled;
+	int processor_nice;
+
 	core();
 	void configure(const rapidjson::Value& config);
 };
@@ -0,0 +1,117 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <cstring>
+
+#include "config/message_queue_impl.hpp"
+
+namespace handystats { namespace config {
+
+message_queue::message_queue()
+	: topology(GLOBAL)
+	, ring_capacity(4096)
+	, log_capacity(1 << 20)
+	, batch_size(256)
+	, capacity(0)
+	, overload_policy(BLOCK)
+	, block_timeout()
+	, sample_every(10)
+	, producer_buffer_size(0)
+	, producer_buffer_age(10, chrono::time_unit::MSEC)
+{}
+
+void message_queue::configure(const rapidjson::Value& config) {
+	if (!config.IsObject()) {
+		return;
+	}
+
+	if (config.HasMember("topology")) {
+		const rapidjson::Value& topology = config["topology"];
+		if (topology.IsString()) {
+			if (strcmp(topology.GetString(), "global") == 0) {
+				this->topology = GLOBAL;
+			}
+			else if (strcmp(topology.GetString(), "per-thread") == 0) {
+				this->topology = PER_THREAD;
+			}
+			else if (strcmp(topology.GetString(), "packed") == 0) {
+				this->topology = PACKED;
+			}
+			else if (strcmp(topology.GetString(), "per-cpu") == 0) {
+				this->topology = PER_CPU;
+			}
+		}
+	}
+
+	if (config.HasMember("ring-capacity")) {
+		const rapidjson::Value& ring_capacity = config["ring-capacity"];
+		if (ring_capacity.IsUint64() && ring_capacity.GetUint64() > 0) {
+			this->ring_capacity = ring_capacity.GetUint64();
+		}
+	}
+
+	if (config.HasMember("log-capacity")) {
+		const rapidjson::Value& log_capacity = config["log-capacity"];
+		if (log_capacity.IsUint64() && log_capacity.GetUint64() > 0) {
+			this->log_capacity = log_capacity.GetUint64();
+		}
+	}
+
+	if (config.HasMember("batch-size")) {
+		const rapidjson::Value& batch_size = config["batch-size"];
+		if (batch_size.IsUint64() && batch_size.GetUint64() > 0) {
+			this->batch_size = batch_size.GetUint64();
+		}
+	}
+
+	if (config.HasMember("capacity")) {
+		const rapidjson::Value& capacity = config["capacity"];
+		if (capacity.IsUint64()) {
+			this->capacity = capacity.GetUint64();
+		}
+	}
+
+	if (config.HasMember("overload-policy")) {
+		const rapidjson::Value& overload_policy = config["overload-policy"];
+		if (overload_policy.IsString()) {
+			if (strcmp(overload_policy.GetString(), "block") == 0) {
+				this->overload_policy = BLOCK;
+			}
+			else if (strcmp(overload_policy.GetString(), "drop-newest") == 0) {
+				this->overload_policy = DROP_NEWEST;
+			}
+			else if (strcmp(overload_policy.GetString(), "sample") == 0) {
+				this->overload_policy = SAMPLE;
+			}
+		}
+	}
+
+	if (config.HasMember("block-timeout")) {
+		const rapidjson::Value& block_timeout = config["block-timeout"];
+		if (block_timeout.IsUint64()) {
+			this->block_timeout = chrono::duration(block_timeout.GetUint64(), chrono::time_unit::MSEC);
+		}
+	}
+
+	if (config.HasMember("sample-every")) {
+		const rapidjson::Value& sample_every = config["sample-every"];
+		if (sample_every.IsUint64() && sample_every.GetUint64() > 0) {
+			this->sample_every = sample_every.GetUint64();
+		}
+	}
+
+	if (config.HasMember("producer-buffer")) {
+		const rapidjson::Value& producer_buffer = config["producer-buffer"];
+		if (producer_buffer.IsUint64()) {
+			this->producer_buffer_size = producer_buffer.GetUint64();
+		}
+	}
+
+	if (config.HasMember("producer-buffer-age")) {
+		const rapidjson::Value& producer_buffer_age = config["producer-buffer-age"];
+		if (producer_buffer_age.IsUint64()) {
+			this->producer_buffer_age = chrono::duration(producer_buffer_age.GetUint64(), chrono::time_unit::MSEC);
+		}
+	}
+}
+
+}} // namespace handystats::config
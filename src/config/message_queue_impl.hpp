@@ -0,0 +1,65 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_CONFIG_MESSAGE_QUEUE_IMPL_HPP_
+#define HANDYSTATS_CONFIG_MESSAGE_QUEUE_IMPL_HPP_
+
+#include <cstddef>
+
+#include <handystats/rapidjson/document.h>
+
+#include <handystats/chrono.hpp>
+
+namespace handystats { namespace config {
+
+struct message_queue {
+	enum topology_type {
+		// single intrusive MPSC queue shared by all producers
+		GLOBAL = 0,
+		// bounded SPSC ring per producer thread
+		PER_THREAD,
+		// per producer thread log of packed records (see message_log_impl.hpp)
+		PACKED,
+		// MPSC queue per CPU, picked by the CPU the producer runs on
+		PER_CPU
+	};
+
+	enum overload_policy_type {
+		// producer waits for the processor to make room (at most block_timeout)
+		BLOCK = 0,
+		// new messages are dropped while queue is full
+		DROP_NEWEST,
+		// only every sample_every-th message is accepted while queue is more than half full,
+		// new messages are dropped while queue is full
+		SAMPLE
+	};
+
+	topology_type topology;
+	size_t ring_capacity;
+	// per-thread log size in bytes for packed topology
+	size_t log_capacity;
+	// maximum number of messages drained and processed by the processor at once
+	size_t batch_size;
+
+	// maximum number of messages in the global queue (in each per-cpu queue), 0 means unbounded
+	// (per-thread rings are always bounded by ring_capacity).
+	// It's a soft bound: size is checked before the push, so concurrent producers
+	// could exceed it by at most one message each.
+	size_t capacity;
+	overload_policy_type overload_policy;
+	// zero block timeout means wait without limit
+	chrono::duration block_timeout;
+	size_t sample_every;
+
+	// number of messages collected by producer thread before publishing them
+	// to the global queue at once, 0 or 1 disables producer buffering
+	size_t producer_buffer_size;
+	// buffered messages are published once the oldest of them is that old (checked on push)
+	chrono::duration producer_buffer_age;
+
+	message_queue();
+	void configure(const rapidjson::Value& config);
+};
+
+}} // namespace handystats::config
+
+#endif // HANDYSTATS_CONFIG_MESSAGE_QUEUE_IMPL_HPP_
@@ -4,6 +4,7 @@ namespace handystats { namespace config {
 
 metrics_dump::metrics_dump()
 	: interval(750, chrono::time_unit::MSEC)
+	, self_stats(true)
 {}
 
 void metrics_dump::configure(const rapidjson::Value& config) {
@@ -17,6 +18,13 @@ void metrics_dump::configure(const rapidjson::Value& config) {
 			this->interval = chrono::duration(interval.GetUint64(), chrono::time_unit::MSEC);
 		}
 	}
+
+	if (config.HasMember("self-stats")) {
+		const rapidjson::Value& self_stats = config["self-stats"];
+		if (self_stats.IsBool()) {
+			this->self_stats = self_stats.GetBool();
+		}
+	}
 }
 
 }} // namespace handystats::config
@@ -10,6 +10,8 @@ namespace handystats { namespace config {
 
 struct metrics_dump {
 	chrono::duration interval;
+	// handystats.self.* event path statistics are counted and dumped
+	bool self_stats;
 
 	metrics_dump();
 	void configure(const rapidjson::Value& config);
@@ -1,13 +1,22 @@
 // Copyright (c) 2014 Yandex LLC. All rights reserved.
 
+#include <algorithm>
+
 #include <handystats/statistics.hpp>
+#include <handystats/log_linear_histogram.hpp>
 #include <handystats/config/statistics.hpp>
 
 namespace handystats { namespace config {
 
 statistics::statistics()
 	: moving_interval(1, chrono::time_unit::SEC)
+	, moving_window(DECAY)
+	, moving_buckets(10)
+	, histogram_type(ADAPTIVE)
 	, histogram_bins(30)
+	, histogram_significant_digits(2)
+	, sketch_relative_accuracy(0.01)
+	, sketch_max_buckets(2048)
 	, tags(
 		handystats::statistics::tag::value |
 		handystats::statistics::tag::min | handystats::statistics::tag::max |
@@ -16,6 +25,7 @@ statistics::statistics()
 		handystats::statistics::tag::timestamp
 	)
 	, rate_unit(chrono::time_unit::SEC)
+	, quantiles({0.25, 0.5, 0.75, 0.9, 0.95})
 {}
 
 void statistics::configure(const rapidjson::Value& config) {
@@ -30,6 +40,39 @@ void statistics::configure(const rapidjson::Value& config) {
 		}
 	}
 
+	if (config.HasMember("moving-window")) {
+		const rapidjson::Value& moving_window = config["moving-window"];
+		if (moving_window.IsString()) {
+			if (strcmp(moving_window.GetString(), "decay") == 0) {
+				this->moving_window = DECAY;
+			}
+			else if (strcmp(moving_window.GetString(), "buckets") == 0) {
+				this->moving_window = BUCKETS;
+			}
+		}
+	}
+
+	if (config.HasMember("moving-buckets")) {
+		const rapidjson::Value& moving_buckets = config["moving-buckets"];
+		if (moving_buckets.IsUint64() && moving_buckets.GetUint64() > 0) {
+			this->moving_buckets = moving_buckets.GetUint64();
+		}
+	}
+
+	if (config.HasMember("moving-intervals")) {
+		const rapidjson::Value& moving_intervals = config["moving-intervals"];
+
+		if (moving_intervals.IsArray()) {
+			this->moving_intervals.clear();
+			for (size_t index = 0; index < moving_intervals.Size(); ++index) {
+				const rapidjson::Value& moving_interval = moving_intervals[index];
+				if (moving_interval.IsUint64() && moving_interval.GetUint64() > 0) {
+					this->moving_intervals.push_back(chrono::duration(moving_interval.GetUint64(), chrono::time_unit::MSEC));
+				}
+			}
+		}
+	}
+
 	if (config.HasMember("histogram-bins")) {
 		const rapidjson::Value& histogram_bins = config["histogram-bins"];
 		if (histogram_bins.IsUint64() && histogram_bins.GetUint64() > 0) {
@@ -37,6 +80,46 @@ void statistics::configure(const rapidjson::Value& config) {
 		}
 	}
 
+	if (config.HasMember("histogram-type")) {
+		const rapidjson::Value& histogram_type = config["histogram-type"];
+		if (histogram_type.IsString()) {
+			if (strcmp(histogram_type.GetString(), "adaptive") == 0) {
+				this->histogram_type = ADAPTIVE;
+			}
+			else if (strcmp(histogram_type.GetString(), "log-linear") == 0) {
+				this->histogram_type = LOG_LINEAR;
+			}
+			else if (strcmp(histogram_type.GetString(), "sketch") == 0) {
+				this->histogram_type = SKETCH;
+			}
+		}
+	}
+
+	if (config.HasMember("sketch-relative-accuracy")) {
+		const rapidjson::Value& relative_accuracy = config["sketch-relative-accuracy"];
+		if (relative_accuracy.IsNumber() && relative_accuracy.GetDouble() > 0 && relative_accuracy.GetDouble() < 1) {
+			this->sketch_relative_accuracy = relative_accuracy.GetDouble();
+		}
+	}
+
+	if (config.HasMember("sketch-max-buckets")) {
+		const rapidjson::Value& max_buckets = config["sketch-max-buckets"];
+		if (max_buckets.IsUint64() && max_buckets.GetUint64() > 0) {
+			this->sketch_max_buckets = max_buckets.GetUint64();
+		}
+	}
+
+	if (config.HasMember("histogram-significant-digits")) {
+		const rapidjson::Value& significant_digits = config["histogram-significant-digits"];
+		if (significant_digits.IsUint64() &&
+				significant_digits.GetUint64() >= log_linear_histogram::MIN_SIGNIFICANT_DIGITS &&
+				significant_digits.GetUint64() <= log_linear_histogram::MAX_SIGNIFICANT_DIGITS
+			)
+		{
+			this->histogram_significant_digits = significant_digits.GetUint64();
+		}
+	}
+
 	if (config.HasMember("tags")) {
 		const rapidjson::Value& tags = config["tags"];
 
@@ -51,6 +134,27 @@ void statistics::configure(const rapidjson::Value& config) {
 		}
 	}
 
+	if (config.HasMember("quantiles")) {
+		const rapidjson::Value& quantiles = config["quantiles"];
+
+		if (quantiles.IsArray()) {
+			this->quantiles.clear();
+			for (size_t index = 0; index < quantiles.Size(); ++index) {
+				const rapidjson::Value& probability = quantiles[index];
+				if (probability.IsNumber() && probability.GetDouble() >= 0 && probability.GetDouble() <= 1) {
+					this->quantiles.push_back(probability.GetDouble());
+				}
+			}
+
+			// each quantile is reported once, in ascending order
+			std::sort(this->quantiles.begin(), this->quantiles.end());
+			this->quantiles.erase(
+					std::unique(this->quantiles.begin(), this->quantiles.end()),
+					this->quantiles.end()
+				);
+		}
+	}
+
 	if (config.HasMember("rate-unit")) {
 		const rapidjson::Value& rate_unit = config["rate-unit"];
 
@@ -9,6 +9,7 @@
 #include <handystats/config/metrics/timer.hpp>
 
 #include "config/metrics_dump_impl.hpp"
+#include "config/message_queue_impl.hpp"
 #include "config/core_impl.hpp"
 
 namespace handystats { namespace config {
@@ -22,6 +23,7 @@ namespace metrics {
 }
 
 extern metrics_dump metrics_dump_opts;
+extern message_queue message_queue_opts;
 extern core core_opts;
 
 void initialize();
@@ -3,7 +3,13 @@
 #include <chrono>
 #include <algorithm>
 #include <thread>
+#include <vector>
 #include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 #include <handystats/atomic.hpp>
 
 #include <handystats/chrono.hpp>
@@ -11,8 +17,12 @@
 #include <handystats/core.h>
 
 #include "events/event_message_impl.hpp"
+#include "events/event_message_pool_impl.hpp"
 #include "message_queue_impl.hpp"
 #include "internal_impl.hpp"
+#include "gauge_slots_impl.hpp"
+#include "attribute_slots_impl.hpp"
+#include "self_stats_impl.hpp"
 #include "metrics_dump_impl.hpp"
 #include "config_impl.hpp"
 
@@ -28,40 +38,166 @@ bool is_enabled() {
 }
 
 
-chrono::time_point last_message_timestamp;
-std::thread processor_thread;
+std::vector<std::thread> processor_threads;
 
-static void process_message_queue() {
-	auto* message = message_queue::pop();
+static bool process_message_queue(
+		internal::shard& metrics_shard,
+		std::vector<events::event_message*>& message_batch,
+		chrono::time_point& last_message_timestamp
+	)
+{
+	const size_t count = message_queue::pop(metrics_shard.index, message_batch.data(), message_batch.size());
 
-	chrono::time_point timestamp;
+	if (count == 0) {
+		return false;
+	}
+
+	for (size_t index = 0; index < count; ++index) {
+		last_message_timestamp = std::max(last_message_timestamp, message_batch[index]->timestamp);
+	}
+
+	internal::process_event_messages(metrics_shard, message_batch.data(), count);
+
+	message_queue::release(message_batch.data(), count);
+
+	return true;
+}
+
+static void configure_processor_thread() {
+	if (!config::core_opts.processor_affinity.empty()) {
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		for (auto cpu_iter = config::core_opts.processor_affinity.cbegin(); cpu_iter != config::core_opts.processor_affinity.cend(); ++cpu_iter) {
+			CPU_SET(*cpu_iter, &cpu_set);
+		}
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+	}
+
+	if (config::core_opts.processor_policy != config::core::POLICY_UNCHANGED) {
+		struct sched_param param;
+		memset(&param, 0, sizeof(param));
+		pthread_setschedparam(pthread_self(), config::core_opts.processor_policy, &param);
+	}
+
+	if (config::core_opts.processor_nice_enabled) {
+		// on Linux nice value is per-thread
+		setpriority(PRIO_PROCESS, syscall(SYS_gettid), config::core_opts.processor_nice);
+	}
+}
 
-	if (message) {
-		last_message_timestamp = std::max(last_message_timestamp, message->timestamp);
-		internal::process_event_message(*message);
+// Idle strategy: spin, then yield, then park until producers' wakeup or next metrics dump
+// (or until producers' buffered messages get stale)
+static void idle(const size_t& shard_index, const uint64_t& idle_loops, const bool& buffered) {
+	if (idle_loops < config::core_opts.idle_spins) {
+		return;
+	}
+
+	if (idle_loops < config::core_opts.idle_spins + config::core_opts.idle_yields) {
+		std::this_thread::yield();
+		return;
 	}
 
-	events::delete_event_message(message);
+	chrono::duration park_timeout = config::core_opts.idle_park_timeout;
+
+	if (buffered && config::message_queue_opts.producer_buffer_age < park_timeout) {
+		park_timeout = config::message_queue_opts.producer_buffer_age;
+	}
+
+	// dumps are made by the first shard's processor, other processors are woken on snapshot request.
+	// Overdue dump is waiting for other shards' snapshots, their processors wake the first one.
+	if (shard_index == 0 && config::metrics_dump_opts.interval.count() > 0) {
+		const chrono::duration until_dump =
+			metrics_dump::dump_timestamp + config::metrics_dump_opts.interval - chrono::tsc_clock::now();
+		if (until_dump.count() > 0 && until_dump < park_timeout) {
+			park_timeout = until_dump;
+		}
+	}
+
+	message_queue::wait(shard_index, park_timeout);
 }
 
-static void run_processor() {
+static void run_processor(const size_t shard_index) {
 	char thread_name[16];
 	memset(thread_name, 0, sizeof(thread_name));
 
-	sprintf(thread_name, "handystats");
+	if (shard_index == 0) {
+		sprintf(thread_name, "handystats");
+	}
+	else {
+		snprintf(thread_name, sizeof(thread_name), "handystats-%u", unsigned(shard_index));
+	}
 
 	prctl(PR_SET_NAME, thread_name);
 
+	configure_processor_thread();
+
+	internal::shard& metrics_shard = *internal::shards[shard_index];
+	std::vector<events::event_message*> message_batch(config::message_queue_opts.batch_size, nullptr);
+	chrono::time_point last_message_timestamp;
+
+	uint64_t idle_loops = 0;
+
 	while (is_enabled()) {
-		if (!message_queue::empty()) {
-			process_message_queue();
+		const bool processed = process_message_queue(metrics_shard, message_batch, last_message_timestamp);
+
+		if (!processed) {
+			last_message_timestamp = std::max(last_message_timestamp, chrono::tsc_clock::now());
+		}
+
+		// producer buffers are used with a single shard only
+		bool buffered = false;
+		if (shard_index == 0) {
+			buffered = message_queue::flush_stale_buffers(chrono::tsc_clock::now());
+			metrics_dump::update(chrono::tsc_clock::now(), last_message_timestamp);
 		}
 		else {
-			last_message_timestamp = std::max(last_message_timestamp, chrono::tsc_clock::now());
-			std::this_thread::sleep_for(std::chrono::microseconds(10));
+			metrics_dump::update_snapshot(metrics_shard, last_message_timestamp);
+		}
+
+		if (processed) {
+			idle_loops = 0;
+		}
+		else {
+			idle(shard_index, idle_loops++, buffered);
+		}
+	}
+}
+
+// Inline mode: events are processed by producers, background thread only makes metrics dumps.
+// Shards are updated under their locks, other shards' snapshots are made right after dump request.
+static void run_dumper() {
+	prctl(PR_SET_NAME, "handystats");
+
+	configure_processor_thread();
+
+	while (is_enabled()) {
+		for (int step = 0; step < 2; ++step) {
+			// first step requests dump, snapshots are made, second step merges them
+			{
+				std::lock_guard<std::mutex> lock(internal::shards.front()->lock);
+				const auto current_time = chrono::tsc_clock::now();
+				metrics_dump::update(current_time, current_time);
+			}
+
+			for (size_t shard_index = 1; step == 0 && shard_index < internal::shards.size(); ++shard_index) {
+				internal::shard& metrics_shard = *internal::shards[shard_index];
+				std::lock_guard<std::mutex> lock(metrics_shard.lock);
+				metrics_dump::update_snapshot(metrics_shard, chrono::tsc_clock::now());
+			}
+		}
+
+		chrono::duration park_timeout = config::core_opts.idle_park_timeout;
+		if (config::metrics_dump_opts.interval.count() > 0) {
+			const chrono::duration until_dump =
+				metrics_dump::dump_timestamp + config::metrics_dump_opts.interval - chrono::tsc_clock::now();
+			if (until_dump < park_timeout) {
+				park_timeout = until_dump;
+			}
 		}
 
-		metrics_dump::update(chrono::tsc_clock::now(), last_message_timestamp);
+		if (park_timeout.count() > 0) {
+			message_queue::wait(0, park_timeout);
+		}
 	}
 }
 
@@ -71,9 +207,24 @@ void initialize() {
 		return;
 	}
 
+	// per-thread rings, logs and per-cpu queues have single consumer
+	size_t shards_count = config::core_opts.processor_threads;
+	if (config::message_queue_opts.topology != config::message_queue::GLOBAL &&
+			config::core_opts.mode != config::core::INLINE)
+	{
+		shards_count = 1;
+	}
+	if (shards_count > message_queue::MAX_SHARDS) {
+		shards_count = message_queue::MAX_SHARDS;
+	}
+
 	metrics_dump::initialize();
-	internal::initialize();
-	message_queue::initialize();
+	internal::initialize(shards_count);
+	message_queue::initialize(shards_count);
+	events::pool::initialize();
+	self_stats::initialize();
+	gauge_slots::initialize();
+	attribute_slots::initialize();
 
 	if (!config::core_opts.enable) {
 		return;
@@ -81,25 +232,42 @@ void initialize() {
 
 	enabled_flag.store(true, std::memory_order_release);
 
-	last_message_timestamp = chrono::time_point();
+	if (config::core_opts.mode == config::core::INLINE) {
+		processor_threads.push_back(std::thread(run_dumper));
+		return;
+	}
 
-	processor_thread = std::thread(run_processor);
+	for (size_t shard_index = 0; shard_index < shards_count; ++shard_index) {
+		processor_threads.push_back(std::thread(run_processor, shard_index));
+	}
 }
 
 void finalize() {
 	std::lock_guard<std::mutex> lock(operation_mutex);
 	enabled_flag.store(false, std::memory_order_release);
+	message_queue::notify();
 
-	if (processor_thread.joinable()) {
-		processor_thread.join();
+	for (auto thread_iter = processor_threads.begin(); thread_iter != processor_threads.end(); ++thread_iter) {
+		if (thread_iter->joinable()) {
+			thread_iter->join();
+		}
 	}
+	processor_threads.clear();
 
+	gauge_slots::finalize();
+	attribute_slots::finalize();
 	internal::finalize();
 	message_queue::finalize();
+	events::pool::finalize();
+	self_stats::finalize();
 	metrics_dump::finalize();
 	config::finalize();
 }
 
+void flush_thread() {
+	message_queue::flush_thread();
+}
+
 } // namespace handystats
 
 
@@ -113,4 +281,8 @@ void handystats_finalize() {
 	handystats::finalize();
 }
 
+void handystats_flush_thread() {
+	handystats::flush_thread();
+}
+
 } // extern "C"
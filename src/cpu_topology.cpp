@@ -0,0 +1,126 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "cpu_topology_impl.hpp"
+
+namespace {
+
+struct __topology {
+	size_t cpus_count;
+	std::vector<size_t> cpu_nodes;
+	std::vector<size_t> cpus_by_node;
+
+	__topology()
+		: cpus_count(1)
+		, cpu_nodes()
+		, cpus_by_node()
+	{
+		const long configured = sysconf(_SC_NPROCESSORS_CONF);
+		if (configured > 0) {
+			cpus_count = configured;
+		}
+
+		cpu_nodes.assign(cpus_count, 0);
+		read_nodes();
+
+		for (size_t cpu = 0; cpu < cpus_count; ++cpu) {
+			cpus_by_node.push_back(cpu);
+		}
+		std::stable_sort(cpus_by_node.begin(), cpus_by_node.end(),
+				[this] (const size_t& a, const size_t& b) {
+					return cpu_nodes[a] < cpu_nodes[b];
+				}
+			);
+	}
+
+	// parses /sys/devices/system/node/node<N>/cpulist, e.g. "0-3,8-11"
+	void read_nodes() {
+		DIR* nodes_dir = opendir("/sys/devices/system/node");
+		if (!nodes_dir) {
+			return;
+		}
+
+		while (struct dirent* entry = readdir(nodes_dir)) {
+			if (strncmp(entry->d_name, "node", 4) != 0 || !isdigit(entry->d_name[4])) {
+				continue;
+			}
+
+			const size_t node = strtoul(entry->d_name + 4, nullptr, 10);
+
+			char path[PATH_MAX];
+			const int path_length = snprintf(path, sizeof(path), "/sys/devices/system/node/%s/cpulist", entry->d_name);
+			if (path_length < 0 || size_t(path_length) >= sizeof(path)) {
+				continue;
+			}
+
+			FILE* cpulist = fopen(path, "r");
+			if (!cpulist) {
+				continue;
+			}
+
+			unsigned long first = 0;
+			unsigned long last = 0;
+			while (fscanf(cpulist, "%lu", &first) == 1) {
+				last = first;
+				int separator = fgetc(cpulist);
+				if (separator == '-') {
+					if (fscanf(cpulist, "%lu", &last) != 1) {
+						break;
+					}
+					separator = fgetc(cpulist);
+				}
+
+				for (unsigned long cpu = first; cpu <= last && cpu < cpus_count; ++cpu) {
+					cpu_nodes[cpu] = node;
+				}
+
+				if (separator != ',') {
+					break;
+				}
+			}
+
+			fclose(cpulist);
+		}
+
+		closedir(nodes_dir);
+	}
+};
+
+const __topology& topology() {
+	static const __topology instance;
+	return instance;
+}
+
+} // unnamed namespace
+
+
+namespace handystats { namespace cpu_topology {
+
+size_t cpus_count() {
+	return topology().cpus_count;
+}
+
+size_t node_of(const size_t& cpu) {
+	const __topology& t = topology();
+	return cpu < t.cpus_count ? t.cpu_nodes[cpu] : 0;
+}
+
+const std::vector<size_t>& cpus_by_node() {
+	return topology().cpus_by_node;
+}
+
+size_t current_cpu() {
+	const int cpu = sched_getcpu();
+	return cpu > 0 ? cpu : 0;
+}
+
+}} // namespace handystats::cpu_topology
@@ -0,0 +1,29 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_CPU_TOPOLOGY_IMPL_HPP_
+#define HANDYSTATS_CPU_TOPOLOGY_IMPL_HPP_
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * CPUs and their NUMA nodes as reported by sysfs, read once per process.
+ * Single node is assumed if NUMA information is not available.
+ */
+namespace handystats { namespace cpu_topology {
+
+// Number of configured CPUs
+size_t cpus_count();
+
+// NUMA node of the CPU
+size_t node_of(const size_t& cpu);
+
+// CPUs ordered by NUMA node, CPUs of the node are in ascending order
+const std::vector<size_t>& cpus_by_node();
+
+// CPU the calling thread is running on, the thread could be migrated right after the call
+size_t current_cpu();
+
+}} // namespace handystats::cpu_topology
+
+#endif // HANDYSTATS_CPU_TOPOLOGY_IMPL_HPP_
@@ -1,54 +1,149 @@
 // Copyright (c) 2014 Yandex LLC. All rights reserved.
 
 #include <algorithm>
+#include <new>
 
+#include "events/event_message_pool_impl.hpp"
 #include "events/attribute_impl.hpp"
 
 
 namespace handystats { namespace events { namespace attribute {
 
+static_assert(
+		event_type::SET_STRING - event_type::SET_BOOL == metrics::attribute::STRING,
+		"attribute event types should follow value indices"
+	);
+
+namespace {
+
+// stores attribute value into message's payload
+struct store_value : boost::static_visitor<> {
+	event_message& message;
+
+	store_value(event_message& message)
+		: message(message)
+	{}
+
+	template <typename T>
+	void operator() (const T& value) const {
+		static_assert(sizeof(T) <= sizeof(message.event_data), "attribute value doesn't fit into event data");
+		new (&message.event_data) T(value);
+	}
+
+	void operator() (const std::string& value) const {
+		// assign reuses string's capacity
+		message.event_string.assign(value);
+	}
+};
+
+template <typename T>
+const T& inline_value(const event_message& message) {
+	return *reinterpret_cast<const T*>(&message.event_data);
+}
+
+} // unnamed namespace
+
+static event_message* create_message(std::string&& attribute_name, const metrics::attribute::time_point& timestamp) {
+	event_message* message = pool::acquire();
+
+	message->destination_name.swap(attribute_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
+	message->destination_type = event_destination_type::ATTRIBUTE;
+
+	message->timestamp = timestamp;
+
+	return message;
+}
+
 event_message* create_set_event(
 		std::string&& attribute_name,
 		const metrics::attribute::value_type& value,
 		const metrics::attribute::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = create_message(std::move(attribute_name), timestamp);
 
-	message->destination_name.swap(attribute_name);
-	message->destination_type = event_destination_type::ATTRIBUTE;
+	// event types follow value indices
+	message->event_type = event_type::SET_BOOL + value.which();
+	boost::apply_visitor(store_value(*message), value);
 
-	message->timestamp = timestamp;
+	return message;
+}
+
+event_message* create_set_event(
+		std::string&& attribute_name,
+		const std::string& value,
+		const metrics::attribute::time_point& timestamp
+	)
+{
+	event_message* message = create_message(std::move(attribute_name), timestamp);
 
-	message->event_type = event_type::SET;
-	message->event_data = new metrics::attribute::value_type(value);
+	message->event_type = event_type::SET_STRING;
+	const store_value store(*message);
+	store(value);
 
 	return message;
 }
 
-void delete_set_event(event_message* message) {
-	delete static_cast<metrics::attribute::value_type*>(message->event_data);
+event_message* create_set_event(
+		const metric_handle& attribute_handle,
+		const metrics::attribute::value_type& value,
+		const metrics::attribute::time_point& timestamp
+	)
+{
+	event_message* message = create_set_event(std::string(), value, timestamp);
+	message->destination_id = attribute_handle.id;
+	message->destination_hash = attribute_handle.hash;
 
-	delete message;
+	return message;
 }
 
-void delete_event(event_message* message) {
-	switch (message->event_type) {
-		case event_type::SET:
-			delete_set_event(message);
-			break;
-	}
+event_message* create_set_event(
+		const metric_literal& attribute_literal,
+		const metrics::attribute::value_type& value,
+		const metrics::attribute::time_point& timestamp
+	)
+{
+	event_message* message = create_set_event(std::string(), value, timestamp);
+	message->destination_literal = attribute_literal.name;
+	message->destination_hash = attribute_literal.hash;
+
+	return message;
 }
 
-void process_set_event(metrics::attribute& attribute, const event_message& message) {
-	const auto& value = *reinterpret_cast<metrics::attribute::value_type*>(message.event_data);
-	attribute.set(value);
+void delete_event(event_message* message) {
+	// string payload keeps its capacity for the next event
+	pool::release(message);
 }
 
 void process_event(metrics::attribute& attribute, const event_message& message) {
 	switch (message.event_type) {
-		case event_type::SET:
-			process_set_event(attribute, message);
+		case event_type::SET_BOOL:
+			attribute.set(inline_value<bool>(message));
+			break;
+		case event_type::SET_INT:
+			attribute.set(inline_value<int>(message));
+			break;
+		case event_type::SET_UINT:
+			attribute.set(inline_value<unsigned>(message));
+			break;
+		case event_type::SET_INT64:
+			attribute.set(inline_value<int64_t>(message));
+			break;
+		case event_type::SET_UINT64:
+			attribute.set(inline_value<uint64_t>(message));
+			break;
+		case event_type::SET_DOUBLE:
+			attribute.set(inline_value<double>(message));
+			break;
+		case event_type::SET_STRING:
+			if (message.event_string_ref) {
+				attribute.set(std::string(message.event_string_ref, message.event_string_ref_length));
+			}
+			else {
+				attribute.set(message.event_string);
+			}
 			break;
 		default:
 			return;
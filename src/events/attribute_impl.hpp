@@ -12,9 +12,19 @@
 
 namespace handystats { namespace events { namespace attribute {
 
+/*
+ * Set event type defines type of the value (as in metrics::attribute::value_index),
+ * scalar values are stored inline in event_data, string value is stored in event_string.
+ */
 namespace event_type {
 enum : char {
-	SET = 0
+	SET_BOOL = 0,
+	SET_INT,
+	SET_UINT,
+	SET_INT64,
+	SET_UINT64,
+	SET_DOUBLE,
+	SET_STRING
 };
 } // namespace event_type
 
@@ -27,6 +37,24 @@ event_message* create_set_event(
 		const metrics::attribute::time_point& timestamp
 	);
 
+event_message* create_set_event(
+		std::string&& attribute_name,
+		const std::string& value,
+		const metrics::attribute::time_point& timestamp
+	);
+
+event_message* create_set_event(
+		const metric_handle& attribute_handle,
+		const metrics::attribute::value_type& value,
+		const metrics::attribute::time_point& timestamp
+	);
+
+event_message* create_set_event(
+		const metric_literal& attribute_literal,
+		const metrics::attribute::value_type& value,
+		const metrics::attribute::time_point& timestamp
+	);
+
 /*
  * Event destructor
  */
@@ -36,7 +64,7 @@ void delete_event(event_message* message);
 /*
  * Event processing function
  */
-void process_event(metrics::attribute& counter, const event_message& message);
+void process_event(metrics::attribute& attribute, const event_message& message);
 
 }}} // namespace handystats::events::attribute
 
@@ -2,6 +2,7 @@
 
 #include "config_impl.hpp"
 
+#include "events/event_message_pool_impl.hpp"
 #include "events/counter_impl.hpp"
 
 
@@ -13,9 +14,11 @@ event_message* create_init_event(
 		const metrics::counter::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(counter_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::COUNTER;
 
 	message->timestamp = timestamp;
@@ -26,8 +29,34 @@ event_message* create_init_event(
 	return message;
 }
 
+event_message* create_init_event(
+		const metric_handle& counter_handle,
+		const metrics::counter::value_type& init_value,
+		const metrics::counter::time_point& timestamp
+	)
+{
+	event_message* message = create_init_event(std::string(), init_value, timestamp);
+	message->destination_id = counter_handle.id;
+	message->destination_hash = counter_handle.hash;
+
+	return message;
+}
+
+event_message* create_init_event(
+		const metric_literal& counter_literal,
+		const metrics::counter::value_type& init_value,
+		const metrics::counter::time_point& timestamp
+	)
+{
+	event_message* message = create_init_event(std::string(), init_value, timestamp);
+	message->destination_literal = counter_literal.name;
+	message->destination_hash = counter_literal.hash;
+
+	return message;
+}
+
 void delete_init_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -37,9 +66,11 @@ event_message* create_increment_event(
 		const metrics::counter::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(counter_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::COUNTER;
 
 	message->timestamp = timestamp;
@@ -50,8 +81,34 @@ event_message* create_increment_event(
 	return message;
 }
 
+event_message* create_increment_event(
+		const metric_handle& counter_handle,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	)
+{
+	event_message* message = create_increment_event(std::string(), value, timestamp);
+	message->destination_id = counter_handle.id;
+	message->destination_hash = counter_handle.hash;
+
+	return message;
+}
+
+event_message* create_increment_event(
+		const metric_literal& counter_literal,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	)
+{
+	event_message* message = create_increment_event(std::string(), value, timestamp);
+	message->destination_literal = counter_literal.name;
+	message->destination_hash = counter_literal.hash;
+
+	return message;
+}
+
 void delete_increment_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -61,9 +118,11 @@ event_message* create_decrement_event(
 		const metrics::counter::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(counter_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::COUNTER;
 
 	message->timestamp = timestamp;
@@ -74,8 +133,34 @@ event_message* create_decrement_event(
 	return message;
 }
 
+event_message* create_decrement_event(
+		const metric_handle& counter_handle,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	)
+{
+	event_message* message = create_decrement_event(std::string(), value, timestamp);
+	message->destination_id = counter_handle.id;
+	message->destination_hash = counter_handle.hash;
+
+	return message;
+}
+
+event_message* create_decrement_event(
+		const metric_literal& counter_literal,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	)
+{
+	event_message* message = create_decrement_event(std::string(), value, timestamp);
+	message->destination_literal = counter_literal.name;
+	message->destination_hash = counter_literal.hash;
+
+	return message;
+}
+
 void delete_decrement_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
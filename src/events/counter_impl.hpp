@@ -29,18 +29,54 @@ event_message* create_init_event(
 		const metrics::counter::time_point& timestamp
 	);
 
+event_message* create_init_event(
+		const metric_handle& counter_handle,
+		const metrics::counter::value_type& init_value,
+		const metrics::counter::time_point& timestamp
+	);
+
+event_message* create_init_event(
+		const metric_literal& counter_literal,
+		const metrics::counter::value_type& init_value,
+		const metrics::counter::time_point& timestamp
+	);
+
 event_message* create_increment_event(
 		std::string&& counter_name,
 		const metrics::counter::value_type& value,
 		const metrics::counter::time_point& timestamp
 	);
 
+event_message* create_increment_event(
+		const metric_handle& counter_handle,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	);
+
+event_message* create_increment_event(
+		const metric_literal& counter_literal,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	);
+
 event_message* create_decrement_event(
 		std::string&& counter_name,
 		const metrics::counter::value_type& value,
 		const metrics::counter::time_point& timestamp
 	);
 
+event_message* create_decrement_event(
+		const metric_handle& counter_handle,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	);
+
+event_message* create_decrement_event(
+		const metric_literal& counter_literal,
+		const metrics::counter::value_type& value,
+		const metrics::counter::time_point& timestamp
+	);
+
 
 /*
  * Event destructor
@@ -7,11 +7,15 @@
 #include <vector>
 
 #include <handystats/chrono.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metric_literal.hpp>
 
 #include "message_queue_impl.hpp"
 
 namespace handystats { namespace events {
 
+struct event_message_pool;
+
 namespace event_destination_type {
 enum : char {
 	COUNTER = 0,
@@ -26,10 +30,27 @@ struct event_message : message_queue::node
 	char destination_type;
 	char event_type;
 	std::string destination_name;
+	// pre-resolved metric id, if valid used instead of destination_name
+	metric_handle::id_type destination_id;
+	// static name literal with its hash, if not null used instead of destination_name
+	const char* destination_literal;
+	uint64_t destination_hash;
 
 	chrono::time_point timestamp;
 
 	void* event_data;
+	// string payload (attribute values), its capacity is kept by the pool between uses
+	std::string event_string;
+
+	// packed log records are consumed in place:
+	// their name and string payload are referenced in the log instead of being copied into the strings above
+	const char* destination_name_ref = nullptr;
+	size_t destination_name_ref_length = 0;
+	const char* event_string_ref = nullptr;
+	size_t event_string_ref_length = 0;
+
+	// pool the message is returned to on deletion
+	event_message_pool* owner_pool;
 };
 
 void delete_event_message(event_message* message);
@@ -0,0 +1,236 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <pthread.h>
+
+#include <handystats/atomic.hpp>
+
+#include "events/event_message_impl.hpp"
+#include "config_impl.hpp"
+
+#include "events/event_message_pool_impl.hpp"
+
+
+namespace handystats { namespace events {
+
+/*
+ * Pool is owned by a single producer thread.
+ * Free messages are kept in the owner-only freelist,
+ * released messages are pushed by other threads onto the returned stack
+ * and are taken back by the owner all at once when the freelist runs out.
+ * Pools are never freed: pool of an exited thread is marked orphaned
+ * and is adopted by the next new thread with all its messages.
+ *
+ * Packed topology encodes the message into the producer's log as soon as it is created,
+ * so the owner's single staging message is handed out instead of pooled ones.
+ */
+struct event_message_pool {
+	static const size_t SLAB_SIZE = 64;
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	event_message_pool()
+		: free_list(nullptr)
+		, staging()
+		, allocated(0)
+		, acquired(0)
+		, returned(nullptr)
+		, released(0)
+		, orphaned(false)
+		, next(nullptr)
+	{
+		staging.owner_pool = nullptr;
+	}
+
+	// owner side
+	event_message* free_list;
+	event_message staging;
+	std::atomic<size_t> allocated;
+	std::atomic<size_t> acquired;
+
+	char pad0[CACHE_LINE_SIZE];
+
+	// releasers side
+	std::atomic<event_message*> returned;
+	std::atomic<size_t> released;
+
+	char pad1[CACHE_LINE_SIZE];
+
+	std::atomic<bool> orphaned;
+	event_message_pool* next;
+};
+
+}} // namespace handystats::events
+
+
+namespace {
+
+using handystats::events::event_message;
+using handystats::events::event_message_pool;
+
+std::atomic<event_message_pool*> pools(nullptr);
+
+__thread event_message_pool* thread_pool = nullptr;
+
+pthread_key_t pool_key;
+pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+
+// messages of later destructors of the exiting thread are taken from another adopted pool
+void orphan_thread_pool(void* pool) {
+	thread_pool = nullptr;
+	static_cast<event_message_pool*>(pool)->orphaned.store(true, std::memory_order_release);
+}
+
+void create_pool_key() {
+	pthread_key_create(&pool_key, orphan_thread_pool);
+}
+
+event_message_pool* adopt_thread_pool() {
+	pthread_once(&pool_key_once, create_pool_key);
+
+	event_message_pool* pool = nullptr;
+
+	for (event_message_pool* iter = pools.load(std::memory_order_acquire); iter; iter = iter->next) {
+		bool orphaned = true;
+		if (iter->orphaned.load(std::memory_order_relaxed) &&
+				iter->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acq_rel))
+		{
+			pool = iter;
+			break;
+		}
+	}
+
+	if (!pool) {
+		pool = new event_message_pool();
+		pool->next = pools.load(std::memory_order_acquire);
+		while (!pools.compare_exchange_weak(pool->next, pool, std::memory_order_acq_rel)) {
+		}
+	}
+
+	pthread_setspecific(pool_key, pool);
+
+	return pool;
+}
+
+void allocate_slab(event_message_pool* pool) {
+	event_message* slab = new event_message[event_message_pool::SLAB_SIZE];
+
+	for (size_t index = 0; index < event_message_pool::SLAB_SIZE; ++index) {
+		slab[index].owner_pool = pool;
+		slab[index].next.store(pool->free_list, std::memory_order_relaxed);
+		pool->free_list = &slab[index];
+	}
+
+	pool->allocated.store(
+			pool->allocated.load(std::memory_order_relaxed) + event_message_pool::SLAB_SIZE,
+			std::memory_order_relaxed
+		);
+}
+
+} // unnamed namespace
+
+
+namespace handystats { namespace events { namespace pool {
+
+event_message* acquire() {
+	event_message_pool* pool = thread_pool;
+	if (!pool) {
+		pool = thread_pool = adopt_thread_pool();
+	}
+
+	if (handystats::config::message_queue_opts.topology == handystats::config::message_queue::PACKED) {
+		return &pool->staging;
+	}
+
+	if (!pool->free_list) {
+		pool->free_list = pool->returned.exchange(nullptr, std::memory_order_acquire);
+		if (!pool->free_list) {
+			allocate_slab(pool);
+		}
+	}
+
+	event_message* message = pool->free_list;
+	pool->free_list = message->next.load(std::memory_order_relaxed);
+
+	pool->acquired.store(pool->acquired.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	return message;
+}
+
+void release(event_message* message) {
+	event_message_pool* pool = message->owner_pool;
+
+	// staging message stays with the owner
+	if (!pool) {
+		return;
+	}
+
+	// released by the owner (inline processing), no need to go through the returned stack
+	if (pool == thread_pool) {
+		message->next.store(pool->free_list, std::memory_order_relaxed);
+		pool->free_list = message;
+		pool->released.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	event_message* head = pool->returned.load(std::memory_order_relaxed);
+	do {
+		message->next.store(head, std::memory_order_relaxed);
+	} while (!pool->returned.compare_exchange_weak(head, message, std::memory_order_release, std::memory_order_relaxed));
+
+	pool->released.fetch_add(1, std::memory_order_relaxed);
+}
+
+void initialize() {
+	stats::initialize();
+}
+
+void finalize() {
+	stats::finalize();
+}
+
+
+namespace stats {
+
+metrics::gauge allocated;
+metrics::gauge in_use;
+
+void update(const chrono::time_point& timestamp) {
+	size_t allocated_count = 0;
+	size_t acquired_count = 0;
+	size_t released_count = 0;
+
+	for (event_message_pool* pool = pools.load(std::memory_order_acquire); pool; pool = pool->next) {
+		allocated_count += pool->allocated.load(std::memory_order_relaxed);
+		acquired_count += pool->acquired.load(std::memory_order_relaxed);
+		released_count += pool->released.load(std::memory_order_relaxed);
+	}
+
+	allocated.set(allocated_count, timestamp);
+	in_use.set(acquired_count > released_count ? acquired_count - released_count : 0, timestamp);
+}
+
+static void reset() {
+	config::metrics::gauge allocated_opts;
+	allocated_opts.values.tags = statistics::tag::value;
+
+	allocated = metrics::gauge(allocated_opts);
+	allocated.set(0);
+
+	config::metrics::gauge in_use_opts;
+	in_use_opts.values.tags = statistics::tag::value | statistics::tag::max;
+
+	in_use = metrics::gauge(in_use_opts);
+	in_use.set(0);
+}
+
+void initialize() {
+	reset();
+}
+
+void finalize() {
+	reset();
+}
+
+} // namespace stats
+
+
+}}} // namespace handystats::events::pool
@@ -0,0 +1,44 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_EVENT_MESSAGE_POOL_IMPL_HPP_
+#define HANDYSTATS_EVENT_MESSAGE_POOL_IMPL_HPP_
+
+#include <handystats/chrono.hpp>
+#include <handystats/metrics/gauge.hpp>
+
+namespace handystats { namespace events {
+
+struct event_message;
+
+}} // namespace handystats::events
+
+
+namespace handystats { namespace events { namespace pool {
+
+// Per-thread freelist of event messages.
+// Messages are taken from the calling thread's pool and handed back to their owner pool
+// on release (usually by the processor thread), so in steady state no heap allocation happens.
+event_message* acquire();
+void release(event_message*);
+
+void initialize();
+void finalize();
+
+
+namespace stats {
+
+extern metrics::gauge allocated;
+extern metrics::gauge in_use;
+
+void update(const chrono::time_point&);
+
+void initialize();
+void finalize();
+
+} // namespace stats
+
+
+}}} // namespace handystats::events::pool
+
+
+#endif // HANDYSTATS_EVENT_MESSAGE_POOL_IMPL_HPP_
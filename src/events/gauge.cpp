@@ -2,6 +2,7 @@
 
 #include "config_impl.hpp"
 
+#include "events/event_message_pool_impl.hpp"
 #include "events/gauge_impl.hpp"
 
 
@@ -13,9 +14,11 @@ event_message* create_init_event(
 		const metrics::gauge::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(gauge_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::GAUGE;
 
 	message->timestamp = timestamp;
@@ -26,8 +29,34 @@ event_message* create_init_event(
 	return message;
 }
 
+event_message* create_init_event(
+		const metric_handle& gauge_handle,
+		const metrics::gauge::value_type& init_value,
+		const metrics::gauge::time_point& timestamp
+	)
+{
+	event_message* message = create_init_event(std::string(), init_value, timestamp);
+	message->destination_id = gauge_handle.id;
+	message->destination_hash = gauge_handle.hash;
+
+	return message;
+}
+
+event_message* create_init_event(
+		const metric_literal& gauge_literal,
+		const metrics::gauge::value_type& init_value,
+		const metrics::gauge::time_point& timestamp
+	)
+{
+	event_message* message = create_init_event(std::string(), init_value, timestamp);
+	message->destination_literal = gauge_literal.name;
+	message->destination_hash = gauge_literal.hash;
+
+	return message;
+}
+
 void delete_init_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -37,9 +66,11 @@ event_message* create_set_event(
 		const metrics::gauge::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(gauge_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::GAUGE;
 
 	message->timestamp = timestamp;
@@ -50,8 +81,34 @@ event_message* create_set_event(
 	return message;
 }
 
+event_message* create_set_event(
+		const metric_handle& gauge_handle,
+		const metrics::gauge::value_type& value,
+		const metrics::gauge::time_point& timestamp
+	)
+{
+	event_message* message = create_set_event(std::string(), value, timestamp);
+	message->destination_id = gauge_handle.id;
+	message->destination_hash = gauge_handle.hash;
+
+	return message;
+}
+
+event_message* create_set_event(
+		const metric_literal& gauge_literal,
+		const metrics::gauge::value_type& value,
+		const metrics::gauge::time_point& timestamp
+	)
+{
+	event_message* message = create_set_event(std::string(), value, timestamp);
+	message->destination_literal = gauge_literal.name;
+	message->destination_hash = gauge_literal.hash;
+
+	return message;
+}
+
 void delete_set_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -28,12 +28,36 @@ event_message* create_init_event(
 		const metrics::gauge::time_point& timestamp
 	);
 
+event_message* create_init_event(
+		const metric_handle& gauge_handle,
+		const metrics::gauge::value_type& init_value,
+		const metrics::gauge::time_point& timestamp
+	);
+
+event_message* create_init_event(
+		const metric_literal& gauge_literal,
+		const metrics::gauge::value_type& init_value,
+		const metrics::gauge::time_point& timestamp
+	);
+
 event_message* create_set_event(
 		std::string&& gauge_name,
 		const metrics::gauge::value_type& value,
 		const metrics::gauge::time_point& timestamp
 	);
 
+event_message* create_set_event(
+		const metric_handle& gauge_handle,
+		const metrics::gauge::value_type& value,
+		const metrics::gauge::time_point& timestamp
+	);
+
+event_message* create_set_event(
+		const metric_literal& gauge_literal,
+		const metrics::gauge::value_type& value,
+		const metrics::gauge::time_point& timestamp
+	);
+
 
 /*
  * Event destructor
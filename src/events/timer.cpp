@@ -4,6 +4,7 @@
 
 #include "config_impl.hpp"
 
+#include "events/event_message_pool_impl.hpp"
 #include "events/timer_impl.hpp"
 
 
@@ -15,9 +16,11 @@ event_message* create_init_event(
 		const metrics::timer::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(timer_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::TIMER;
 
 	message->timestamp = timestamp;
@@ -28,8 +31,34 @@ event_message* create_init_event(
 	return message;
 }
 
+event_message* create_init_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_init_event(std::string(), instance_id, timestamp);
+	message->destination_id = timer_handle.id;
+	message->destination_hash = timer_handle.hash;
+
+	return message;
+}
+
+event_message* create_init_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_init_event(std::string(), instance_id, timestamp);
+	message->destination_literal = timer_literal.name;
+	message->destination_hash = timer_literal.hash;
+
+	return message;
+}
+
 void delete_init_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -39,9 +68,11 @@ event_message* create_start_event(
 		const metrics::timer::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(timer_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::TIMER;
 
 	message->timestamp = timestamp;
@@ -52,8 +83,34 @@ event_message* create_start_event(
 	return message;
 }
 
+event_message* create_start_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_start_event(std::string(), instance_id, timestamp);
+	message->destination_id = timer_handle.id;
+	message->destination_hash = timer_handle.hash;
+
+	return message;
+}
+
+event_message* create_start_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_start_event(std::string(), instance_id, timestamp);
+	message->destination_literal = timer_literal.name;
+	message->destination_hash = timer_literal.hash;
+
+	return message;
+}
+
 void delete_start_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -63,9 +120,11 @@ event_message* create_stop_event(
 		const metrics::timer::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(timer_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::TIMER;
 
 	message->timestamp = timestamp;
@@ -76,8 +135,34 @@ event_message* create_stop_event(
 	return message;
 }
 
+event_message* create_stop_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_stop_event(std::string(), instance_id, timestamp);
+	message->destination_id = timer_handle.id;
+	message->destination_hash = timer_handle.hash;
+
+	return message;
+}
+
+event_message* create_stop_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_stop_event(std::string(), instance_id, timestamp);
+	message->destination_literal = timer_literal.name;
+	message->destination_hash = timer_literal.hash;
+
+	return message;
+}
+
 void delete_stop_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -87,9 +172,11 @@ event_message* create_discard_event(
 		const metrics::timer::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(timer_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::TIMER;
 
 	message->timestamp = timestamp;
@@ -100,8 +187,34 @@ event_message* create_discard_event(
 	return message;
 }
 
+event_message* create_discard_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_discard_event(std::string(), instance_id, timestamp);
+	message->destination_id = timer_handle.id;
+	message->destination_hash = timer_handle.hash;
+
+	return message;
+}
+
+event_message* create_discard_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_discard_event(std::string(), instance_id, timestamp);
+	message->destination_literal = timer_literal.name;
+	message->destination_hash = timer_literal.hash;
+
+	return message;
+}
+
 void delete_discard_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -111,9 +224,11 @@ event_message* create_heartbeat_event(
 		const metrics::timer::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(timer_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::TIMER;
 
 	message->timestamp = timestamp;
@@ -124,8 +239,34 @@ event_message* create_heartbeat_event(
 	return message;
 }
 
+event_message* create_heartbeat_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_heartbeat_event(std::string(), instance_id, timestamp);
+	message->destination_id = timer_handle.id;
+	message->destination_hash = timer_handle.hash;
+
+	return message;
+}
+
+event_message* create_heartbeat_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_heartbeat_event(std::string(), instance_id, timestamp);
+	message->destination_literal = timer_literal.name;
+	message->destination_hash = timer_literal.hash;
+
+	return message;
+}
+
 void delete_heartbeat_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
@@ -135,9 +276,11 @@ event_message* create_set_event(
 		const metrics::timer::time_point& timestamp
 	)
 {
-	event_message* message = new event_message;
+	event_message* message = pool::acquire();
 
 	message->destination_name.swap(timer_name);
+	message->destination_id = metric_handle::INVALID_ID;
+	message->destination_literal = nullptr;
 	message->destination_type = event_destination_type::TIMER;
 
 	message->timestamp = timestamp;
@@ -155,8 +298,34 @@ event_message* create_set_event(
 	return message;
 }
 
+event_message* create_set_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::value_type& measurement,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_set_event(std::string(), measurement, timestamp);
+	message->destination_id = timer_handle.id;
+	message->destination_hash = timer_handle.hash;
+
+	return message;
+}
+
+event_message* create_set_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::value_type& measurement,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	event_message* message = create_set_event(std::string(), measurement, timestamp);
+	message->destination_literal = timer_literal.name;
+	message->destination_hash = timer_literal.hash;
+
+	return message;
+}
+
 void delete_set_event(event_message* message) {
-	delete message;
+	pool::release(message);
 }
 
 
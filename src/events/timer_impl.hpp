@@ -32,36 +32,108 @@ event_message* create_init_event(
 		const metrics::timer::time_point& timestamp
 	);
 
+event_message* create_init_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
+event_message* create_init_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
 event_message* create_start_event(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
 		const metrics::timer::time_point& timestamp
 	);
 
+event_message* create_start_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
+event_message* create_start_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
 event_message* create_stop_event(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
 		const metrics::timer::time_point& timestamp
 	);
 
+event_message* create_stop_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
+event_message* create_stop_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
 event_message* create_discard_event(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
 		const metrics::timer::time_point& timestamp
 	);
 
+event_message* create_discard_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
+event_message* create_discard_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
 event_message* create_heartbeat_event(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
 		const metrics::timer::time_point& timestamp
 	);
 
+event_message* create_heartbeat_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
+event_message* create_heartbeat_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	);
+
 event_message* create_set_event(
 		std::string&& timer_name,
 		const metrics::timer::value_type& measurement,
 		const metrics::timer::time_point& timestamp
 	);
 
+event_message* create_set_event(
+		const metric_handle& timer_handle,
+		const metrics::timer::value_type& measurement,
+		const metrics::timer::time_point& timestamp
+	);
+
+event_message* create_set_event(
+		const metric_literal& timer_literal,
+		const metrics::timer::value_type& measurement,
+		const metrics::timer::time_point& timestamp
+	);
+
 /*
  * Event destructor
  */
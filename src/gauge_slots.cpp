@@ -0,0 +1,81 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <handystats/atomic.hpp>
+
+#include <handystats/statistics.hpp>
+
+#include "events/event_message_impl.hpp"
+#include "events/gauge_impl.hpp"
+#include "config_impl.hpp"
+#include "handle_slots_impl.hpp"
+#include "self_stats_impl.hpp"
+
+#include "gauge_slots_impl.hpp"
+
+namespace handystats { namespace gauge_slots {
+
+static handle_slots::slot_table<metrics::gauge::value_type> slots;
+
+static std::atomic<bool> coalescing(false);
+
+bool enabled() {
+	return coalescing.load(std::memory_order_acquire);
+}
+
+bool set(
+		const metric_handle& handle,
+		const metrics::gauge::value_type& value,
+		const chrono::time_point& timestamp
+	)
+{
+	if (!enabled()) {
+		return false;
+	}
+
+	auto* s = slots.find(handle.id);
+	if (!s) {
+		return false;
+	}
+
+	self_stats::produced(events::event_destination_type::GAUGE, events::gauge::event_type::SET);
+
+	handle_slots::lock(*s);
+	s->hash = handle.hash;
+	s->value = value;
+	s->timestamp = timestamp;
+	s->assigned = true;
+	s->dirty.store(true, std::memory_order_relaxed);
+	handle_slots::unlock(*s);
+
+	return true;
+}
+
+void collect(const size_t& shard, slot_handler handler) {
+	slots.collect(shard,
+			[&shard, handler] (
+				const metric_handle::id_type& id,
+				const metrics::gauge::value_type& value,
+				const chrono::time_point& timestamp
+			)
+			{
+				handler(shard, id, value, timestamp);
+			}
+		);
+}
+
+void initialize() {
+	// value and timestamp are the only statistics that don't depend on every sample
+	const statistics::tag::type last_value_tags = statistics::tag::value | statistics::tag::timestamp;
+	coalescing.store(
+			(config::metrics::gauge_opts.values.tags & ~last_value_tags) == 0,
+			std::memory_order_release
+		);
+}
+
+void finalize() {
+	coalescing.store(false, std::memory_order_release);
+
+	slots.reset();
+}
+
+}} // namespace handystats::gauge_slots
@@ -0,0 +1,46 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_GAUGE_SLOTS_IMPL_HPP_
+#define HANDYSTATS_GAUGE_SLOTS_IMPL_HPP_
+
+#include <handystats/chrono.hpp>
+#include <handystats/metric_handle.hpp>
+#include <handystats/metrics/gauge.hpp>
+
+/*
+ * Coalescing of gauge sets.
+ * If gauges are configured without per-sample statistics (only value and timestamp are computed)
+ * only the last set per dump interval matters. In that case sets through metric handles
+ * bypass the message queue and are stored into per-handle slot, which is sampled by the processor on dump.
+ * Slot's set and queued sets of the same gauge (by name or before initialization) are ordered
+ * by timestamps when applied: the latest set wins.
+ */
+namespace handystats { namespace gauge_slots {
+
+typedef void (*slot_handler)(
+		const size_t& shard,
+		const metric_handle::id_type& id,
+		const metrics::gauge::value_type& value,
+		const chrono::time_point& timestamp
+	);
+
+// Whether gauge sets are coalesced, decided on initialization from gauges configuration
+bool enabled();
+
+// Producer side: stores the value into the gauge's slot,
+// returns false if the value should be sent through the message queue instead
+bool set(
+		const metric_handle& handle,
+		const metrics::gauge::value_type& value,
+		const chrono::time_point& timestamp
+	);
+
+// Processor side: calls handler for each gauge of the shard set since the previous collect
+void collect(const size_t& shard, slot_handler handler);
+
+void initialize();
+void finalize();
+
+}} // namespace handystats::gauge_slots
+
+#endif // HANDYSTATS_GAUGE_SLOTS_IMPL_HPP_
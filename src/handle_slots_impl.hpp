@@ -0,0 +1,136 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_HANDLE_SLOTS_IMPL_HPP_
+#define HANDYSTATS_HANDLE_SLOTS_IMPL_HPP_
+
+#include <handystats/atomic.hpp>
+#include <handystats/chrono.hpp>
+#include <handystats/metric_handle.hpp>
+
+#include "message_queue_impl.hpp"
+
+/*
+ * Table of last-value slots indexed by metric handle id.
+ * Used for sets that bypass the message queue (see gauge_slots and attribute_slots).
+ * Each slot is guarded by its own spinlock, the processor takes only dirty slots of its shard.
+ */
+namespace handystats { namespace handle_slots {
+
+template <typename Value>
+struct slot {
+	std::atomic<bool> lock;
+	// could be checked by the processor without taking the lock
+	std::atomic<bool> dirty;
+	// value has been set since last reset
+	bool assigned;
+	// metric name hash, slots are collected by the metric's shard
+	uint64_t hash;
+	Value value;
+	chrono::time_point timestamp;
+
+	slot()
+		: lock(false)
+		, dirty(false)
+		, assigned(false)
+		, hash(0)
+		, value()
+		, timestamp()
+	{}
+};
+
+template <typename Value>
+void lock(slot<Value>& s) {
+	while (s.lock.exchange(true, std::memory_order_acquire)) {
+		while (s.lock.load(std::memory_order_relaxed)) {
+		}
+	}
+}
+
+template <typename Value>
+void unlock(slot<Value>& s) {
+	s.lock.store(false, std::memory_order_release);
+}
+
+/*
+ * Slots are allocated by chunks on first access and are kept for the whole life of the process
+ * as metric handles are.
+ * Table has no constructor, so that it's zero-initialized as a static object.
+ */
+template <typename Value>
+struct slot_table {
+	static const size_t CHUNK_SIZE = 256;
+	static const size_t MAX_CHUNKS = 4096;
+
+	std::atomic<slot<Value>*> chunks[MAX_CHUNKS];
+
+	// returns nullptr if id is out of the table's range
+	slot<Value>* find(const metric_handle::id_type& id) {
+		const size_t chunk_index = id / CHUNK_SIZE;
+		if (chunk_index >= MAX_CHUNKS) {
+			return nullptr;
+		}
+
+		slot<Value>* chunk = chunks[chunk_index].load(std::memory_order_acquire);
+		if (!chunk) {
+			slot<Value>* new_chunk = new slot<Value>[CHUNK_SIZE];
+			if (chunks[chunk_index].compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel)) {
+				chunk = new_chunk;
+			}
+			else {
+				delete[] new_chunk;
+			}
+		}
+
+		return chunk + id % CHUNK_SIZE;
+	}
+
+	// Processor side: calls handler(id, value, timestamp) for each slot of the shard set since the previous collect
+	template <typename Handler>
+	void collect(const size_t& shard, Handler handler) {
+		for (size_t chunk_index = 0; chunk_index < MAX_CHUNKS; ++chunk_index) {
+			slot<Value>* chunk = chunks[chunk_index].load(std::memory_order_acquire);
+			if (!chunk) {
+				continue;
+			}
+
+			for (size_t index = 0; index < CHUNK_SIZE; ++index) {
+				slot<Value>& s = chunk[index];
+				if (!s.dirty.load(std::memory_order_relaxed)) {
+					continue;
+				}
+
+				lock(s);
+				const bool dirty = message_queue::shard_of(s.hash) == shard && s.dirty.exchange(false, std::memory_order_relaxed);
+				const Value value = s.value;
+				const chrono::time_point timestamp = s.timestamp;
+				unlock(s);
+
+				if (dirty) {
+					handler(chunk_index * CHUNK_SIZE + index, value, timestamp);
+				}
+			}
+		}
+	}
+
+	// Discards all pending and last values
+	void reset() {
+		for (size_t chunk_index = 0; chunk_index < MAX_CHUNKS; ++chunk_index) {
+			slot<Value>* chunk = chunks[chunk_index].load(std::memory_order_acquire);
+			if (!chunk) {
+				continue;
+			}
+
+			for (size_t index = 0; index < CHUNK_SIZE; ++index) {
+				slot<Value>& s = chunk[index];
+				lock(s);
+				s.dirty.store(false, std::memory_order_relaxed);
+				s.assigned = false;
+				unlock(s);
+			}
+		}
+	}
+};
+
+}} // namespace handystats::handle_slots
+
+#endif // HANDYSTATS_HANDLE_SLOTS_IMPL_HPP_
@@ -2,6 +2,11 @@
 
 #include <string>
 #include <map>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <cstring>
 
 #include <handystats/chrono.hpp>
 #include <handystats/metrics.hpp>
@@ -12,6 +17,11 @@
 #include "events/timer_impl.hpp"
 #include "events/attribute_impl.hpp"
 #include "config_impl.hpp"
+#include "registry_impl.hpp"
+#include "gauge_slots_impl.hpp"
+#include "message_queue_impl.hpp"
+#include "attribute_slots_impl.hpp"
+#include "self_stats_impl.hpp"
 
 #include "internal_impl.hpp"
 
@@ -53,13 +63,91 @@ void finalize() {
 } // namespace stats
 
 
-std::map<std::string, metrics::metric_ptr_variant> metrics_map;
+std::vector<shard*> shards;
+
+shard::shard(const size_t& index)
+	: index(index)
+	, metrics_map()
+	, metrics_index()
+	, metrics_literals()
+	, set_orders()
+	, size(0)
+	, snapshot()
+	, snapshot_epoch(0)
+{}
+
+static metrics_table::index_type find_literal_metric(shard& metrics_shard, const events::event_message& message) {
+	auto& metrics_map = metrics_shard.metrics_map;
+	auto& metrics_literals = metrics_shard.metrics_literals;
+
+	auto literal_iter = metrics_literals.find(message.destination_hash);
+
+	if (literal_iter == metrics_literals.end()) {
+		// literal hash is the same as metrics_map's one
+		const auto index =
+			metrics_map.insert(message.destination_literal, strlen(message.destination_literal), message.destination_hash);
+		metrics_literals.insert(
+				std::make_pair(message.destination_hash, shard::literal_entry{message.destination_literal, index})
+			);
+		return index;
+	}
+
+	const shard::literal_entry& entry = literal_iter->second;
+
+	// same literal in different translation units could have different addresses
+	if (entry.literal == message.destination_literal || strcmp(entry.literal, message.destination_literal) == 0) {
+		return entry.index;
+	}
+
+	// hash collision
+	return metrics_map.insert(std::string(message.destination_literal));
+}
+
+static metrics_table::index_type find_handle_metric(shard& metrics_shard, const metric_handle::id_type& id) {
+	auto& metrics_index = metrics_shard.metrics_index;
+
+	if (id >= metrics_index.size()) {
+		metrics_index.resize(id + 1, metrics_table::INVALID_INDEX);
+	}
+
+	auto& metric_index = metrics_index[id];
+	if (metric_index == metrics_table::INVALID_INDEX) {
+		metric_index = metrics_shard.metrics_map.insert(registry::name(id));
+	}
+
+	return metric_index;
+}
+
+static metrics_table::index_type find_metric(shard& metrics_shard, const events::event_message& message) {
+	if (message.destination_literal) {
+		return find_literal_metric(metrics_shard, message);
+	}
+
+	if (message.destination_name_ref) {
+		return metrics_shard.metrics_map.insert(
+				message.destination_name_ref,
+				message.destination_name_ref_length,
+				metrics_table::hash(message.destination_name_ref, message.destination_name_ref_length)
+			);
+	}
+
+	if (message.destination_id == metric_handle::INVALID_ID) {
+		return metrics_shard.metrics_map.insert(message.destination_name);
+	}
+
+	return find_handle_metric(metrics_shard, message.destination_id);
+}
 
 size_t size() {
-	return metrics_map.size();
+	size_t total_size = 0;
+	for (auto shard_iter = shards.cbegin(); shard_iter != shards.cend(); ++shard_iter) {
+		total_size += (*shard_iter)->size.load(std::memory_order_relaxed);
+	}
+	return total_size;
 }
 
-void update_metrics(const chrono::time_point& timestamp) {
+void update_metrics(shard& metrics_shard, const chrono::time_point& timestamp) {
+	auto& metrics_map = metrics_shard.metrics_map;
 	for (auto metric_iter = metrics_map.begin(); metric_iter != metrics_map.end(); ++metric_iter) {
 		switch (metric_iter->second.which()) {
 			case metrics::metric_index::GAUGE:
@@ -105,37 +193,59 @@ void process_event_message(metrics::metric_ptr_variant& metric_ptr, const events
 	}
 }
 
-void process_event_message(const events::event_message& message) {
-	auto process_start_time = chrono::tsc_clock::now();
-
-	auto& metric_ptr = metrics_map[message.destination_name];
-
-	bool empty_metric = false;
-
+static bool is_empty_metric(const metrics::metric_ptr_variant& metric_ptr) {
 	switch (metric_ptr.which()) {
 		case metrics::metric_index::COUNTER:
-			if (boost::get<metrics::counter*>(metric_ptr) == 0) {
-				empty_metric = true;
-			}
-			break;
+			return boost::get<metrics::counter*>(metric_ptr) == 0;
 		case metrics::metric_index::GAUGE:
-			if (boost::get<metrics::gauge*>(metric_ptr) == 0) {
-				empty_metric = true;
-			}
-			break;
+			return boost::get<metrics::gauge*>(metric_ptr) == 0;
 		case metrics::metric_index::TIMER:
-			if (boost::get<metrics::timer*>(metric_ptr) == 0) {
-				empty_metric = true;
-			}
-			break;
+			return boost::get<metrics::timer*>(metric_ptr) == 0;
 		case metrics::metric_index::ATTRIBUTE:
-			if (boost::get<metrics::attribute*>(metric_ptr) == 0) {
-				empty_metric = true;
+			return boost::get<metrics::attribute*>(metric_ptr) == 0;
+	}
+
+	return false;
+}
+
+static shard::set_order& find_set_order(shard& metrics_shard, const metrics_table::index_type& index) {
+	auto& set_orders = metrics_shard.set_orders;
+	if (index >= set_orders.size()) {
+		set_orders.resize(index + 1, shard::set_order{metric_handle::INVALID_ID, chrono::time_point()});
+	}
+	return set_orders[index];
+}
+
+// Queued sets of metrics with handle slots are skipped if the slot's set with later timestamp is already applied
+static bool is_ordered_set(shard& metrics_shard, const metrics_table::index_type& index, const events::event_message& message) {
+	switch (message.destination_type) {
+		case events::event_destination_type::GAUGE:
+			if (!gauge_slots::enabled() ||
+					(message.event_type != events::gauge::event_type::INIT && message.event_type != events::gauge::event_type::SET))
+			{
+				return true;
 			}
 			break;
+		case events::event_destination_type::ATTRIBUTE:
+			break;
+		default:
+			return true;
+	}
+
+	shard::set_order& order = find_set_order(metrics_shard, index);
+	if (order.slot_id != metric_handle::INVALID_ID && message.timestamp < order.timestamp) {
+		return false;
 	}
 
-	if (empty_metric) {
+	order.timestamp = std::max(order.timestamp, message.timestamp);
+	return true;
+}
+
+static void process_message(shard& metrics_shard, const events::event_message& message) {
+	const auto index = find_metric(metrics_shard, message);
+	auto& metric_ptr = metrics_shard.metrics_map.at(index).second;
+
+	if (is_empty_metric(metric_ptr)) {
 		switch (message.destination_type) {
 			case events::event_destination_type::COUNTER:
 				metric_ptr = new metrics::counter(config::metrics::counter_opts);
@@ -152,12 +262,71 @@ void process_event_message(const events::event_message& message) {
 		}
 	}
 
+	if (!is_ordered_set(metrics_shard, index, message)) {
+		return;
+	}
+
 	process_event_message(metric_ptr, message);
+}
+
+void process_event_message(const events::event_message& message) {
+	const events::event_message* messages[] = { &message };
+	process_event_messages(*shards.front(), messages, 1);
+}
+
+// Inline mode: producers in process_inline() are counted, so that finalize() waits for them
+static std::atomic<bool> inline_accepting(false);
+static std::atomic<size_t> inline_producers(0);
+
+bool process_inline(const events::event_message& message) {
+	inline_producers.fetch_add(1, std::memory_order_seq_cst);
+
+	const bool accepted = inline_accepting.load(std::memory_order_seq_cst);
+	if (accepted) {
+		shard& metrics_shard = *shards[message_queue::shard_of(message)];
+		const events::event_message* messages[] = { &message };
+
+		std::lock_guard<std::mutex> lock(metrics_shard.lock);
+		process_event_messages(metrics_shard, messages, 1);
+	}
+
+	inline_producers.fetch_sub(1, std::memory_order_release);
+
+	return accepted;
+}
+
+void process_event_messages(shard& metrics_shard, const events::event_message* const* messages, const size_t& count) {
+	if (count == 0) {
+		return;
+	}
+
+	auto process_start_time = chrono::tsc_clock::now();
+
+	for (size_t index = 0; index < count; ++index) {
+		const events::event_message& message = *messages[index];
+
+		if (!self_stats::processed(metrics_shard.index, message.destination_type, message.event_type)) {
+			process_message(metrics_shard, message);
+			continue;
+		}
+
+		const auto message_start_time = chrono::tsc_clock::now();
+		process_message(metrics_shard, message);
+		self_stats::process_time(metrics_shard.index, message.destination_type, chrono::tsc_clock::now() - message_start_time);
+	}
 
 	auto process_end_time = chrono::tsc_clock::now();
 
+	metrics_shard.size.store(metrics_shard.metrics_map.size(), std::memory_order_relaxed);
+
+	// self-statistics are owned by the first shard's processor
+	if (metrics_shard.index != 0) {
+		return;
+	}
+
+	// self-statistics are updated once per batch, process_time is the average per message
 	stats::process_time.set(
-			chrono::duration::convert_to(metrics::timer::value_unit, process_end_time - process_start_time).count(),
+			chrono::duration::convert_to(metrics::timer::value_unit, process_end_time - process_start_time).count() / double(count),
 			process_end_time
 		);
 
@@ -165,11 +334,100 @@ void process_event_message(const events::event_message& message) {
 }
 
 
-void initialize() {
+// Slot's set is skipped if queued set with later timestamp is already applied
+static bool is_ordered_slot_set(
+		shard& metrics_shard,
+		const metrics_table::index_type& index,
+		const metric_handle::id_type& id,
+		const chrono::time_point& timestamp
+	)
+{
+	shard::set_order& order = find_set_order(metrics_shard, index);
+	order.slot_id = id;
+	if (timestamp < order.timestamp) {
+		return false;
+	}
+
+	order.timestamp = timestamp;
+	return true;
+}
+
+static void apply_gauge_set(
+		const size_t& shard_index,
+		const metric_handle::id_type& id,
+		const metrics::gauge::value_type& value,
+		const chrono::time_point& timestamp
+	)
+{
+	shard& metrics_shard = *shards[shard_index];
+	const auto index = find_handle_metric(metrics_shard, id);
+	auto& metric_ptr = metrics_shard.metrics_map.at(index).second;
+
+	if (!is_ordered_slot_set(metrics_shard, index, id, timestamp)) {
+		return;
+	}
+
+	if (is_empty_metric(metric_ptr)) {
+		metric_ptr = new metrics::gauge(config::metrics::gauge_opts);
+	}
+
+	if (metric_ptr.which() != metrics::metric_index::GAUGE) {
+		// metric of other type
+		return;
+	}
+
+	boost::get<metrics::gauge*>(metric_ptr)->set(value, timestamp);
+	self_stats::processed(shard_index, events::event_destination_type::GAUGE, events::gauge::event_type::SET);
+}
+
+static void apply_attribute_set(
+		const size_t& shard_index,
+		const metric_handle::id_type& id,
+		const metrics::attribute::value_type& value,
+		const chrono::time_point& timestamp
+	)
+{
+	shard& metrics_shard = *shards[shard_index];
+	const auto index = find_handle_metric(metrics_shard, id);
+	auto& metric_ptr = metrics_shard.metrics_map.at(index).second;
+
+	if (!is_ordered_slot_set(metrics_shard, index, id, timestamp)) {
+		return;
+	}
+
+	if (is_empty_metric(metric_ptr)) {
+		metric_ptr = new metrics::attribute();
+	}
+
+	if (metric_ptr.which() != metrics::metric_index::ATTRIBUTE) {
+		// metric of other type
+		return;
+	}
+
+	boost::get<metrics::attribute*>(metric_ptr)->set(value);
+	// attribute event types follow value indices
+	self_stats::processed(shard_index, events::event_destination_type::ATTRIBUTE, char(value.which()));
+}
+
+void apply_slots(shard& metrics_shard) {
+	gauge_slots::collect(metrics_shard.index, apply_gauge_set);
+	attribute_slots::collect(metrics_shard.index, apply_attribute_set);
+
+	metrics_shard.size.store(metrics_shard.metrics_map.size(), std::memory_order_relaxed);
+}
+
+void initialize(const size_t& shards_count) {
+	for (size_t index = 0; index < shards_count; ++index) {
+		shards.push_back(new shard(index));
+	}
+
 	stats::initialize();
+
+	inline_accepting.store(config::core_opts.mode == config::core::INLINE, std::memory_order_seq_cst);
 }
 
-void finalize() {
+static void clear(shard& metrics_shard) {
+	auto& metrics_map = metrics_shard.metrics_map;
 	for (auto metric_iter = metrics_map.begin(); metric_iter != metrics_map.end(); ++metric_iter) {
 		switch (metric_iter->second.which()) {
 			case metrics::metric_index::COUNTER:
@@ -190,6 +448,20 @@ void finalize() {
 	}
 
 	metrics_map.clear();
+	metrics_shard.set_orders.clear();
+}
+
+void finalize() {
+	inline_accepting.store(false, std::memory_order_seq_cst);
+	while (inline_producers.load(std::memory_order_acquire) > 0) {
+		std::this_thread::yield();
+	}
+
+	for (auto shard_iter = shards.begin(); shard_iter != shards.end(); ++shard_iter) {
+		clear(**shard_iter);
+		delete *shard_iter;
+	}
+	shards.clear();
 
 	stats::finalize();
 }
@@ -3,12 +3,20 @@
 #ifndef HANDYSTATS_INTERNAL_IMPL_HPP_
 #define HANDYSTATS_INTERNAL_IMPL_HPP_
 
-#include <map>
 #include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <handystats/atomic.hpp>
 
+#include <handystats/chrono.hpp>
+#include <handystats/metric_handle.hpp>
 #include <handystats/metrics.hpp>
 #include <handystats/metrics/gauge.hpp>
 
+#include "metrics_table_impl.hpp"
+
 
 namespace handystats { namespace events {
 
@@ -19,15 +27,69 @@ struct event_message;
 
 namespace handystats { namespace internal {
 
-extern std::map<std::string, metrics::metric_ptr_variant> metrics_map;
+/*
+ * Partition of metrics owned by a single processor thread.
+ * Metrics are assigned to shards by name hash (see message_queue::shard_of).
+ */
+struct shard {
+	struct literal_entry {
+		const char* literal;
+		metrics_table::index_type index;
+	};
+
+	// sets through handle slots bypass the message queue,
+	// so latest timestamp wins between them and queued sets of the same metric
+	struct set_order {
+		// handle id of the metric's slot, INVALID_ID until the slot is first applied
+		metric_handle::id_type slot_id;
+		chrono::time_point timestamp;
+	};
+
+	shard(const size_t& index);
+
+	size_t index;
+
+	metrics_table metrics_map;
+	// metrics_map entries indexed by metric handle id
+	std::vector<metrics_table::index_type> metrics_index;
+	// metrics_map entries indexed by hash of metric name literal
+	std::unordered_map<uint64_t, literal_entry> metrics_literals;
+	// last sets of gauges and attributes indexed as metrics_map entries
+	std::vector<set_order> set_orders;
+
+	// number of metrics, published for other threads
+	std::atomic<size_t> size;
 
-void update_metrics(const chrono::time_point&);
+	// metrics copy made by the shard's processor on dump request (see metrics_dump)
+	std::map<std::string, metrics::metric_variant> snapshot;
+	std::atomic<uint64_t> snapshot_epoch;
 
+	// guards the shard in inline mode, where events are processed by producers
+	std::mutex lock;
+};
+
+extern std::vector<shard*> shards;
+
+void update_metrics(shard&, const chrono::time_point&);
+
+// Processes message in the first shard
 void process_event_message(const events::event_message&);
 
+// Processes batch of messages in order, self-statistics are updated once per batch
+void process_event_messages(shard&, const events::event_message* const* messages, const size_t& count);
+
+// Inline mode: processes message in its shard under the shard's lock,
+// returns false if metrics are not initialized
+bool process_inline(const events::event_message&);
+
+// Applies gauge and attribute sets of the shard made through slots
+// (see gauge_slots_impl.hpp and attribute_slots_impl.hpp)
+void apply_slots(shard&);
+
+// Total number of metrics in all shards
 size_t size();
 
-void initialize();
+void initialize(const size_t& shards_count = 1);
 void finalize();
 
 
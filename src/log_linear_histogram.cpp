@@ -0,0 +1,254 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include <handystats/log_linear_histogram.hpp>
+
+#include "quantiles_sweep_impl.hpp"
+
+namespace handystats {
+
+const size_t log_linear_histogram::MIN_SIGNIFICANT_DIGITS;
+const size_t log_linear_histogram::MAX_SIGNIFICANT_DIGITS;
+
+// IEEE 754 double's mantissa bits
+static const size_t MANTISSA_BITS = 52;
+
+log_linear_histogram::log_linear_histogram(const size_t& significant_digits)
+	: m_significant_digits(
+			std::min(std::max(significant_digits, MIN_SIGNIFICANT_DIGITS), MAX_SIGNIFICANT_DIGITS)
+		)
+	, m_bucket_bits(0)
+{
+	uint64_t buckets = 1;
+	for (size_t digit = 0; digit < m_significant_digits; ++digit) {
+		buckets *= 10;
+	}
+	while ((uint64_t(1) << m_bucket_bits) < buckets) {
+		++m_bucket_bits;
+	}
+
+	reset();
+}
+
+void log_linear_histogram::reset() {
+	m_buckets.reset();
+}
+
+// Power of two range is allocated on its first bucket's access
+double& log_linear_histogram::bucket_range::at(const uint64_t& key, const size_t& bucket_bits) {
+	const uint64_t range_mask = (uint64_t(1) << bucket_bits) - 1;
+	const uint64_t first_key = key & ~range_mask;
+
+	// values mostly fall into the recent ranges, the highest one is checked first
+	auto page_iter = pages.end();
+	if (pages.empty() || pages.back().first_key < first_key) {
+		page_iter = pages.insert(pages.end(), bucket_page{first_key, std::vector<double>()});
+		page_iter->counts.assign(range_mask + 1, 0.0);
+	}
+	else if (pages.back().first_key == first_key) {
+		page_iter = pages.end() - 1;
+	}
+	else {
+		page_iter = std::lower_bound(pages.begin(), pages.end(), first_key,
+				[] (const bucket_page& page, const uint64_t& page_key) {
+					return page.first_key < page_key;
+				}
+			);
+		if (page_iter->first_key != first_key) {
+			page_iter = pages.insert(page_iter, bucket_page{first_key, std::vector<double>()});
+			page_iter->counts.assign(range_mask + 1, 0.0);
+		}
+	}
+
+	return page_iter->counts[key - first_key];
+}
+
+void log_linear_histogram::bucket_range::clear() {
+	pages.clear();
+}
+
+double log_linear_histogram::bucket_range::total() const {
+	double total = 0;
+	for (auto page = pages.cbegin(); page != pages.cend(); ++page) {
+		for (auto iter = page->counts.cbegin(); iter != page->counts.cend(); ++iter) {
+			total += *iter;
+		}
+	}
+	return total;
+}
+
+void log_linear_histogram::bucket_range::divide(const double& divisor) {
+	for (auto& page : pages) {
+		for (auto& count : page.counts) {
+			count /= divisor;
+		}
+	}
+}
+
+uint64_t log_linear_histogram::key(const double& value) const {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits >> (MANTISSA_BITS - m_bucket_bits);
+}
+
+double log_linear_histogram::lower_bound(const uint64_t& key) const {
+	const uint64_t bits = key << (MANTISSA_BITS - m_bucket_bits);
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void log_linear_histogram::add(const double& value, const double& count) {
+	if (value > 0) {
+		m_buckets.positive.at(key(value), m_bucket_bits) += m_buckets.stored(count);
+	}
+	else if (value < 0) {
+		m_buckets.negative.at(key(-value), m_bucket_bits) += m_buckets.stored(count);
+	}
+	else if (value == 0) {
+		m_buckets.zero += m_buckets.stored(count);
+	}
+	// NaN is skipped
+}
+
+void log_linear_histogram::scale(const double& factor) {
+	m_buckets.scale(factor);
+}
+
+void log_linear_histogram::merge(const log_linear_histogram& other) {
+	if (other.m_bucket_bits == m_bucket_bits) {
+		merge_range(m_buckets.positive, other.m_buckets.positive, other);
+		merge_range(m_buckets.negative, other.m_buckets.negative, other);
+		m_buckets.zero += m_buckets.stored(other.m_buckets.zero, other.m_buckets);
+		return;
+	}
+
+	const std::vector<bucket>& other_buckets = other.buckets();
+	for (auto iter = other_buckets.cbegin(); iter != other_buckets.cend(); ++iter) {
+		add(iter->lower + (iter->upper - iter->lower) / 2, iter->count);
+	}
+}
+
+void log_linear_histogram::merge_range(
+		bucket_range& range, const bucket_range& other,
+		const log_linear_histogram& other_histogram
+	)
+{
+	for (auto page = other.pages.cbegin(); page != other.pages.cend(); ++page) {
+		for (size_t index = 0; index < page->counts.size(); ++index) {
+			if (page->counts[index] > 0) {
+				range.at(page->first_key + index, m_bucket_bits) +=
+					m_buckets.stored(page->counts[index], other_histogram.m_buckets);
+			}
+		}
+	}
+}
+
+void log_linear_histogram::append_buckets(
+		const bucket_range& range, const bool& negative,
+		std::vector<bucket>& result
+	) const
+{
+	for (size_t page_index = 0; page_index < range.pages.size(); ++page_index) {
+		// negative buckets are walked from the highest key (the lowest value)
+		const bucket_page& page = range.pages[negative ? range.pages.size() - 1 - page_index : page_index];
+		for (size_t index = 0; index < page.counts.size(); ++index) {
+			const size_t offset = negative ? page.counts.size() - 1 - index : index;
+			const double& count = page.counts[offset];
+			if (count <= 0) {
+				continue;
+			}
+
+			const uint64_t& bucket_key = page.first_key + offset;
+			if (negative) {
+				result.push_back(bucket{-lower_bound(bucket_key + 1), -lower_bound(bucket_key), count / m_buckets.weight});
+			}
+			else {
+				result.push_back(bucket{lower_bound(bucket_key), lower_bound(bucket_key + 1), count / m_buckets.weight});
+			}
+		}
+	}
+}
+
+std::vector<log_linear_histogram::bucket> log_linear_histogram::buckets() const {
+	std::vector<bucket> result;
+
+	append_buckets(m_buckets.negative, true, result);
+	if (m_buckets.zero > 0) {
+		result.push_back(bucket{0.0, 0.0, m_buckets.zero / m_buckets.weight});
+	}
+	append_buckets(m_buckets.positive, false, result);
+
+	return result;
+}
+
+double log_linear_histogram::count() const {
+	return m_buckets.count();
+}
+
+double log_linear_histogram::quantile(const double& probability) const {
+	return quantiles(std::vector<double>(1, probability))[0];
+}
+
+std::vector<double> log_linear_histogram::quantiles(const std::vector<double>& probabilities) const {
+	std::vector<double> values(probabilities.size(), 0.0);
+
+	const double& total = m_buckets.total();
+	if (total <= 0) {
+		return values;
+	}
+
+	// value is interpolated within the bucket
+	quantiles_sweep sweep(probabilities, values, total);
+	double highest_value = 0;
+
+	for (auto page = m_buckets.negative.pages.crbegin(); page != m_buckets.negative.pages.crend(); ++page) {
+		for (size_t index = page->counts.size(); index > 0; --index) {
+			const double& count = page->counts[index - 1];
+			if (count <= 0) {
+				continue;
+			}
+			const uint64_t& bucket_key = page->first_key + index - 1;
+			const double& lower = -lower_bound(bucket_key + 1);
+			const double& upper = -lower_bound(bucket_key);
+			sweep.visit(count, [&] (const double& z) { return lower + (upper - lower) * z; });
+			highest_value = upper;
+		}
+	}
+
+	sweep.visit(m_buckets.zero, [] (const double&) { return 0.0; });
+	if (m_buckets.zero > 0) {
+		highest_value = 0;
+	}
+
+	for (auto page = m_buckets.positive.pages.cbegin(); page != m_buckets.positive.pages.cend(); ++page) {
+		for (size_t index = 0; index < page->counts.size(); ++index) {
+			const double& count = page->counts[index];
+			if (count <= 0) {
+				continue;
+			}
+			const uint64_t& bucket_key = page->first_key + index;
+			const double& lower = lower_bound(bucket_key);
+			const double& upper = lower_bound(bucket_key + 1);
+			sweep.visit(count, [&] (const double& z) { return lower + (upper - lower) * z; });
+			highest_value = upper;
+		}
+	}
+
+	sweep.finish(highest_value);
+
+	return values;
+}
+
+size_t log_linear_histogram::significant_digits() const {
+	return m_significant_digits;
+}
+
+double log_linear_histogram::relative_error() const {
+	return std::ldexp(1.0, -int(m_bucket_bits));
+}
+
+} // namespace handystats
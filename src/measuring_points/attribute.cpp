@@ -5,6 +5,7 @@
 
 #include "events/attribute_impl.hpp"
 #include "message_queue_impl.hpp"
+#include "attribute_slots_impl.hpp"
 #include "core_impl.hpp"
 
 #include <handystats/measuring_points/attribute.hpp>
@@ -144,11 +145,38 @@ void attribute_set<std::string>(
 {
 	if (handystats::is_enabled()) {
 		handystats::message_queue::push(
-				handystats::events::attribute::create_set_event(
-					std::move(attribute_name),
-					handystats::metrics::attribute::value_type(s),
-					timestamp
-				)
+				handystats::events::attribute::create_set_event(std::move(attribute_name), s, timestamp)
+			);
+	}
+}
+
+void attribute_set(
+		const handystats::metric_handle& attribute_handle,
+		const handystats::metrics::attribute::value_type& value,
+		const handystats::metrics::attribute::time_point& timestamp
+	)
+{
+	if (handystats::is_enabled()) {
+		// attributes set through handles bypass message queue
+		if (handystats::attribute_slots::set(attribute_handle, value, timestamp)) {
+			return;
+		}
+
+		handystats::message_queue::push(
+				handystats::events::attribute::create_set_event(attribute_handle, value, timestamp)
+			);
+	}
+}
+
+void attribute_set(
+		const handystats::metric_literal& attribute_literal,
+		const handystats::metrics::attribute::value_type& value,
+		const handystats::metrics::attribute::time_point& timestamp
+	)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::attribute::create_set_event(attribute_literal, value, timestamp)
 			);
 	}
 }
@@ -26,6 +26,32 @@ void counter_init(
 	}
 }
 
+void counter_init(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& init_value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::counter::create_init_event(counter_handle, init_value, timestamp)
+			);
+	}
+}
+
+void counter_init(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& init_value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::counter::create_init_event(counter_literal, init_value, timestamp)
+			);
+	}
+}
+
 void counter_increment(
 		std::string&& counter_name,
 		const handystats::metrics::counter::value_type& value,
@@ -39,6 +65,32 @@ void counter_increment(
 	}
 }
 
+void counter_increment(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::counter::create_increment_event(counter_handle, value, timestamp)
+			);
+	}
+}
+
+void counter_increment(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::counter::create_increment_event(counter_literal, value, timestamp)
+			);
+	}
+}
+
 void counter_decrement(
 		std::string&& counter_name,
 		const handystats::metrics::counter::value_type& value,
@@ -52,6 +104,32 @@ void counter_decrement(
 	}
 }
 
+void counter_decrement(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::counter::create_decrement_event(counter_handle, value, timestamp)
+			);
+	}
+}
+
+void counter_decrement(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::counter::create_decrement_event(counter_literal, value, timestamp)
+			);
+	}
+}
+
 void counter_change(
 		std::string&& counter_name,
 		const handystats::metrics::counter::value_type& value,
@@ -68,6 +146,38 @@ void counter_change(
 	}
 }
 
+void counter_change(
+		const handystats::metric_handle& counter_handle,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		if (value >= 0) {
+			HANDY_COUNTER_INCREMENT(counter_handle, value, timestamp);
+		}
+		else {
+			HANDY_COUNTER_DECREMENT(counter_handle, -value, timestamp);
+		}
+	}
+}
+
+void counter_change(
+		const handystats::metric_literal& counter_literal,
+		const handystats::metrics::counter::value_type& value,
+		const handystats::metrics::counter::time_point& timestamp
+		)
+{
+	if (handystats::is_enabled()) {
+		if (value >= 0) {
+			HANDY_COUNTER_INCREMENT(counter_literal, value, timestamp);
+		}
+		else {
+			HANDY_COUNTER_DECREMENT(counter_literal, -value, timestamp);
+		}
+	}
+}
+
 }} // namespace handystats::measuring_points
 
 
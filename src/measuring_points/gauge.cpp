@@ -5,6 +5,7 @@
 
 #include "events/gauge_impl.hpp"
 #include "message_queue_impl.hpp"
+#include "gauge_slots_impl.hpp"
 #include "core_impl.hpp"
 
 #include <handystats/measuring_points/gauge.hpp>
@@ -26,6 +27,37 @@ void gauge_init(
 	}
 }
 
+void gauge_init(
+		const handystats::metric_handle& gauge_handle,
+		const handystats::metrics::gauge::value_type& init_value,
+		const handystats::metrics::gauge::time_point& timestamp
+	)
+{
+	if (handystats::is_enabled()) {
+		// last-value gauges bypass message queue
+		if (handystats::gauge_slots::set(gauge_handle, init_value, timestamp)) {
+			return;
+		}
+
+		handystats::message_queue::push(
+				handystats::events::gauge::create_init_event(gauge_handle, init_value, timestamp)
+			);
+	}
+}
+
+void gauge_init(
+		const handystats::metric_literal& gauge_literal,
+		const handystats::metrics::gauge::value_type& init_value,
+		const handystats::metrics::gauge::time_point& timestamp
+	)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::gauge::create_init_event(gauge_literal, init_value, timestamp)
+			);
+	}
+}
+
 void gauge_set(
 		std::string&& gauge_name,
 		const handystats::metrics::gauge::value_type& value,
@@ -39,6 +71,37 @@ void gauge_set(
 	}
 }
 
+void gauge_set(
+		const handystats::metric_handle& gauge_handle,
+		const handystats::metrics::gauge::value_type& value,
+		const handystats::metrics::gauge::time_point& timestamp
+	)
+{
+	if (handystats::is_enabled()) {
+		// last-value gauges bypass message queue
+		if (handystats::gauge_slots::set(gauge_handle, value, timestamp)) {
+			return;
+		}
+
+		handystats::message_queue::push(
+				handystats::events::gauge::create_set_event(gauge_handle, value, timestamp)
+			);
+	}
+}
+
+void gauge_set(
+		const handystats::metric_literal& gauge_literal,
+		const handystats::metrics::gauge::value_type& value,
+		const handystats::metrics::gauge::time_point& timestamp
+	)
+{
+	if (handystats::is_enabled()) {
+		handystats::message_queue::push(
+				handystats::events::gauge::create_set_event(gauge_literal, value, timestamp)
+			);
+	}
+}
+
 }} // namespace handystats::measuring_points
 
 
@@ -0,0 +1,18 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include "registry_impl.hpp"
+#include "metrics_table_impl.hpp"
+
+#include <handystats/metric_handle.hpp>
+
+
+namespace handystats { namespace measuring_points {
+
+metric_handle resolve_handle(const std::string& metric_name) {
+	return metric_handle(
+			registry::resolve(metric_name),
+			internal::metrics_table::hash(metric_name.data(), metric_name.size())
+		);
+}
+
+}} // namespace handystats::measuring_points
@@ -26,6 +26,32 @@ void timer_init(
 	}
 }
 
+void timer_init(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_init_event(timer_handle, instance_id, timestamp)
+			);
+	}
+}
+
+void timer_init(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_init_event(timer_literal, instance_id, timestamp)
+			);
+	}
+}
+
 void timer_start(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
@@ -39,6 +65,32 @@ void timer_start(
 	}
 }
 
+void timer_start(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_start_event(timer_handle, instance_id, timestamp)
+			);
+	}
+}
+
+void timer_start(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_start_event(timer_literal, instance_id, timestamp)
+			);
+	}
+}
+
 void timer_stop(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
@@ -52,6 +104,32 @@ void timer_stop(
 	}
 }
 
+void timer_stop(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_stop_event(timer_handle, instance_id, timestamp)
+			);
+	}
+}
+
+void timer_stop(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_stop_event(timer_literal, instance_id, timestamp)
+			);
+	}
+}
+
 void timer_discard(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
@@ -65,6 +143,32 @@ void timer_discard(
 	}
 }
 
+void timer_discard(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_discard_event(timer_handle, instance_id, timestamp)
+			);
+	}
+}
+
+void timer_discard(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_discard_event(timer_literal, instance_id, timestamp)
+			);
+	}
+}
+
 void timer_heartbeat(
 		std::string&& timer_name,
 		const metrics::timer::instance_id_type& instance_id,
@@ -78,6 +182,32 @@ void timer_heartbeat(
 	}
 }
 
+void timer_heartbeat(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_heartbeat_event(timer_handle, instance_id, timestamp)
+			);
+	}
+}
+
+void timer_heartbeat(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::instance_id_type& instance_id,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_heartbeat_event(timer_literal, instance_id, timestamp)
+			);
+	}
+}
+
 void timer_set(
 		std::string&& timer_name,
 		const metrics::timer::value_type& measurement,
@@ -91,6 +221,32 @@ void timer_set(
 	}
 }
 
+void timer_set(
+		const handystats::metric_handle& timer_handle,
+		const metrics::timer::value_type& measurement,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_set_event(timer_handle, measurement, timestamp)
+			);
+	}
+}
+
+void timer_set(
+		const handystats::metric_literal& timer_literal,
+		const metrics::timer::value_type& measurement,
+		const metrics::timer::time_point& timestamp
+	)
+{
+	if (is_enabled()) {
+		message_queue::push(
+				events::timer::create_set_event(timer_literal, measurement, timestamp)
+			);
+	}
+}
+
 }} // namespace measuring_points
 
 namespace {
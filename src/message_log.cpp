@@ -0,0 +1,476 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <handystats/atomic.hpp>
+#include <cstring>
+#include <memory>
+#include <pthread.h>
+
+#include <handystats/chrono.hpp>
+#include <handystats/metric_handle.hpp>
+
+#include "events/event_message_impl.hpp"
+#include "events/attribute_impl.hpp"
+#include "config_impl.hpp"
+
+#include "message_log_impl.hpp"
+
+namespace {
+
+using handystats::events::event_message;
+
+/*
+ * Record layout: header, destination name (if referenced by name), string attribute value.
+ * Records are aligned to 8 bytes and never cross the end of the log,
+ * the tail of the log is filled with padding record instead.
+ */
+struct __record_header
+{
+	static const uint32_t PADDING = uint32_t(-1);
+
+	// whole record size in bytes
+	uint32_t size;
+	// length of destination name following the header, PADDING for padding record
+	uint32_t name_length;
+	// length of string attribute value following the name
+	uint32_t string_length;
+
+	char destination_type;
+	char event_type;
+
+	handystats::metric_handle::id_type destination_id;
+	const char* destination_literal;
+	uint64_t destination_hash;
+
+	handystats::chrono::time_point timestamp;
+
+	// event data as is, scalar values are stored inline
+	void* event_data;
+};
+
+static const size_t RECORD_ALIGNMENT = 8;
+
+size_t align(const size_t& size) {
+	return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+bool has_string(const event_message& message) {
+	return message.destination_type == handystats::events::event_destination_type::ATTRIBUTE &&
+		message.event_type == handystats::events::attribute::event_type::SET_STRING;
+}
+
+size_t name_length(const event_message& message) {
+	if (message.destination_literal || message.destination_id != handystats::metric_handle::INVALID_ID) {
+		return 0;
+	}
+	return message.destination_name.size();
+}
+
+size_t string_length(const event_message& message) {
+	return has_string(message) ? message.event_string.size() : 0;
+}
+
+size_t record_size(const event_message& message) {
+	return align(sizeof(__record_header) + name_length(message) + string_length(message));
+}
+
+/*
+ * Single-producer single-consumer byte ring of records.
+ * Head and tail are monotonic byte offsets.
+ */
+struct __producer_log
+{
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	enum state_type {
+		// owned by alive producer thread
+		ACTIVE,
+		// producer thread has exited, records are yet to be read
+		CLOSED,
+		// drained log of exited thread, could be adopted by new thread
+		FREE
+	};
+
+	__producer_log(size_t capacity)
+		: m_buffer()
+		, m_capacity()
+		, m_head(0)
+		, m_cached_tail(0)
+		, m_written(0)
+		, m_reserved(0)
+		, m_tail(0)
+		, m_position(0)
+		, m_cached_head(0)
+		, m_cached_written(0)
+		, m_read(0)
+		, m_pending(0)
+		, m_state(ACTIVE)
+		, m_next(nullptr)
+	{
+		m_capacity = log_size(capacity);
+		m_buffer.reset(new uint64_t[m_capacity / sizeof(uint64_t)]);
+	}
+
+	static size_t log_size(const size_t& capacity) {
+		size_t size = 4096;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		return size;
+	}
+
+	char* at(const size_t& offset) const {
+		return reinterpret_cast<char*>(m_buffer.get()) + (offset & (m_capacity - 1));
+	}
+
+	// producer side
+	size_t padding(const size_t& size) const {
+		const size_t position = m_head.load(std::memory_order_relaxed) & (m_capacity - 1);
+		return position + size > m_capacity ? m_capacity - position : 0;
+	}
+
+	// producer side: space the next record takes, including padding
+	size_t reserve(const size_t& size) {
+		m_reserved = padding(size) + size;
+		return m_reserved;
+	}
+
+	// producer side
+	// cached tail is refreshed only when log looks half full or the next record doesn't fit,
+	// so that consumer's cache line is not touched on each push
+	size_t used() {
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_cached_tail >= m_capacity / 2 || head - m_cached_tail + m_reserved > m_capacity) {
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+		}
+		return head - m_cached_tail;
+	}
+
+	// producer side
+	bool write(const event_message& message) {
+		const size_t size = record_size(message);
+		const size_t pad = padding(size);
+
+		size_t head = m_head.load(std::memory_order_relaxed);
+
+		if (head + pad + size - m_cached_tail > m_capacity) {
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+			if (head + pad + size - m_cached_tail > m_capacity) {
+				return false;
+			}
+		}
+
+		if (pad > 0) {
+			__record_header* padding_header = reinterpret_cast<__record_header*>(at(head));
+			padding_header->size = pad;
+			padding_header->name_length = __record_header::PADDING;
+			head += pad;
+		}
+
+		char* record = at(head);
+		__record_header* header = reinterpret_cast<__record_header*>(record);
+
+		header->size = size;
+		header->name_length = name_length(message);
+		header->string_length = string_length(message);
+		header->destination_type = message.destination_type;
+		header->event_type = message.event_type;
+		header->destination_id = message.destination_id;
+		header->destination_literal = message.destination_literal;
+		header->destination_hash = message.destination_hash;
+		header->timestamp = message.timestamp;
+		header->event_data = message.event_data;
+
+		char* data = record + sizeof(__record_header);
+		if (header->name_length > 0) {
+			memcpy(data, message.destination_name.data(), header->name_length);
+			data += header->name_length;
+		}
+
+		if (header->string_length > 0) {
+			memcpy(data, message.event_string.data(), header->string_length);
+		}
+
+		m_written.store(m_written.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		m_head.store(head + size, std::memory_order_release);
+
+		return true;
+	}
+
+	// consumer side: returns next record or nullptr, skips padding
+	const __record_header* peek() {
+		while (true) {
+			if (m_position == m_cached_head) {
+				m_cached_head = m_head.load(std::memory_order_acquire);
+				// written counter is updated before head, so it covers all records up to cached head
+				m_cached_written = m_written.load(std::memory_order_relaxed);
+				if (m_position == m_cached_head) {
+					return nullptr;
+				}
+			}
+
+			const __record_header* header = reinterpret_cast<const __record_header*>(at(m_position));
+			if (header->name_length != __record_header::PADDING) {
+				return header;
+			}
+
+			m_position += header->size;
+		}
+	}
+
+	// consumer side: record stays in the log until release()
+	void consume(const __record_header* header) {
+		m_position += header->size;
+		m_read.store(m_read.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	// consumer side: gives space of consumed records back to the producer
+	void release() {
+		if (m_tail.load(std::memory_order_relaxed) != m_position) {
+			m_tail.store(m_position, std::memory_order_release);
+		}
+	}
+
+	size_t size() const {
+		return m_written.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed);
+	}
+
+	std::unique_ptr<uint64_t[]> m_buffer;
+	size_t m_capacity;
+
+	char m_pad0[CACHE_LINE_SIZE];
+
+	// written by producer
+	std::atomic<size_t> m_head;
+	size_t m_cached_tail;
+	std::atomic<size_t> m_written;
+	// space of the record being pushed, so that used() refreshes cached tail when it doesn't fit
+	size_t m_reserved;
+
+	char m_pad1[CACHE_LINE_SIZE];
+
+	// written by consumer
+	std::atomic<size_t> m_tail;
+	// offset of the next record to read, records before it are being processed until release()
+	size_t m_position;
+	size_t m_cached_head;
+	size_t m_cached_written;
+	std::atomic<size_t> m_read;
+	// records seen but not yet read, accounted in logs_pending
+	size_t m_pending;
+
+	char m_pad2[CACHE_LINE_SIZE];
+
+	std::atomic<int> m_state;
+	__producer_log* m_next;
+};
+
+// List of registered producer logs.
+// New logs are pushed to the front by producers, logs are never unlinked:
+// drained log of exited thread is adopted by the next new thread
+// (as event message pools are), so that its pages are already mapped.
+std::atomic<__producer_log*> producer_logs(nullptr);
+
+// Consumer-side round-robin position
+__producer_log* log_cursor = nullptr;
+
+// Consumer-side estimate of records left in logs, as of the last read
+size_t logs_pending = 0;
+
+__thread __producer_log* thread_log = nullptr;
+
+pthread_key_t log_key;
+pthread_once_t log_key_once = PTHREAD_ONCE_INIT;
+
+// closed log is adopted by another thread, later destructors of the exiting thread get a log of their own
+void close_thread_log(void* log) {
+	thread_log = nullptr;
+	static_cast<__producer_log*>(log)->m_state.store(__producer_log::CLOSED, std::memory_order_release);
+}
+
+void create_log_key() {
+	pthread_key_create(&log_key, close_thread_log);
+}
+
+__producer_log* get_thread_log() {
+	if (thread_log) {
+		return thread_log;
+	}
+
+	const size_t capacity = __producer_log::log_size(handystats::config::message_queue_opts.log_capacity);
+
+	__producer_log* log = nullptr;
+
+	for (__producer_log* iter = producer_logs.load(std::memory_order_acquire); iter; iter = iter->m_next) {
+		int state = __producer_log::FREE;
+		if (iter->m_capacity == capacity &&
+				iter->m_state.load(std::memory_order_relaxed) == __producer_log::FREE &&
+				iter->m_state.compare_exchange_strong(state, __producer_log::ACTIVE, std::memory_order_acq_rel))
+		{
+			log = iter;
+			break;
+		}
+	}
+
+	if (!log) {
+		log = new __producer_log(capacity);
+
+		log->m_next = producer_logs.load(std::memory_order_acquire);
+		while (!producer_logs.compare_exchange_weak(log->m_next, log, std::memory_order_acq_rel)) {
+		}
+	}
+
+	pthread_once(&log_key_once, create_log_key);
+	pthread_setspecific(log_key, log);
+
+	thread_log = log;
+	return log;
+}
+
+// Consumer side: frees fully drained logs of exited threads for adoption.
+void collect_closed_logs() {
+	for (__producer_log* log = producer_logs.load(std::memory_order_acquire); log; log = log->m_next) {
+		if (log->m_state.load(std::memory_order_acquire) != __producer_log::CLOSED || log->size() != 0) {
+			continue;
+		}
+
+		logs_pending -= log->m_pending;
+		log->m_pending = 0;
+
+		int state = __producer_log::CLOSED;
+		log->m_state.compare_exchange_strong(state, __producer_log::FREE, std::memory_order_acq_rel);
+	}
+}
+
+// Consumer-owned messages referencing records in place, reused by every read
+std::unique_ptr<event_message[]> decoded_messages;
+size_t decoded_capacity = 0;
+
+void decode(const __record_header& header, event_message& message) {
+	message.destination_type = header.destination_type;
+	message.event_type = header.event_type;
+	message.destination_id = header.destination_id;
+	message.destination_literal = header.destination_literal;
+	message.destination_hash = header.destination_hash;
+	message.timestamp = header.timestamp;
+	message.event_data = header.event_data;
+	message.owner_pool = nullptr;
+
+	const char* data = reinterpret_cast<const char*>(&header) + sizeof(__record_header);
+
+	message.destination_name_ref = header.name_length > 0 ? data : nullptr;
+	message.destination_name_ref_length = header.name_length;
+	data += header.name_length;
+
+	message.event_string_ref = data;
+	message.event_string_ref_length = header.string_length;
+}
+
+} // unnamed namespace
+
+
+namespace handystats { namespace message_log {
+
+size_t required_space(const events::event_message& message) {
+	return get_thread_log()->reserve(record_size(message));
+}
+
+size_t thread_log_size() {
+	return get_thread_log()->used();
+}
+
+size_t thread_log_capacity() {
+	return get_thread_log()->m_capacity;
+}
+
+bool write(const events::event_message& message) {
+	return get_thread_log()->write(message);
+}
+
+size_t read(events::event_message** messages, const size_t& max_count) {
+	__producer_log* head = producer_logs.load(std::memory_order_acquire);
+	if (!head) {
+		return 0;
+	}
+
+	if (decoded_capacity < max_count) {
+		decoded_messages.reset(new events::event_message[max_count]);
+		decoded_capacity = max_count;
+	}
+
+	if (!log_cursor) {
+		log_cursor = head;
+	}
+
+	__producer_log* start = log_cursor;
+	bool seen_closed = false;
+	size_t count = 0;
+
+	do {
+		__producer_log* log = log_cursor;
+		log_cursor = log->m_next ? log->m_next : head;
+
+		while (count < max_count) {
+			const __record_header* header = log->peek();
+			if (!header) {
+				break;
+			}
+
+			decode(*header, decoded_messages[count]);
+			messages[count] = &decoded_messages[count];
+			++count;
+
+			log->consume(header);
+		}
+
+		const size_t pending = log->m_cached_written - log->m_read.load(std::memory_order_relaxed);
+		logs_pending += pending;
+		logs_pending -= log->m_pending;
+		log->m_pending = pending;
+
+		if (count == max_count) {
+			return count;
+		}
+
+		seen_closed |= log->m_state.load(std::memory_order_relaxed) == __producer_log::CLOSED;
+	} while (log_cursor != start);
+
+	if (seen_closed) {
+		collect_closed_logs();
+	}
+
+	return count;
+}
+
+void release() {
+	for (__producer_log* log = producer_logs.load(std::memory_order_acquire); log; log = log->m_next) {
+		log->release();
+	}
+}
+
+size_t pending() {
+	return logs_pending;
+}
+
+size_t size() {
+	size_t total_size = 0;
+	for (__producer_log* log = producer_logs.load(std::memory_order_acquire); log; log = log->m_next) {
+		total_size += log->size();
+	}
+	return total_size;
+}
+
+void finalize() {
+	// logs are kept for reuse, drained logs of exited threads are freed for adoption
+	for (__producer_log* log = producer_logs.load(std::memory_order_acquire); log; log = log->m_next) {
+		while (const __record_header* header = log->peek()) {
+			log->consume(header);
+		}
+		log->release();
+		log->m_pending = 0;
+	}
+	logs_pending = 0;
+	log_cursor = nullptr;
+	collect_closed_logs();
+}
+
+}} // namespace handystats::message_log
@@ -0,0 +1,55 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_MESSAGE_LOG_IMPL_HPP_
+#define HANDYSTATS_MESSAGE_LOG_IMPL_HPP_
+
+#include <cstddef>
+
+namespace handystats { namespace events {
+
+struct event_message;
+
+}} // namespace handystats::events
+
+/*
+ * Log-structured encoding of event messages used by "packed" message queue topology.
+ * Each producer thread appends variable-length records (header, name, payload)
+ * to its own contiguous byte ring, the processor reads records in order in place
+ * and gives the log space back once the batch is processed.
+ */
+namespace handystats { namespace message_log {
+
+// Producer side: space the message's record takes in the calling thread's log,
+// including padding if the record would cross the end of the log.
+// The space is reserved for the next write(), so that thread_log_size() is exact when the record doesn't fit.
+size_t required_space(const events::event_message& message);
+
+// Producer side: bytes used in the calling thread's log and its capacity,
+// the log is created on the first call
+size_t thread_log_size();
+size_t thread_log_capacity();
+
+// Producer side: appends the message's record to the calling thread's log,
+// returns false if the log has no room for it
+bool write(const events::event_message& message);
+
+// Consumer side: reads up to max_count records from producers' logs.
+// Messages are owned by the log and reference records' names and strings in place,
+// they stay valid until release().
+size_t read(events::event_message** messages, const size_t& max_count);
+
+// Consumer side: gives space of records read so far back to producers
+void release();
+
+// Consumer side: number of records left in logs as of the last read
+size_t pending();
+
+// Number of records in all logs
+size_t size();
+
+// Consumer side: discards all records
+void finalize();
+
+}} // namespace handystats::message_log
+
+#endif // HANDYSTATS_MESSAGE_LOG_IMPL_HPP_
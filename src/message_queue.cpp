@@ -2,11 +2,25 @@
 
 #include <handystats/atomic.hpp>
 #include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+#include <time.h>
 
 #include <handystats/chrono.hpp>
 #include <handystats/metrics/timer.hpp>
 
 #include "events/event_message_impl.hpp"
+#include "metrics_table_impl.hpp"
+#include "internal_impl.hpp"
+#include "self_stats_impl.hpp"
+#include "message_log_impl.hpp"
+#include "cpu_topology_impl.hpp"
 #include "config_impl.hpp"
 
 #include "message_queue_impl.hpp"
@@ -30,8 +44,14 @@ struct __event_message_queue
 	void push(node* n)
 	{
 		n->next.store(nullptr, std::memory_order_release);
-		node* prev = m_head_node.exchange(n, std::memory_order_acquire);
-		prev->next.store(static_cast<handystats::events::event_message*>(n), std::memory_order_release);
+		push(n, n);
+	}
+
+	// Pushes pre-linked chain of nodes (last->next is null) with a single exchange
+	void push(node* first, node* last)
+	{
+		node* prev = m_head_node.exchange(last, std::memory_order_acquire);
+		prev->next.store(static_cast<handystats::events::event_message*>(first), std::memory_order_release);
 	}
 
 	node* pop()
@@ -83,22 +103,438 @@ private:
 	node m_stub_node;
 };
 
+/*
+ * Bounded single-producer single-consumer ring.
+ * Each producer thread owns one ring, the processor thread is the only consumer.
+ * Head (producer side) and tail (consumer side) are kept on separate cache lines.
+ */
+struct __producer_ring
+{
+	typedef handystats::message_queue::node node;
+
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	__producer_ring(size_t capacity)
+		: m_buffer()
+		, m_mask()
+		, m_head(0)
+		, m_cached_tail(0)
+		, m_tail(0)
+		, m_cached_head(0)
+		, m_pending(0)
+		, m_closed(false)
+		, m_next(nullptr)
+	{
+		size_t ring_size = 1;
+		while (ring_size < capacity) {
+			ring_size <<= 1;
+		}
+
+		m_buffer.resize(ring_size, nullptr);
+		m_mask = ring_size - 1;
+	}
+
+	// producer side
+	bool push(node* n)
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+
+		if (head - m_cached_tail > m_mask) {
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+			if (head - m_cached_tail > m_mask) {
+				return false;
+			}
+		}
+
+		m_buffer[head & m_mask] = n;
+		m_head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// consumer side
+	node* pop()
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		if (tail == m_cached_head) {
+			m_cached_head = m_head.load(std::memory_order_acquire);
+			if (tail == m_cached_head) {
+				return nullptr;
+			}
+		}
+
+		node* n = m_buffer[tail & m_mask];
+		m_tail.store(tail + 1, std::memory_order_release);
+
+		return n;
+	}
+
+	size_t size() const
+	{
+		return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+	}
+
+	// producer side
+	size_t producer_size() const
+	{
+		return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+	std::vector<node*> m_buffer;
+	size_t m_mask;
+
+	char m_pad0[CACHE_LINE_SIZE];
+
+	// written by producer
+	std::atomic<size_t> m_head;
+	size_t m_cached_tail;
+
+	char m_pad1[CACHE_LINE_SIZE];
+
+	// written by consumer
+	std::atomic<size_t> m_tail;
+	size_t m_cached_head;
+	// number of messages in the ring as last seen by consumer
+	size_t m_pending;
+
+	char m_pad2[CACHE_LINE_SIZE];
+
+	// set on producer thread exit
+	std::atomic<bool> m_closed;
+	__producer_ring* m_next;
+};
+
+/*
+ * Inbound queue of a processor shard with its consumer's parking state.
+ */
+struct __shard_queue
+{
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	__shard_queue()
+		: queue()
+		, size(0)
+		, consumer_parked(0)
+	{}
+
+	__event_message_queue queue;
+
+	char m_pad0[CACHE_LINE_SIZE];
+
+	std::atomic<size_t> size;
+	// Non-zero while the consumer is parked (or about to park) in wait().
+	// Paired Dekker-style with producers' publish (see notify_consumer):
+	// consumer sets it and then checks the queue, producer publishes and then checks it.
+	std::atomic<int> consumer_parked;
+
+	char m_pad1[CACHE_LINE_SIZE];
+};
+
+/*
+ * Queue of events pushed by threads running on a CPU.
+ * Thread keeps pushing into the queue of its previous CPU after migration until that queue is drained,
+ * so that thread's events aren't reordered between queues.
+ */
+struct __cpu_queue
+{
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	__cpu_queue()
+		: queue()
+		, size(0)
+	{}
+
+	__event_message_queue queue;
+
+	char m_pad0[CACHE_LINE_SIZE];
+
+	std::atomic<size_t> size;
+
+	char m_pad1[CACHE_LINE_SIZE];
+};
+
+// Per-CPU queues are allocated on first initialization with per-cpu topology and are never freed.
+std::atomic<__cpu_queue*> cpu_queues(nullptr);
+size_t cpu_queues_count = 0;
+
+// Consumer-side sweep over per-CPU queues, each sweep starts from the queues of the consumer's NUMA node
+size_t sweep_start = 0;
+size_t sweep_position = 0;
+
+__thread __cpu_queue* thread_cpu_queue = nullptr;
+
+// List of registered producer rings.
+// New rings are pushed to the front by producers,
+// rings are unlinked only by the consumer (never the head one).
+std::atomic<__producer_ring*> producer_rings(nullptr);
+
+// Consumer-side round-robin position and approximate number of pending messages
+__producer_ring* ring_cursor = nullptr;
+size_t rings_pending = 0;
+
+// false while message queue is not initialized, blocked producers give up
+std::atomic<bool> queue_accepting(false);
+
+__thread __producer_ring* thread_ring = nullptr;
+
+// position of producer thread in overload sampling sequence
+__thread size_t sample_step = 0;
+
+/*
+ * Producer-side chain of messages not yet published to the global queue.
+ * The chain is spliced into the queue at once on flush.
+ * Buffer is locked by its thread on each push, so that the processor could flush stale buffers of idle threads.
+ */
+struct __producer_buffer
+{
+	typedef handystats::message_queue::node node;
+
+	__producer_buffer()
+		: first(nullptr)
+		, last(nullptr)
+		, count(0)
+		, start_timestamp()
+		, generation(0)
+		, locked(false)
+	{}
+
+	node* first;
+	node* last;
+	size_t count;
+	// timestamp of the first buffered message
+	handystats::chrono::time_point start_timestamp;
+	// queue generation the messages were buffered for
+	uint64_t generation;
+
+	std::atomic<bool> locked;
+};
+
+__thread __producer_buffer* thread_buffer = nullptr;
+
+// Buffers of alive producer threads, buffers are unregistered on thread exit
+std::mutex producer_buffers_lock;
+std::vector<__producer_buffer*> producer_buffers;
+// processor side: last scan for stale buffers and whether buffered messages were left then
+handystats::chrono::time_point stale_buffers_timestamp;
+bool stale_buffers_pending = false;
+
+pthread_key_t buffer_key;
+pthread_once_t buffer_key_once = PTHREAD_ONCE_INIT;
+
+// incremented on each message queue initialization,
+// messages buffered before reinitialization are not published to the new queue
+std::atomic<uint64_t> queue_generation(0);
+
+pthread_key_t ring_key;
+pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+// closed ring is freed by the consumer, later destructors of the exiting thread register a new one
+void close_thread_ring(void* ring) {
+	thread_ring = nullptr;
+	static_cast<__producer_ring*>(ring)->m_closed.store(true, std::memory_order_release);
+}
+
+void create_ring_key() {
+	pthread_key_create(&ring_key, close_thread_ring);
+}
+
+__producer_ring* register_thread_ring(size_t capacity) {
+	__producer_ring* ring = new __producer_ring(capacity);
+
+	pthread_once(&ring_key_once, create_ring_key);
+	pthread_setspecific(ring_key, ring);
+
+	ring->m_next = producer_rings.load(std::memory_order_acquire);
+	while (!producer_rings.compare_exchange_weak(ring->m_next, ring, std::memory_order_acq_rel)) {
+	}
+
+	return ring;
+}
+
+// Consumer side: unlink and free rings of exited threads that have been fully drained.
+// Head ring is never unlinked as producers could be concurrently pushing new rings in front of it.
+void collect_closed_rings() {
+	__producer_ring* prev = producer_rings.load(std::memory_order_acquire);
+	if (!prev) {
+		return;
+	}
+
+	__producer_ring* ring = prev->m_next;
+	while (ring) {
+		if (ring->m_closed.load(std::memory_order_acquire) && ring->size() == 0) {
+			prev->m_next = ring->m_next;
+			if (ring_cursor == ring) {
+				ring_cursor = ring->m_next;
+			}
+			rings_pending -= ring->m_pending;
+			delete ring;
+			ring = prev->m_next;
+		}
+		else {
+			prev = ring;
+			ring = ring->m_next;
+		}
+	}
+}
+
+// Consumer side: drains per-CPU queues in cpus_by_node() order, each sweep starts from the first CPU
+// of the consumer's current NUMA node. A queue is left only when drained, so a batch that ends mid-queue
+// resumes with it (keeps events of a migrated thread in order, see home_cpu_queue)
+size_t pop_cpu_queues(handystats::events::event_message** messages, const size_t& max_count) {
+	__cpu_queue* queues = cpu_queues.load(std::memory_order_acquire);
+	if (!queues) {
+		return 0;
+	}
+
+	const std::vector<size_t>& cpus = handystats::cpu_topology::cpus_by_node();
+
+	size_t count = 0;
+	size_t visited = 0;
+
+	while (count < max_count && visited < cpu_queues_count) {
+		if (sweep_position == cpu_queues_count) {
+			const size_t node = handystats::cpu_topology::node_of(handystats::cpu_topology::current_cpu());
+			sweep_start = std::find_if(cpus.begin(), cpus.end(),
+					[node] (const size_t& cpu) {
+						return handystats::cpu_topology::node_of(cpu) == node;
+					}
+				) - cpus.begin();
+			sweep_position = 0;
+		}
+
+		__cpu_queue& queue = queues[cpus[(sweep_start + sweep_position) % cpu_queues_count]];
+
+		size_t popped = 0;
+		while (count < max_count) {
+			handystats::message_queue::node* n = queue.queue.pop();
+			if (!n) {
+				break;
+			}
+			messages[count++] = static_cast<handystats::events::event_message*>(n);
+			++popped;
+		}
+		if (popped > 0) {
+			queue.size.fetch_sub(popped, std::memory_order_acq_rel);
+		}
+
+		// queue is left only when drained, so the next pop continues with it
+		if (count < max_count) {
+			++sweep_position;
+			++visited;
+		}
+	}
+
+	return count;
+}
+
+size_t cpu_queues_size() {
+	__cpu_queue* queues = cpu_queues.load(std::memory_order_acquire);
+	if (!queues) {
+		return 0;
+	}
+
+	size_t total_size = 0;
+	for (size_t index = 0; index < cpu_queues_count; ++index) {
+		total_size += queues[index].size.load(std::memory_order_relaxed);
+	}
+	return total_size;
+}
+
+// Consumer side: round-robin over producer rings, each visited ring is drained as much as batch allows
+size_t pop_rings(handystats::events::event_message** messages, const size_t& max_count) {
+	__producer_ring* head = producer_rings.load(std::memory_order_acquire);
+	if (!head) {
+		return 0;
+	}
+
+	if (!ring_cursor) {
+		ring_cursor = head;
+	}
+
+	__producer_ring* start = ring_cursor;
+	bool seen_closed = false;
+	size_t count = 0;
+
+	do {
+		__producer_ring* ring = ring_cursor;
+		ring_cursor = ring->m_next ? ring->m_next : head;
+
+		while (count < max_count) {
+			handystats::message_queue::node* n = ring->pop();
+			if (!n) {
+				break;
+			}
+			messages[count++] = static_cast<handystats::events::event_message*>(n);
+		}
+
+		const size_t pending = ring->m_cached_head - ring->m_tail.load(std::memory_order_relaxed);
+		rings_pending += pending;
+		rings_pending -= ring->m_pending;
+		ring->m_pending = pending;
+
+		if (count == max_count) {
+			return count;
+		}
+
+		seen_closed |= ring->m_closed.load(std::memory_order_relaxed);
+	} while (ring_cursor != start);
+
+	if (seen_closed) {
+		collect_closed_rings();
+	}
+
+	return count;
+}
+
 } // unnamed namespace
 
 
 namespace handystats { namespace message_queue {
 
 
+std::atomic<uint64_t> dropped_count[DESTINATION_TYPES_COUNT];
+
+// messages popped by processors of other shards, accounted in pop_count by the first shard
+std::atomic<uint64_t> shards_pop_count(0);
+
+
 namespace stats {
 
 metrics::gauge size;
 metrics::gauge message_wait_time;
 metrics::counter pop_count;
+metrics::counter dropped;
+metrics::counter dropped_by_type[DESTINATION_TYPES_COUNT];
+
+// dropped_count values already accounted in dropped counters
+static uint64_t dropped_seen[DESTINATION_TYPES_COUNT];
 
 void update(const chrono::time_point& timestamp) {
+	for (size_t type = 0; type < DESTINATION_TYPES_COUNT; ++type) {
+		const uint64_t current_dropped = dropped_count[type].load(std::memory_order_relaxed);
+		if (current_dropped != dropped_seen[type]) {
+			dropped_by_type[type].increment(current_dropped - dropped_seen[type], timestamp);
+			dropped.increment(current_dropped - dropped_seen[type], timestamp);
+			dropped_seen[type] = current_dropped;
+		}
+		dropped_by_type[type].update_statistics(timestamp);
+	}
+
+	const uint64_t shards_pops = shards_pop_count.exchange(0, std::memory_order_relaxed);
+	if (shards_pops > 0) {
+		pop_count.increment(shards_pops, timestamp);
+	}
+
 	size.update_statistics(timestamp);
 	message_wait_time.update_statistics(timestamp);
 	pop_count.update_statistics(timestamp);
+	dropped.update_statistics(timestamp);
 }
 
 static void reset() {
@@ -127,6 +563,19 @@ static void reset() {
 	pop_count_opts.values.moving_interval = chrono::duration(1, chrono::time_unit::SEC);
 
 	pop_count = metrics::counter(pop_count_opts);
+
+	config::metrics::counter dropped_opts;
+
+	dropped_opts.values.tags = statistics::tag::rate | statistics::tag::value;
+	dropped_opts.values.rate_unit = chrono::time_unit::SEC;
+	dropped_opts.values.moving_interval = chrono::duration(1, chrono::time_unit::SEC);
+
+	dropped = metrics::counter(dropped_opts);
+	for (size_t type = 0; type < DESTINATION_TYPES_COUNT; ++type) {
+		dropped_by_type[type] = metrics::counter(dropped_opts);
+		dropped_count[type].store(0, std::memory_order_relaxed);
+		dropped_seen[type] = 0;
+	}
 }
 
 void initialize() {
@@ -140,65 +589,637 @@ void finalize() {
 } // namespace stats
 
 
-__event_message_queue* event_message_queue = nullptr;
+// Shard queues are never freed, so producers racing with finalize() never touch freed memory.
+// Per-thread rings use only the first shard's consumer parking.
+__shard_queue shard_queues[MAX_SHARDS];
+std::atomic<size_t> shards_count(1);
+
+// True once the process is registered for expedited membarrier:
+// parking consumer then issues the full barrier on behalf of all producers.
+static std::atomic<bool> heavy_barrier(false);
+
+static void register_heavy_barrier() {
+#ifdef SYS_membarrier
+	if (!heavy_barrier.load(std::memory_order_acquire) &&
+			syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0)
+	{
+		heavy_barrier.store(true, std::memory_order_release);
+	}
+#endif
+}
+
+// Consumer's side of the barrier pairing, run between setting the parked flag and checking the queue
+static void consumer_barrier() {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+#ifdef SYS_membarrier
+	if (heavy_barrier.load(std::memory_order_acquire)) {
+		syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+	}
+#endif
+}
+
+// Producer's publish and consumer's parked flag are ordered Dekker-style:
+// producer publishes, then checks the flag; consumer sets the flag, then checks the queue,
+// with full barriers in between either the producer sees the flag or the consumer sees the message.
+// Producer's barrier here is its seq_cst RMW of the queue size (a locked instruction on x86),
+// the flag is read with seq_cst load (a plain load on x86).
+static void notify_consumer(__shard_queue& shard) {
+	if (shard.consumer_parked.load(std::memory_order_seq_cst) && shard.consumer_parked.exchange(0, std::memory_order_acq_rel)) {
+		syscall(SYS_futex, reinterpret_cast<int*>(&shard.consumer_parked), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+	}
+}
+
+// Same for publish by plain release stores (per-thread rings and packed logs).
+// With expedited membarrier the consumer's barrier orders producers' stores and loads,
+// so only the compiler is kept from reordering them, otherwise a full fence is paid per push.
+static void notify_consumer_after_release(__shard_queue& shard) {
+	if (heavy_barrier.load(std::memory_order_relaxed)) {
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+	}
+	else {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+	notify_consumer(shard);
+}
+
+size_t shard_of(const uint64_t& name_hash) {
+	// low bits of the hash are used by shard's metrics table,
+	// FNV-1a's high bits hardly depend on the name's last chars, so they are mixed first
+	const uint64_t mixed_hash = name_hash * 0x9E3779B97F4A7C15ULL;
+	return (mixed_hash >> 32) % shards_count.load(std::memory_order_relaxed);
+}
+
+size_t shard_of(const events::event_message& message) {
+	const size_t count = shards_count.load(std::memory_order_relaxed);
+	if (count <= 1) {
+		return 0;
+	}
+
+	if (!message.destination_literal && message.destination_id == metric_handle::INVALID_ID) {
+		return shard_of(internal::metrics_table::hash(message.destination_name.data(), message.destination_name.size()));
+	}
+
+	return shard_of(message.destination_hash);
+}
+
+static void drop(node* n) {
+	auto* message = static_cast<events::event_message*>(n);
+	if (size_t(message->destination_type) < DESTINATION_TYPES_COUNT) {
+		dropped_count[size_t(message->destination_type)].fetch_add(1, std::memory_order_relaxed);
+	}
+	events::delete_event_message(message);
+}
+
+// Block deadline is measured with monotonic clock: TSC ticks are converted to time
+// with the estimated cycles frequency and the estimation error would cut the wait short.
+static int64_t monotonic_nanoseconds() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return int64_t(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+}
+
+// Producer side: whether new message could be pushed into the queue of given size and capacity.
+// With BLOCK overload policy waits for the processor to make room.
+// Size is checked before the push without reservation, so capacity is a soft bound (see config).
+static bool admit(size_t (*current_size)(), const size_t& capacity) {
+	const auto& opts = config::message_queue_opts;
+
+	switch (opts.overload_policy) {
+		case config::message_queue::DROP_NEWEST:
+			return current_size() < capacity;
+
+		case config::message_queue::SAMPLE:
+		{
+			const size_t size = current_size();
+			if (size >= capacity) {
+				return false;
+			}
+			if (size < capacity / 2) {
+				return true;
+			}
+			return ++sample_step % opts.sample_every == 0;
+		}
+
+		case config::message_queue::BLOCK:
+		default:
+		{
+			if (current_size() < capacity) {
+				return true;
+			}
+
+			const int64_t deadline = monotonic_nanoseconds() +
+				chrono::duration::convert_to(chrono::time_unit::NSEC, opts.block_timeout).count();
+			while (current_size() >= capacity) {
+				if (!queue_accepting.load(std::memory_order_acquire)) {
+					return false;
+				}
+				if (opts.block_timeout.count() > 0 && monotonic_nanoseconds() >= deadline) {
+					return false;
+				}
+				notify();
+				std::this_thread::yield();
+			}
+			return true;
+		}
+	}
+}
+
+static void flush_buffer(__producer_buffer* buffer) {
+	if (buffer->count == 0) {
+		return;
+	}
+
+	// producer buffering is used with a single shard only
+	if (buffer->generation == queue_generation.load(std::memory_order_acquire) &&
+			queue_accepting.load(std::memory_order_acquire))
+	{
+		shard_queues[0].queue.push(buffer->first, buffer->last);
+		// seq_cst RMW orders the publish before notify_consumer's flag check
+		shard_queues[0].size.fetch_add(buffer->count, std::memory_order_seq_cst);
+	}
+	else {
+		node* n = buffer->first;
+		while (n) {
+			node* next = n->next.load(std::memory_order_relaxed);
+			events::delete_event_message(static_cast<events::event_message*>(n));
+			n = next;
+		}
+	}
+
+	buffer->first = buffer->last = nullptr;
+	buffer->count = 0;
+
+	notify_consumer(shard_queues[0]);
+}
+
+static void lock_buffer(__producer_buffer* buffer) {
+	// contended only while the processor flushes the buffer
+	while (buffer->locked.exchange(true, std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+}
+
+static void unlock_buffer(__producer_buffer* buffer) {
+	buffer->locked.store(false, std::memory_order_release);
+}
+
+static void flush_exited_thread_buffer(void* buffer) {
+	thread_buffer = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(producer_buffers_lock);
+		producer_buffers.erase(std::find(producer_buffers.begin(), producer_buffers.end(), buffer));
+	}
+
+	flush_buffer(static_cast<__producer_buffer*>(buffer));
+	delete static_cast<__producer_buffer*>(buffer);
+}
+
+static void create_buffer_key() {
+	pthread_key_create(&buffer_key, flush_exited_thread_buffer);
+}
+
+static __producer_buffer* register_thread_buffer() {
+	__producer_buffer* buffer = new __producer_buffer();
+
+	pthread_once(&buffer_key_once, create_buffer_key);
+	pthread_setspecific(buffer_key, buffer);
+
+	std::lock_guard<std::mutex> lock(producer_buffers_lock);
+	producer_buffers.push_back(buffer);
+
+	return buffer;
+}
+
+// Appends message to the thread's chain, chain is published once it is large or old enough
+static void push_buffered(node* n) {
+	__producer_buffer* buffer = thread_buffer;
+	if (!buffer) {
+		buffer = thread_buffer = register_thread_buffer();
+	}
+
+	const chrono::time_point& timestamp = static_cast<events::event_message*>(n)->timestamp;
 
-std::atomic<size_t> mq_size(0);
+	lock_buffer(buffer);
+
+	n->next.store(nullptr, std::memory_order_relaxed);
+	if (buffer->count == 0) {
+		buffer->first = n;
+		buffer->start_timestamp = timestamp;
+		buffer->generation = queue_generation.load(std::memory_order_acquire);
+	}
+	else {
+		buffer->last->next.store(static_cast<events::event_message*>(n), std::memory_order_relaxed);
+	}
+	buffer->last = n;
+	++buffer->count;
+
+	if (buffer->count >= config::message_queue_opts.producer_buffer_size ||
+			timestamp - buffer->start_timestamp >= config::message_queue_opts.producer_buffer_age)
+	{
+		flush_buffer(buffer);
+	}
+
+	unlock_buffer(buffer);
+}
+
+static size_t thread_ring_size() {
+	return thread_ring->producer_size();
+}
+
+static size_t global_queue_size() {
+	size_t total_size = 0;
+	for (size_t shard = 0; shard < shards_count.load(std::memory_order_relaxed); ++shard) {
+		total_size += shard_queues[shard].size.load(std::memory_order_relaxed);
+	}
+	return total_size;
+}
+
+static void push_ring(node* n) {
+	__producer_ring* ring = thread_ring;
+	if (!ring) {
+		ring = thread_ring = register_thread_ring(config::message_queue_opts.ring_capacity);
+	}
+
+	if (!admit(thread_ring_size, ring->capacity()) || !ring->push(n)) {
+		drop(n);
+	}
+}
+
+static void push_log(node* n) {
+	auto* message = static_cast<events::event_message*>(n);
+
+	const size_t required_space = message_log::required_space(*message);
+	const size_t capacity = message_log::thread_log_capacity();
+
+	if (required_space > capacity ||
+			!admit(message_log::thread_log_size, capacity - required_space + 1) ||
+			!message_log::write(*message))
+	{
+		drop(n);
+		return;
+	}
+
+	// message is encoded into the log, so it's recycled right away by the producer
+	events::delete_event_message(message);
+}
+
+static size_t thread_cpu_queue_size() {
+	return thread_cpu_queue->size.load(std::memory_order_relaxed);
+}
+
+// Thread is re-homed to its current CPU's queue only once its previous queue is empty,
+// i.e. all thread's events from there are popped before the events of the new queue
+static void home_cpu_queue() {
+	__cpu_queue* queues = cpu_queues.load(std::memory_order_acquire);
+	__cpu_queue* current_queue = &queues[cpu_topology::current_cpu() % cpu_queues_count];
+
+	if (!thread_cpu_queue ||
+			(thread_cpu_queue != current_queue && thread_cpu_queue->size.load(std::memory_order_acquire) == 0))
+	{
+		thread_cpu_queue = current_queue;
+	}
+}
+
+static void push_cpu_queue(node* n) {
+	home_cpu_queue();
+
+	// capacity limits each CPU's queue
+	const size_t capacity = config::message_queue_opts.capacity;
+	if (capacity > 0 && !admit(thread_cpu_queue_size, capacity)) {
+		drop(n);
+		return;
+	}
+
+	thread_cpu_queue->queue.push(n);
+	// seq_cst RMW orders the publish before notify_consumer's flag check
+	thread_cpu_queue->size.fetch_add(1, std::memory_order_seq_cst);
+}
+
+static void push_global(node* n) {
+	const size_t capacity = config::message_queue_opts.capacity;
+
+	if (capacity > 0 && !admit(global_queue_size, capacity)) {
+		drop(n);
+		return;
+	}
+
+	if (config::message_queue_opts.producer_buffer_size > 1 && shards_count.load(std::memory_order_relaxed) == 1) {
+		// consumer is notified on flush
+		push_buffered(n);
+		return;
+	}
+
+	__shard_queue& shard = shard_queues[shard_of(*static_cast<events::event_message*>(n))];
+
+	shard.queue.push(n);
+	// seq_cst increment orders the publish before the flag check
+	++shard.size;
+
+	notify_consumer(shard);
+}
+
+static void push_message(node* n) {
+	// inline mode: message is processed by the producer, queue is not used
+	if (config::core_opts.mode == config::core::INLINE) {
+		auto* message = static_cast<events::event_message*>(n);
+		internal::process_inline(*message);
+		events::delete_event_message(message);
+		return;
+	}
+
+	if (!queue_accepting.load(std::memory_order_acquire)) {
+		events::delete_event_message(static_cast<events::event_message*>(n));
+		return;
+	}
+
+	if (config::message_queue_opts.topology == config::message_queue::PER_THREAD) {
+		push_ring(n);
+		notify_consumer_after_release(shard_queues[0]);
+	}
+	else if (config::message_queue_opts.topology == config::message_queue::PACKED) {
+		push_log(n);
+		notify_consumer_after_release(shard_queues[0]);
+	}
+	else if (config::message_queue_opts.topology == config::message_queue::PER_CPU) {
+		push_cpu_queue(n);
+		notify_consumer(shard_queues[0]);
+	}
+	else {
+		push_global(n);
+	}
+}
 
 void push(node* n) {
-	if (event_message_queue) {
-		event_message_queue->push(n);
-		++mq_size;
+	// message could be processed and recycled by the time push is done
+	const auto* message = static_cast<const events::event_message*>(n);
+	const char destination_type = message->destination_type;
+
+	if (!self_stats::produced(destination_type, message->event_type)) {
+		push_message(n);
+		return;
+	}
+
+	const auto push_start_time = chrono::tsc_clock::now();
+	push_message(n);
+	self_stats::enqueue_time(destination_type, chrono::tsc_clock::now() - push_start_time);
+}
+
+void flush_thread() {
+	if (thread_buffer) {
+		lock_buffer(thread_buffer);
+		flush_buffer(thread_buffer);
+		unlock_buffer(thread_buffer);
+	}
+}
+
+bool flush_stale_buffers(const chrono::time_point& timestamp) {
+	const chrono::duration& max_age = config::message_queue_opts.producer_buffer_age;
+
+	// buffers are scanned at most twice per max age
+	if (timestamp - stale_buffers_timestamp < max_age / 2) {
+		return stale_buffers_pending;
+	}
+	stale_buffers_timestamp = timestamp;
+	stale_buffers_pending = false;
+
+	std::lock_guard<std::mutex> lock(producer_buffers_lock);
+	for (auto buffer_iter = producer_buffers.begin(); buffer_iter != producer_buffers.end(); ++buffer_iter) {
+		__producer_buffer* buffer = *buffer_iter;
+
+		// buffer being pushed to is checked on the next scan
+		if (buffer->locked.exchange(true, std::memory_order_acquire)) {
+			stale_buffers_pending = true;
+			continue;
+		}
+
+		if (buffer->count > 0 && timestamp - buffer->start_timestamp >= max_age) {
+			flush_buffer(buffer);
+		}
+		stale_buffers_pending = stale_buffers_pending || buffer->count > 0;
+
+		unlock_buffer(buffer);
+	}
+
+	return stale_buffers_pending;
+}
+
+void wait(const size_t& shard_index, const chrono::duration& timeout) {
+	__shard_queue& shard = shard_queues[shard_index];
+
+	shard.consumer_parked.store(1, std::memory_order_relaxed);
+	consumer_barrier();
+
+	// messages pushed before producers could see the parked flag
+	if (!empty(shard_index)) {
+		shard.consumer_parked.store(0, std::memory_order_relaxed);
+		return;
+	}
+
+	const int64_t timeout_ns = chrono::duration::convert_to(chrono::time_unit::NSEC, timeout).count();
+	if (timeout_ns > 0) {
+		struct timespec timeout_ts;
+		timeout_ts.tv_sec = timeout_ns / 1000000000;
+		timeout_ts.tv_nsec = timeout_ns % 1000000000;
+
+		syscall(SYS_futex, reinterpret_cast<int*>(&shard.consumer_parked), FUTEX_WAIT_PRIVATE, 1, &timeout_ts, nullptr, 0);
+	}
+
+	shard.consumer_parked.store(0, std::memory_order_relaxed);
+}
+
+// publish to be noticed isn't known here, so full fence is paid
+void notify(const size_t& shard_index) {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	notify_consumer(shard_queues[shard_index]);
+}
+
+void notify() {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	for (size_t shard = 0; shard < shards_count.load(std::memory_order_relaxed); ++shard) {
+		notify_consumer(shard_queues[shard]);
 	}
 }
 
 events::event_message* pop() {
 	events::event_message* message = nullptr;
+	pop(0, &message, 1);
+	return message;
+}
+
+size_t pop(events::event_message** messages, const size_t& max_count) {
+	return pop(0, messages, max_count);
+}
 
-	if (event_message_queue) {
-		message = static_cast<events::event_message*>(event_message_queue->pop());
+size_t pop(const size_t& shard_index, events::event_message** messages, const size_t& max_count) {
+	size_t count = 0;
+	size_t current_size = 0;
+
+	if (config::message_queue_opts.topology == config::message_queue::PER_THREAD) {
+		if (shard_index == 0) {
+			count = pop_rings(messages, max_count);
+			current_size = rings_pending;
+		}
+	}
+	else if (config::message_queue_opts.topology == config::message_queue::PACKED) {
+		if (shard_index == 0) {
+			count = message_log::read(messages, max_count);
+			current_size = message_log::pending();
+		}
+	}
+	else if (config::message_queue_opts.topology == config::message_queue::PER_CPU) {
+		if (shard_index == 0) {
+			count = pop_cpu_queues(messages, max_count);
+			current_size = cpu_queues_size();
+		}
+	}
+	else {
+		__shard_queue& shard = shard_queues[shard_index];
+		while (count < max_count) {
+			auto* message = static_cast<events::event_message*>(shard.queue.pop());
+			if (!message) {
+				break;
+			}
+			messages[count++] = message;
+		}
+		if (count > 0) {
+			shard.size.fetch_sub(count, std::memory_order_acq_rel);
+			current_size = global_queue_size();
+		}
 	}
 
-	if (message) {
-		--mq_size;
-		auto current_time = chrono::tsc_clock::now();
-		stats::size.set(size(), current_time);
-		stats::pop_count.increment(1, current_time);
+	if (count == 0) {
+		return 0;
+	}
 
-		stats::message_wait_time.set(
-				chrono::duration::convert_to(metrics::timer::value_unit, current_time - message->timestamp).count(),
-				current_time
-			);
+	// self-statistics are owned by the first shard's processor
+	if (shard_index != 0) {
+		shards_pop_count.fetch_add(count, std::memory_order_relaxed);
+		return count;
 	}
 
-	return message;
+	// self-statistics are updated once per batch, wait time is sampled from the first message
+	auto current_time = chrono::tsc_clock::now();
+	stats::size.set(current_size, current_time);
+	stats::pop_count.increment(count + shards_pop_count.exchange(0, std::memory_order_relaxed), current_time);
+
+	stats::message_wait_time.set(
+			chrono::duration::convert_to(metrics::timer::value_unit, current_time - messages[0]->timestamp).count(),
+			current_time
+		);
+
+	return count;
+}
+
+static size_t rings_size() {
+	size_t total_size = 0;
+	for (__producer_ring* ring = producer_rings.load(std::memory_order_acquire); ring; ring = ring->m_next) {
+		total_size += ring->size();
+	}
+	return total_size;
 }
 
 bool empty() {
-	return mq_size.load(std::memory_order_acquire) == 0;
+	return size() == 0;
+}
+
+void release(events::event_message** messages, const size_t& count) {
+	// packed topology's messages are owned by the log and reference its records
+	if (config::message_queue_opts.topology == config::message_queue::PACKED) {
+		message_log::release();
+		return;
+	}
+
+	for (size_t index = 0; index < count; ++index) {
+		events::delete_event_message(messages[index]);
+	}
+}
+
+bool empty(const size_t& shard_index) {
+	if (config::message_queue_opts.topology == config::message_queue::PER_THREAD) {
+		return shard_index != 0 || rings_size() == 0;
+	}
+	if (config::message_queue_opts.topology == config::message_queue::PACKED) {
+		return shard_index != 0 || message_log::size() == 0;
+	}
+	if (config::message_queue_opts.topology == config::message_queue::PER_CPU) {
+		return shard_index != 0 || cpu_queues_size() == 0;
+	}
+	return shard_queues[shard_index].size.load(std::memory_order_acquire) == 0;
 }
 
 size_t size() {
-	return mq_size.load(std::memory_order_acquire);
+	if (config::message_queue_opts.topology == config::message_queue::PER_THREAD) {
+		return rings_size();
+	}
+	if (config::message_queue_opts.topology == config::message_queue::PACKED) {
+		return message_log::size();
+	}
+	if (config::message_queue_opts.topology == config::message_queue::PER_CPU) {
+		return cpu_queues_size();
+	}
+	return global_queue_size();
 }
 
-void initialize() {
-	if (!event_message_queue) {
-		event_message_queue = new __event_message_queue();
-		mq_size.store(0, std::memory_order_release);
+void initialize(const size_t& shards) {
+	register_heavy_barrier();
+
+	queue_generation.fetch_add(1, std::memory_order_acq_rel);
+
+	size_t count = shards < MAX_SHARDS ? shards : MAX_SHARDS;
+	shards_count.store(count > 0 ? count : 1, std::memory_order_relaxed);
+	shards_pop_count.store(0, std::memory_order_relaxed);
+
+	if (config::message_queue_opts.topology == config::message_queue::PER_CPU && !cpu_queues.load(std::memory_order_acquire)) {
+		cpu_queues_count = cpu_topology::cpus_count();
+		cpu_queues.store(new __cpu_queue[cpu_queues_count], std::memory_order_release);
 	}
+	sweep_position = cpu_queues_count;
+
+	queue_accepting.store(true, std::memory_order_release);
 
 	stats::initialize();
 }
 
 void finalize() {
-	while (!empty()) {
-		auto* message = pop();
-		events::delete_event_message(message);
+	queue_accepting.store(false, std::memory_order_release);
+
+	for (size_t shard_index = 0; shard_index < MAX_SHARDS; ++shard_index) {
+		__shard_queue& shard = shard_queues[shard_index];
+		while (shard.size.load(std::memory_order_acquire) > 0) {
+			auto* message = static_cast<events::event_message*>(shard.queue.pop());
+			if (message) {
+				--shard.size;
+			}
+			events::delete_event_message(message);
+		}
+	}
+
+	if (__cpu_queue* queues = cpu_queues.load(std::memory_order_acquire)) {
+		for (size_t index = 0; index < cpu_queues_count; ++index) {
+			__cpu_queue& queue = queues[index];
+			while (queue.size.load(std::memory_order_acquire) > 0) {
+				auto* message = static_cast<events::event_message*>(queue.queue.pop());
+				if (message) {
+					--queue.size;
+				}
+				events::delete_event_message(message);
+			}
+		}
+	}
+
+	// rings of alive threads are kept for reuse, rings of exited threads are freed
+	for (__producer_ring* ring = producer_rings.load(std::memory_order_acquire); ring; ring = ring->m_next) {
+		while (auto* message = static_cast<events::event_message*>(ring->pop())) {
+			events::delete_event_message(message);
+		}
+		ring->m_pending = 0;
 	}
-	mq_size.store(0);
+	rings_pending = 0;
+	ring_cursor = nullptr;
+	collect_closed_rings();
 
-	delete event_message_queue;
-	event_message_queue = nullptr;
+	message_log::finalize();
 
 	stats::finalize();
 }
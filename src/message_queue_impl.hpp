@@ -20,13 +20,52 @@ struct node {
 	std::atomic<events::event_message*> next;
 };
 
+// Number of event destination types, dropped messages are accounted per type
+static const size_t DESTINATION_TYPES_COUNT = 4;
+
+// Number of messages dropped on queue overload, indexed by event destination type
+extern std::atomic<uint64_t> dropped_count[DESTINATION_TYPES_COUNT];
+
+// Pushes message or drops it according to overload policy if queue is full
 void push(node*);
+// Publishes messages buffered by the calling thread
+void flush_thread();
+// Processor side: publishes messages buffered by producer threads longer than producer-buffer-age,
+// returns true if some threads still have buffered messages
+bool flush_stale_buffers(const chrono::time_point& timestamp);
+
+// Maximum number of processor shards, each shard has its own inbound queue.
+// Producers route messages to shards by metric name hash.
+static const size_t MAX_SHARDS = 64;
+
+// Shard of the metric with given name hash
+size_t shard_of(const uint64_t& name_hash);
+// Shard of the message's metric,
+// events of the same metric go to the same shard, whether the metric is referenced by name, literal or handle
+size_t shard_of(const events::event_message& message);
+
+// Popped messages are returned with release(), in packed topology they are owned by the queue
+// and stay valid until the next pop
 events::event_message* pop();
+// Pops up to max_count messages at once, returns number of popped messages
+size_t pop(events::event_message** messages, const size_t& max_count);
+// Pops messages of the shard, per-thread rings are consumed by the first shard only
+size_t pop(const size_t& shard, events::event_message** messages, const size_t& max_count);
+
+void release(events::event_message** messages, const size_t& count);
 
 bool empty();
+bool empty(const size_t& shard);
 size_t size();
 
-void initialize();
+// Consumer side: park until push to the shard, notify() or timeout expiration
+void wait(const size_t& shard, const chrono::duration& timeout);
+// Wake parked consumer of the shard
+void notify(const size_t& shard);
+// Wake all parked consumers
+void notify();
+
+void initialize(const size_t& shards = 1);
 void finalize();
 
 
@@ -35,6 +74,8 @@ namespace stats {
 extern metrics::gauge size;
 extern metrics::gauge message_wait_time;
 extern metrics::counter pop_count;
+extern metrics::counter dropped;
+extern metrics::counter dropped_by_type[DESTINATION_TYPES_COUNT];
 
 void update(const chrono::time_point&);
 
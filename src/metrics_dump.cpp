@@ -9,6 +9,8 @@
 
 #include "internal_impl.hpp"
 #include "message_queue_impl.hpp"
+#include "events/event_message_pool_impl.hpp"
+#include "self_stats_impl.hpp"
 
 #include "config_impl.hpp"
 
@@ -57,18 +59,23 @@ get_dump()
 	return dump;
 }
 
-static
-std::shared_ptr<const std::map<std::string, metrics::metric_variant>>
-create_dump()
-{
-	auto dump_start_time = chrono::tsc_clock::now();
-
-	std::shared_ptr<std::map<std::string, metrics::metric_variant>> new_dump(new std::map<std::string, metrics::metric_variant>());
-
-	for (auto metric_iter = internal::metrics_map.cbegin(); metric_iter != internal::metrics_map.cend(); ++metric_iter) {
+// Dump of multiple shards is merged from snapshots made by shards' processors on request.
+// Requests are numbered, a shard's snapshot is ready once its snapshot_epoch reaches dump_epoch.
+std::atomic<uint64_t> dump_epoch(0);
+bool snapshots_requested = false;
+// Shards' snapshots are made after the request, so the dump is stamped with request time
+chrono::time_point dump_request_time;
+
+static void append_metrics(internal::shard& metrics_shard, std::map<std::string, metrics::metric_variant>& new_dump) {
+	auto& metrics_map = metrics_shard.metrics_map;
+	const auto& sorted_index = metrics_map.sorted_index();
+	// metrics are visited in name order, so every insert goes to the end of the dump
+	for (auto index_iter = sorted_index.cbegin(); index_iter != sorted_index.cend(); ++index_iter) {
+		const auto* metric_iter = &metrics_map.at(*index_iter);
 		switch (metric_iter->second.which()) {
 			case metrics::metric_index::GAUGE:
-				new_dump->insert(
+				new_dump.insert(
+						new_dump.end(),
 						std::pair<std::string, metrics::metric_variant>(
 							metric_iter->first,
 							*boost::get<metrics::gauge*>(metric_iter->second)
@@ -76,7 +83,8 @@ create_dump()
 					);
 				break;
 			case metrics::metric_index::COUNTER:
-				new_dump->insert(
+				new_dump.insert(
+						new_dump.end(),
 						std::pair<std::string, metrics::metric_variant>(
 							metric_iter->first,
 							*boost::get<metrics::counter*>(metric_iter->second)
@@ -84,7 +92,8 @@ create_dump()
 					);
 				break;
 			case metrics::metric_index::TIMER:
-				new_dump->insert(
+				new_dump.insert(
+						new_dump.end(),
 						std::pair<std::string, metrics::metric_variant>(
 							metric_iter->first,
 							*boost::get<metrics::timer*>(metric_iter->second)
@@ -92,7 +101,8 @@ create_dump()
 					);
 				break;
 			case metrics::metric_index::ATTRIBUTE:
-				new_dump->insert(
+				new_dump.insert(
+						new_dump.end(),
 						std::pair<std::string, metrics::metric_variant>(
 							metric_iter->first,
 							*boost::get<metrics::attribute*>(metric_iter->second)
@@ -101,6 +111,22 @@ create_dump()
 				break;
 		}
 	}
+}
+
+static
+std::shared_ptr<const std::map<std::string, metrics::metric_variant>>
+create_dump(const chrono::time_point& dump_timestamp)
+{
+	auto dump_start_time = chrono::tsc_clock::now();
+
+	std::shared_ptr<std::map<std::string, metrics::metric_variant>> new_dump(new std::map<std::string, metrics::metric_variant>());
+
+	append_metrics(*internal::shards.front(), *new_dump);
+
+	for (size_t index = 1; index < internal::shards.size(); ++index) {
+		const auto& snapshot = internal::shards[index]->snapshot;
+		new_dump->insert(snapshot.cbegin(), snapshot.cend());
+	}
 
 	// handystats' statistics
 	{
@@ -143,15 +169,106 @@ create_dump()
 						message_queue::stats::pop_count
 						)
 					);
+
+			new_dump->insert(
+					std::pair<std::string, metrics::metric_variant>(
+						"handystats.message_queue.dropped",
+						message_queue::stats::dropped
+						)
+					);
+
+			static const char* destination_type_names[message_queue::DESTINATION_TYPES_COUNT] = {
+				"counter", "gauge", "timer", "attribute"
+			};
+			for (size_t type = 0; type < message_queue::DESTINATION_TYPES_COUNT; ++type) {
+				new_dump->insert(
+						std::pair<std::string, metrics::metric_variant>(
+							std::string("handystats.message_queue.dropped.") + destination_type_names[type],
+							message_queue::stats::dropped_by_type[type]
+							)
+						);
+			}
+		}
+
+		// event message pool
+		{
+			new_dump->insert(
+					std::pair<std::string, metrics::metric_variant>(
+						"handystats.event_pool.allocated",
+						events::pool::stats::allocated
+						)
+					);
+
+			new_dump->insert(
+					std::pair<std::string, metrics::metric_variant>(
+						"handystats.event_pool.in_use",
+						events::pool::stats::in_use
+						)
+					);
+		}
+
+		// event path, unless disabled
+		if (config::metrics_dump_opts.self_stats) {
+			for (size_t type = 0; type < self_stats::DESTINATION_TYPES_COUNT; ++type) {
+				const std::string type_prefix = self_stats::destination_type_name(type);
+
+				new_dump->insert(
+						std::pair<std::string, metrics::metric_variant>(
+							"handystats.self.produced." + type_prefix,
+							self_stats::stats::produced[type]
+							)
+						);
+
+				new_dump->insert(
+						std::pair<std::string, metrics::metric_variant>(
+							"handystats.self.processed." + type_prefix,
+							self_stats::stats::processed[type]
+							)
+						);
+
+				new_dump->insert(
+						std::pair<std::string, metrics::metric_variant>(
+							"handystats.self.enqueue_time." + type_prefix,
+							self_stats::stats::enqueue_time[type]
+							)
+						);
+
+				new_dump->insert(
+						std::pair<std::string, metrics::metric_variant>(
+							"handystats.self.process_time." + type_prefix,
+							self_stats::stats::process_time[type]
+							)
+						);
+
+				for (size_t event = 0; event < self_stats::EVENT_TYPES_COUNT; ++event) {
+					const char* event_name = self_stats::event_type_name(type, event);
+					if (!event_name) {
+						continue;
+					}
+
+					new_dump->insert(
+							std::pair<std::string, metrics::metric_variant>(
+								"handystats.self.produced." + type_prefix + "." + event_name,
+								self_stats::stats::produced_by_event[type][event]
+								)
+							);
+
+					new_dump->insert(
+							std::pair<std::string, metrics::metric_variant>(
+								"handystats.self.processed." + type_prefix + "." + event_name,
+								self_stats::stats::processed_by_event[type][event]
+								)
+							);
+				}
+			}
 		}
 
 		// metrics_dump.dump_time will be added later
 	}
 
 	{
-		// NOTE: possible call chrono::system_clock::now()
 		chrono::time_point system_timestamp =
-			chrono::time_point::convert_to(chrono::clock_type::SYSTEM, chrono::tsc_clock::now());
+			chrono::time_point::convert_to(chrono::clock_type::SYSTEM, dump_timestamp);
 
 		metrics::attribute timestamp_attr;
 		timestamp_attr.set(
@@ -190,26 +307,75 @@ void update(const chrono::time_point& system_time, const chrono::time_point& int
 		return;
 	}
 
-	if (system_time - dump_timestamp > config::metrics_dump_opts.interval) {
-		internal::update_metrics(internal_time);
+	if (!snapshots_requested) {
+		if (system_time - dump_timestamp <= config::metrics_dump_opts.interval) {
+			return;
+		}
+
+		dump_request_time = system_time;
+
+		if (internal::shards.size() > 1) {
+			dump_epoch.fetch_add(1, std::memory_order_acq_rel);
+			snapshots_requested = true;
+			message_queue::notify();
+		}
+	}
+
+	if (snapshots_requested) {
+		const uint64_t epoch = dump_epoch.load(std::memory_order_relaxed);
+		for (size_t index = 1; index < internal::shards.size(); ++index) {
+			if (internal::shards[index]->snapshot_epoch.load(std::memory_order_acquire) != epoch) {
+				return;
+			}
+		}
+		snapshots_requested = false;
+	}
+
+	{
+		internal::apply_slots(*internal::shards.front());
+		internal::update_metrics(*internal::shards.front(), internal_time);
 
 		internal::stats::update(system_time);
 		message_queue::stats::update(system_time);
+		events::pool::stats::update(system_time);
+		if (config::metrics_dump_opts.self_stats) {
+			self_stats::stats::update(system_time);
+		}
 		stats::update(system_time);
 
-		auto new_dump = create_dump();
+		auto new_dump = create_dump(dump_request_time);
 		{
 			std::lock_guard<std::mutex> lock(dump_mutex);
 			dump = new_dump;
 		}
 
-		dump_timestamp = system_time;
+		dump_timestamp = dump_request_time;
 	}
 }
 
+void update_snapshot(internal::shard& metrics_shard, const chrono::time_point& internal_time) {
+	const uint64_t epoch = dump_epoch.load(std::memory_order_acquire);
+	if (metrics_shard.snapshot_epoch.load(std::memory_order_relaxed) == epoch) {
+		return;
+	}
+
+	internal::apply_slots(metrics_shard);
+	internal::update_metrics(metrics_shard, internal_time);
+
+	metrics_shard.snapshot.clear();
+	append_metrics(metrics_shard, metrics_shard.snapshot);
+
+	metrics_shard.snapshot_epoch.store(epoch, std::memory_order_release);
+
+	// first shard's processor waits for snapshots to make the dump
+	message_queue::notify(0);
+}
+
 void initialize() {
 	stats::initialize();
 
+	snapshots_requested = false;
+
 	{
 		std::lock_guard<std::mutex> lock(dump_mutex);
 
@@ -11,12 +11,23 @@
 #include <handystats/metrics.hpp>
 #include <handystats/metrics/gauge.hpp>
 
+namespace handystats { namespace internal {
+
+struct shard;
+
+}} // namespace handystats::internal
+
+
 namespace handystats { namespace metrics_dump {
 
 extern chrono::time_point dump_timestamp;
 
+// Called by the first shard's processor, makes the dump once other shards' snapshots are ready
 void update(const chrono::time_point& system_time, const chrono::time_point& internal_time);
 
+// Called by processors of other shards, makes the shard's snapshot if the dump has been requested
+void update_snapshot(internal::shard& metrics_shard, const chrono::time_point& internal_time);
+
 const std::shared_ptr<const std::map<std::string, metrics::metric_variant>> get_dump();
 
 void initialize();
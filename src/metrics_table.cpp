@@ -0,0 +1,128 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <algorithm>
+#include <cstring>
+
+#include "metrics_table_impl.hpp"
+
+namespace handystats { namespace internal {
+
+const metrics_table::index_type metrics_table::INVALID_INDEX;
+
+static const size_t INITIAL_SLOTS_COUNT = 64;
+
+metrics_table::metrics_table()
+	: m_slots()
+	, m_mask()
+	, m_entries()
+	, m_sorted_index()
+{
+	clear();
+}
+
+uint64_t metrics_table::hash(const char* name, const size_t& length) {
+	uint64_t name_hash = 14695981039346656037ULL;
+	for (size_t pos = 0; pos < length; ++pos) {
+		name_hash = (name_hash ^ static_cast<unsigned char>(name[pos])) * 1099511628211ULL;
+	}
+	return name_hash;
+}
+
+metrics_table::index_type metrics_table::find(const char* name, const size_t& length, const uint64_t& name_hash) const {
+	for (size_t pos = name_hash & m_mask; ; pos = (pos + 1) & m_mask) {
+		const slot& current = m_slots[pos];
+
+		if (current.index == INVALID_INDEX) {
+			return INVALID_INDEX;
+		}
+
+		if (current.hash == name_hash) {
+			const std::string& entry_name = m_entries[current.index].first;
+			if (entry_name.size() == length && memcmp(entry_name.data(), name, length) == 0) {
+				return current.index;
+			}
+		}
+	}
+}
+
+metrics_table::index_type metrics_table::find(const std::string& name) const {
+	return find(name.data(), name.size(), hash(name.data(), name.size()));
+}
+
+metrics_table::index_type metrics_table::insert(const std::string& name) {
+	return insert(name.data(), name.size(), hash(name.data(), name.size()));
+}
+
+metrics_table::index_type metrics_table::insert(const char* name, const size_t& length, const uint64_t& name_hash) {
+	index_type index = find(name, length, name_hash);
+	if (index != INVALID_INDEX) {
+		return index;
+	}
+
+	// keep load factor not greater than 1/2
+	if ((m_entries.size() + 1) * 2 > m_slots.size()) {
+		grow();
+	}
+
+	index = m_entries.size();
+	m_entries.push_back(value_type(std::string(name, length), metrics::metric_ptr_variant()));
+
+	size_t pos = name_hash & m_mask;
+	while (m_slots[pos].index != INVALID_INDEX) {
+		pos = (pos + 1) & m_mask;
+	}
+	m_slots[pos].hash = name_hash;
+	m_slots[pos].index = index;
+
+	return index;
+}
+
+void metrics_table::grow() {
+	std::vector<slot> old_slots(m_slots.size() * 2, slot{0, INVALID_INDEX});
+	old_slots.swap(m_slots);
+	m_mask = m_slots.size() - 1;
+
+	for (auto slot_iter = old_slots.cbegin(); slot_iter != old_slots.cend(); ++slot_iter) {
+		if (slot_iter->index == INVALID_INDEX) {
+			continue;
+		}
+
+		size_t pos = slot_iter->hash & m_mask;
+		while (m_slots[pos].index != INVALID_INDEX) {
+			pos = (pos + 1) & m_mask;
+		}
+		m_slots[pos] = *slot_iter;
+	}
+}
+
+const std::vector<metrics_table::index_type>& metrics_table::sorted_index() {
+	if (m_sorted_index.size() == m_entries.size()) {
+		return m_sorted_index;
+	}
+
+	const size_t sorted_size = m_sorted_index.size();
+	for (index_type index = sorted_size; index < m_entries.size(); ++index) {
+		m_sorted_index.push_back(index);
+	}
+
+	auto name_less =
+		[this] (const index_type& a, const index_type& b) {
+			return m_entries[a].first < m_entries[b].first;
+		};
+
+	// entries are appended, thus only new tail has to be sorted and merged
+	std::sort(m_sorted_index.begin() + sorted_size, m_sorted_index.end(), name_less);
+	std::inplace_merge(m_sorted_index.begin(), m_sorted_index.begin() + sorted_size, m_sorted_index.end(), name_less);
+
+	return m_sorted_index;
+}
+
+void metrics_table::clear() {
+	m_slots.assign(INITIAL_SLOTS_COUNT, slot{0, INVALID_INDEX});
+	m_mask = m_slots.size() - 1;
+
+	m_entries.clear();
+	m_sorted_index.clear();
+}
+
+}} // namespace handystats::internal
@@ -0,0 +1,93 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_METRICS_TABLE_IMPL_HPP_
+#define HANDYSTATS_METRICS_TABLE_IMPL_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <handystats/metrics.hpp>
+
+namespace handystats { namespace internal {
+
+/*
+ * Open-addressing hash table of metrics keyed by metric name.
+ * Entries are stored contiguously in insertion order and are never removed (except by clear()),
+ * so entry index stays valid and could be cached by callers.
+ * Slots keep full name hashes, thus probing and growth do not touch the names.
+ * Ordered by name iteration is available via sorted index, rebuilt only after insertions.
+ */
+class metrics_table {
+public:
+	typedef std::pair<std::string, metrics::metric_ptr_variant> value_type;
+	typedef uint32_t index_type;
+
+	typedef std::vector<value_type>::iterator iterator;
+	typedef std::vector<value_type>::const_iterator const_iterator;
+
+	static const index_type INVALID_INDEX = index_type(-1);
+
+	metrics_table();
+
+	// FNV-1a 64-bit, the same as handystats::fnv1a_hash
+	static uint64_t hash(const char* name, const size_t& length);
+
+	// Returns index of the entry with given name, inserting empty entry if not found.
+	index_type insert(const std::string& name);
+	index_type insert(const char* name, const size_t& length, const uint64_t& name_hash);
+
+	index_type find(const std::string& name) const;
+
+	metrics::metric_ptr_variant& operator[] (const std::string& name) {
+		return m_entries[insert(name)].second;
+	}
+
+	value_type& at(const index_type& index) {
+		return m_entries[index];
+	}
+
+	const value_type& at(const index_type& index) const {
+		return m_entries[index];
+	}
+
+	// Entries indices ordered by name
+	const std::vector<index_type>& sorted_index();
+
+	iterator begin() { return m_entries.begin(); }
+	iterator end() { return m_entries.end(); }
+	const_iterator begin() const { return m_entries.begin(); }
+	const_iterator end() const { return m_entries.end(); }
+	const_iterator cbegin() const { return m_entries.cbegin(); }
+	const_iterator cend() const { return m_entries.cend(); }
+
+	size_t size() const {
+		return m_entries.size();
+	}
+
+	bool empty() const {
+		return m_entries.empty();
+	}
+
+	void clear();
+
+private:
+	struct slot {
+		uint64_t hash;
+		index_type index;
+	};
+
+	index_type find(const char* name, const size_t& length, const uint64_t& name_hash) const;
+	void grow();
+
+	std::vector<slot> m_slots;
+	size_t m_mask;
+
+	std::vector<value_type> m_entries;
+	std::vector<index_type> m_sorted_index;
+};
+
+}} // namespace handystats::internal
+
+#endif // HANDYSTATS_METRICS_TABLE_IMPL_HPP_
@@ -0,0 +1,211 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <cmath>
+#include <algorithm>
+
+#include <handystats/quantile_sketch.hpp>
+
+#include "quantiles_sweep_impl.hpp"
+
+namespace handystats {
+
+quantile_sketch::quantile_sketch(const double& relative_accuracy, const size_t& max_buckets)
+	: m_relative_accuracy(relative_accuracy)
+	, m_max_buckets(std::max(max_buckets, size_t(1)))
+{
+	if (!(m_relative_accuracy > 0 && m_relative_accuracy < 1)) {
+		m_relative_accuracy = 0.01;
+	}
+
+	m_gamma = (1 + m_relative_accuracy) / (1 - m_relative_accuracy);
+	m_log_gamma = std::log(m_gamma);
+
+	reset();
+}
+
+void quantile_sketch::reset() {
+	m_buckets.reset();
+}
+
+void quantile_sketch::bucket_store::add(const int32_t& key, const double& count) {
+	const auto key_iter = std::lower_bound(keys.begin(), keys.end(), key);
+	const size_t index = key_iter - keys.begin();
+
+	if (key_iter != keys.end() && *key_iter == key) {
+		counts[index] += count;
+	}
+	else {
+		keys.insert(key_iter, key);
+		counts.insert(counts.begin() + index, count);
+	}
+}
+
+void quantile_sketch::bucket_store::collapse_lowest() {
+	counts[1] += counts[0];
+	keys.erase(keys.begin());
+	counts.erase(counts.begin());
+}
+
+void quantile_sketch::bucket_store::clear() {
+	keys.clear();
+	counts.clear();
+}
+
+double quantile_sketch::bucket_store::total() const {
+	double total = 0;
+	for (auto iter = counts.cbegin(); iter != counts.cend(); ++iter) {
+		total += *iter;
+	}
+	return total;
+}
+
+void quantile_sketch::bucket_store::divide(const double& divisor) {
+	for (auto& count : counts) {
+		count /= divisor;
+	}
+}
+
+int32_t quantile_sketch::key(const double& value) const {
+	return int32_t(std::ceil(std::log(value) / m_log_gamma));
+}
+
+double quantile_sketch::lower_bound(const int32_t& key) const {
+	return std::exp((key - 1) * m_log_gamma);
+}
+
+double quantile_sketch::value(const int32_t& key) const {
+	return 2 * std::exp(key * m_log_gamma) / (m_gamma + 1);
+}
+
+void quantile_sketch::add_to_store(bucket_store& store, const int32_t& key, const double& stored_count) {
+	store.add(key, stored_count);
+
+	// the larger store gives up its lowest magnitude buckets
+	bucket_store& positive = m_buckets.positive;
+	bucket_store& negative = m_buckets.negative;
+	while (positive.keys.size() + negative.keys.size() > m_max_buckets) {
+		bucket_store& larger = positive.keys.size() >= negative.keys.size() ? positive : negative;
+		if (larger.keys.size() < 2) {
+			break;
+		}
+		larger.collapse_lowest();
+	}
+}
+
+void quantile_sketch::add(const double& value, const double& count) {
+	if (value > 0) {
+		add_to_store(m_buckets.positive, key(value), m_buckets.stored(count));
+	}
+	else if (value < 0) {
+		add_to_store(m_buckets.negative, key(-value), m_buckets.stored(count));
+	}
+	else if (value == 0) {
+		m_buckets.zero += m_buckets.stored(count);
+	}
+	// NaN is skipped
+}
+
+void quantile_sketch::scale(const double& factor) {
+	m_buckets.scale(factor);
+}
+
+void quantile_sketch::merge(const quantile_sketch& other) {
+	if (other.m_gamma != m_gamma) {
+		const std::vector<bucket>& other_buckets = other.buckets();
+		for (auto iter = other_buckets.cbegin(); iter != other_buckets.cend(); ++iter) {
+			add(iter->lower + (iter->upper - iter->lower) / 2, iter->count);
+		}
+		return;
+	}
+
+	const bucket_store& other_positive = other.m_buckets.positive;
+	for (size_t index = 0; index < other_positive.keys.size(); ++index) {
+		add_to_store(m_buckets.positive, other_positive.keys[index],
+				m_buckets.stored(other_positive.counts[index], other.m_buckets)
+			);
+	}
+	const bucket_store& other_negative = other.m_buckets.negative;
+	for (size_t index = 0; index < other_negative.keys.size(); ++index) {
+		add_to_store(m_buckets.negative, other_negative.keys[index],
+				m_buckets.stored(other_negative.counts[index], other.m_buckets)
+			);
+	}
+	m_buckets.zero += m_buckets.stored(other.m_buckets.zero, other.m_buckets);
+}
+
+std::vector<quantile_sketch::bucket> quantile_sketch::buckets() const {
+	const bucket_store& positive = m_buckets.positive;
+	const bucket_store& negative = m_buckets.negative;
+	const double& weight = m_buckets.weight;
+
+	std::vector<bucket> result;
+	result.reserve(positive.keys.size() + negative.keys.size() + 1);
+
+	for (size_t index = negative.keys.size(); index > 0; --index) {
+		const int32_t& bucket_key = negative.keys[index - 1];
+		result.push_back(bucket{-lower_bound(bucket_key + 1), -lower_bound(bucket_key), negative.counts[index - 1] / weight});
+	}
+	if (m_buckets.zero > 0) {
+		result.push_back(bucket{0.0, 0.0, m_buckets.zero / weight});
+	}
+	for (size_t index = 0; index < positive.keys.size(); ++index) {
+		const int32_t& bucket_key = positive.keys[index];
+		result.push_back(bucket{lower_bound(bucket_key), lower_bound(bucket_key + 1), positive.counts[index] / weight});
+	}
+
+	return result;
+}
+
+double quantile_sketch::count() const {
+	return m_buckets.count();
+}
+
+double quantile_sketch::quantile(const double& probability) const {
+	return quantiles(std::vector<double>(1, probability))[0];
+}
+
+std::vector<double> quantile_sketch::quantiles(const std::vector<double>& probabilities) const {
+	std::vector<double> values(probabilities.size(), 0.0);
+
+	const double& total = m_buckets.total();
+	if (total <= 0) {
+		return values;
+	}
+
+	const bucket_store& positive = m_buckets.positive;
+	const bucket_store& negative = m_buckets.negative;
+
+	// bucket is represented by its value regardless of the position within it
+	quantiles_sweep sweep(probabilities, values, total);
+
+	for (size_t index = negative.keys.size(); index > 0; --index) {
+		const int32_t& bucket_key = negative.keys[index - 1];
+		sweep.visit(negative.counts[index - 1], [&] (const double&) { return -value(bucket_key); });
+	}
+	sweep.visit(m_buckets.zero, [] (const double&) { return 0.0; });
+	for (size_t index = 0; index < positive.keys.size(); ++index) {
+		const int32_t& bucket_key = positive.keys[index];
+		sweep.visit(positive.counts[index], [&] (const double&) { return value(bucket_key); });
+	}
+
+	double highest_value = 0;
+	if (!positive.keys.empty()) {
+		highest_value = value(positive.keys.back());
+	}
+	else if (m_buckets.zero <= 0 && !negative.keys.empty()) {
+		highest_value = -value(negative.keys.front());
+	}
+	sweep.finish(highest_value);
+
+	return values;
+}
+
+double quantile_sketch::relative_accuracy() const {
+	return m_relative_accuracy;
+}
+
+size_t quantile_sketch::max_buckets() const {
+	return m_max_buckets;
+}
+
+} // namespace handystats
@@ -0,0 +1,58 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_QUANTILES_SWEEP_IMPL_HPP_
+#define HANDYSTATS_QUANTILES_SWEEP_IMPL_HPP_
+
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+namespace handystats {
+
+/*
+ * Buckets are visited in ascending order, values of all (ascending) probabilities are found in a single pass.
+ * Counts are compared as stored, so total is the sum of stored counts.
+ */
+struct quantiles_sweep {
+	const std::vector<double>& probabilities;
+	std::vector<double>& values;
+	const double total;
+	size_t next;
+	double passed_count;
+
+	quantiles_sweep(const std::vector<double>& probabilities, std::vector<double>& values, const double& total)
+		: probabilities(probabilities)
+		, values(values)
+		, total(total)
+		, next(0)
+		, passed_count(0)
+	{}
+
+	double required_count() const {
+		return total * std::min(std::max(probabilities[next], 0.0), 1.0);
+	}
+
+	// value(z) is the bucket's value at z share of its count,
+	// it's computed only for the quantiles found in the bucket
+	template <typename Value>
+	void visit(const double& count, const Value& value) {
+		if (count <= 0) return;
+
+		while (next < probabilities.size() && required_count() <= passed_count + count) {
+			values[next++] = value(std::max(required_count() - passed_count, 0.0) / count);
+		}
+
+		passed_count += count;
+	}
+
+	// rounding leftover gets the highest value
+	void finish(const double& highest_value) {
+		while (next < probabilities.size()) {
+			values[next++] = highest_value;
+		}
+	}
+};
+
+} // namespace handystats
+
+#endif // HANDYSTATS_QUANTILES_SWEEP_IMPL_HPP_
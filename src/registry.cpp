@@ -0,0 +1,49 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+
+#include "registry_impl.hpp"
+
+namespace handystats {
+
+const metric_handle::id_type metric_handle::INVALID_ID;
+
+} // namespace handystats
+
+
+namespace handystats { namespace registry {
+
+// Registry is never cleared as handles could outlive handystats' initialize/finalize cycle.
+static std::mutex registry_mutex;
+static std::unordered_map<std::string, metric_handle::id_type> ids;
+// deque keeps references to its elements valid on push_back
+static std::deque<std::string> names;
+
+metric_handle::id_type resolve(const std::string& metric_name) {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+
+	auto id_iter = ids.find(metric_name);
+	if (id_iter != ids.end()) {
+		return id_iter->second;
+	}
+
+	const metric_handle::id_type id = names.size();
+	names.push_back(metric_name);
+	ids.insert(std::make_pair(metric_name, id));
+
+	return id;
+}
+
+const std::string& name(const metric_handle::id_type& id) {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	return names.at(id);
+}
+
+size_t size() {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	return names.size();
+}
+
+}} // namespace handystats::registry
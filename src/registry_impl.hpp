@@ -0,0 +1,24 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_REGISTRY_IMPL_HPP_
+#define HANDYSTATS_REGISTRY_IMPL_HPP_
+
+#include <string>
+
+#include <handystats/metric_handle.hpp>
+
+namespace handystats { namespace registry {
+
+// Returns id of the metric name, assigning the next free one on first request.
+// Ids are dense and never reused.
+metric_handle::id_type resolve(const std::string& metric_name);
+
+// Name of the metric with given id.
+// Returned reference stays valid for the whole life of the process.
+const std::string& name(const metric_handle::id_type& id);
+
+size_t size();
+
+}} // namespace handystats::registry
+
+#endif // HANDYSTATS_REGISTRY_IMPL_HPP_
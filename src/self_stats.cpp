@@ -0,0 +1,367 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#include <pthread.h>
+
+#include <handystats/atomic.hpp>
+#include <handystats/metrics/timer.hpp>
+
+#include "config_impl.hpp"
+
+#include "self_stats_impl.hpp"
+
+
+namespace {
+
+using handystats::self_stats::DESTINATION_TYPES_COUNT;
+using handystats::self_stats::EVENT_TYPES_COUNT;
+using handystats::self_stats::SAMPLE_PERIOD;
+
+static const size_t CACHE_LINE_SIZE = 64;
+
+// Single writer counter, read by the dumping thread
+struct __counter {
+	std::atomic<uint64_t> value;
+
+	void add(const uint64_t& delta) {
+		value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+
+	uint64_t load() const {
+		return value.load(std::memory_order_relaxed);
+	}
+};
+
+struct __event_counters {
+	__counter events[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT];
+	// sampled times in nanoseconds
+	__counter time_sum[DESTINATION_TYPES_COUNT];
+	__counter time_samples[DESTINATION_TYPES_COUNT];
+
+	void count(const char& destination_type, const char& event_type) {
+		if (size_t(destination_type) < DESTINATION_TYPES_COUNT && size_t(event_type) < EVENT_TYPES_COUNT) {
+			events[size_t(destination_type)][size_t(event_type)].add(1);
+		}
+	}
+
+	void time(const char& destination_type, const handystats::chrono::duration& d) {
+		if (size_t(destination_type) < DESTINATION_TYPES_COUNT) {
+			time_sum[size_t(destination_type)].add(
+					handystats::chrono::duration::convert_to(handystats::chrono::time_unit::NSEC, d).count()
+				);
+			time_samples[size_t(destination_type)].add(1);
+		}
+	}
+};
+
+/*
+ * Sampling interval is jittered (uniform in [0, 2 * SAMPLE_PERIOD)),
+ * so that events of periodic sequences are all sampled.
+ */
+struct __sampler {
+	uint32_t countdown;
+	uint32_t random_state;
+
+	bool sample() {
+		if (countdown > 0) {
+			--countdown;
+			return false;
+		}
+
+		// xorshift32, zero-initialized state is seeded first, as zero state is never left
+		if (random_state == 0) {
+			random_state = 2463534242U;
+		}
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+		countdown = random_state % (2 * SAMPLE_PERIOD);
+
+		return true;
+	}
+};
+
+/*
+ * Producer's counters are owned by a single thread.
+ * As event message pools they are never freed, block of an exited thread
+ * is marked orphaned and is adopted by the next new thread.
+ */
+struct __thread_counters {
+	__thread_counters()
+		: counters()
+		, sampler()
+		, orphaned(false)
+		, next(nullptr)
+	{}
+
+	__event_counters counters;
+	__sampler sampler;
+
+	std::atomic<bool> orphaned;
+	__thread_counters* next;
+
+	char pad[CACHE_LINE_SIZE];
+};
+
+struct __shard_counters {
+	__event_counters counters;
+	__sampler sampler;
+
+	char pad[CACHE_LINE_SIZE];
+};
+
+std::atomic<__thread_counters*> thread_counters_list(nullptr);
+__thread __thread_counters* thread_counters = nullptr;
+
+pthread_key_t counters_key;
+pthread_once_t counters_key_once = PTHREAD_ONCE_INIT;
+
+__shard_counters shard_counters[handystats::message_queue::MAX_SHARDS];
+
+// events of later destructors of the exiting thread are counted in another adopted block
+void orphan_thread_counters(void* counters) {
+	thread_counters = nullptr;
+	static_cast<__thread_counters*>(counters)->orphaned.store(true, std::memory_order_release);
+}
+
+void create_counters_key() {
+	pthread_key_create(&counters_key, orphan_thread_counters);
+}
+
+__thread_counters* adopt_thread_counters() {
+	pthread_once(&counters_key_once, create_counters_key);
+
+	__thread_counters* counters = nullptr;
+
+	for (__thread_counters* iter = thread_counters_list.load(std::memory_order_acquire); iter; iter = iter->next) {
+		bool orphaned = true;
+		if (iter->orphaned.load(std::memory_order_relaxed) &&
+				iter->orphaned.compare_exchange_strong(orphaned, false, std::memory_order_acq_rel))
+		{
+			counters = iter;
+			break;
+		}
+	}
+
+	if (!counters) {
+		counters = new __thread_counters();
+		counters->next = thread_counters_list.load(std::memory_order_acquire);
+		while (!thread_counters_list.compare_exchange_weak(counters->next, counters, std::memory_order_acq_rel)) {
+		}
+	}
+
+	pthread_setspecific(counters_key, counters);
+
+	return counters;
+}
+
+__thread_counters& current_thread_counters() {
+	if (!thread_counters) {
+		thread_counters = adopt_thread_counters();
+	}
+	return *thread_counters;
+}
+
+} // unnamed namespace
+
+
+namespace handystats { namespace self_stats {
+
+bool produced(const char& destination_type, const char& event_type) {
+	if (!config::metrics_dump_opts.self_stats) {
+		return false;
+	}
+
+	__thread_counters& counters = current_thread_counters();
+	counters.counters.count(destination_type, event_type);
+	return counters.sampler.sample();
+}
+
+void enqueue_time(const char& destination_type, const chrono::duration& time) {
+	current_thread_counters().counters.time(destination_type, time);
+}
+
+bool processed(const size_t& shard, const char& destination_type, const char& event_type) {
+	if (!config::metrics_dump_opts.self_stats) {
+		return false;
+	}
+
+	__shard_counters& counters = shard_counters[shard];
+	counters.counters.count(destination_type, event_type);
+	return counters.sampler.sample();
+}
+
+void process_time(const size_t& shard, const char& destination_type, const chrono::duration& time) {
+	shard_counters[shard].counters.time(destination_type, time);
+}
+
+const char* destination_type_name(const size_t& destination_type) {
+	static const char* names[DESTINATION_TYPES_COUNT] = {
+		"counter", "gauge", "timer", "attribute"
+	};
+
+	return destination_type < DESTINATION_TYPES_COUNT ? names[destination_type] : nullptr;
+}
+
+const char* event_type_name(const size_t& destination_type, const size_t& event_type) {
+	static const char* names[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT] = {
+		{ "init", "increment", "decrement" },
+		{ "init", "set" },
+		{ "init", "start", "stop", "discard", "heartbeat", "set" },
+		{ "set_bool", "set_int", "set_uint", "set_int64", "set_uint64", "set_double", "set_string" }
+	};
+
+	if (destination_type >= DESTINATION_TYPES_COUNT || event_type >= EVENT_TYPES_COUNT) {
+		return nullptr;
+	}
+
+	return names[destination_type][event_type];
+}
+
+void initialize() {
+	stats::initialize();
+}
+
+void finalize() {
+	stats::finalize();
+}
+
+
+namespace stats {
+
+metrics::counter produced[DESTINATION_TYPES_COUNT];
+metrics::counter produced_by_event[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT];
+metrics::counter processed[DESTINATION_TYPES_COUNT];
+metrics::counter processed_by_event[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT];
+metrics::gauge process_time[DESTINATION_TYPES_COUNT];
+metrics::gauge enqueue_time[DESTINATION_TYPES_COUNT];
+
+// Sums of producers' or shards' counters.
+// Counters are never reset, metrics are updated with the difference from the previous sums.
+struct totals {
+	uint64_t events[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT];
+	uint64_t time_sum[DESTINATION_TYPES_COUNT];
+	uint64_t time_samples[DESTINATION_TYPES_COUNT];
+
+	void add(const __event_counters& counters) {
+		for (size_t type = 0; type < DESTINATION_TYPES_COUNT; ++type) {
+			for (size_t event = 0; event < EVENT_TYPES_COUNT; ++event) {
+				events[type][event] += counters.events[type][event].load();
+			}
+			time_sum[type] += counters.time_sum[type].load();
+			time_samples[type] += counters.time_samples[type].load();
+		}
+	}
+};
+
+static totals producers_seen;
+static totals shards_seen;
+
+static totals producers_totals() {
+	totals result = totals();
+	for (__thread_counters* iter = thread_counters_list.load(std::memory_order_acquire); iter; iter = iter->next) {
+		result.add(iter->counters);
+	}
+	return result;
+}
+
+static totals shards_totals() {
+	totals result = totals();
+	for (size_t shard = 0; shard < message_queue::MAX_SHARDS; ++shard) {
+		result.add(shard_counters[shard].counters);
+	}
+	return result;
+}
+
+static void update_events(
+		const totals& current, const totals& seen,
+		metrics::counter* by_type, metrics::counter (*by_event)[EVENT_TYPES_COUNT],
+		const chrono::time_point& timestamp
+	)
+{
+	for (size_t type = 0; type < DESTINATION_TYPES_COUNT; ++type) {
+		for (size_t event = 0; event < EVENT_TYPES_COUNT; ++event) {
+			const uint64_t delta = current.events[type][event] - seen.events[type][event];
+			if (delta > 0) {
+				by_event[type][event].increment(delta, timestamp);
+				by_type[type].increment(delta, timestamp);
+			}
+			by_event[type][event].update_statistics(timestamp);
+		}
+		by_type[type].update_statistics(timestamp);
+	}
+}
+
+static void update_times(
+		const totals& current, const totals& seen,
+		metrics::gauge* by_type,
+		const chrono::time_point& timestamp
+	)
+{
+	for (size_t type = 0; type < DESTINATION_TYPES_COUNT; ++type) {
+		const uint64_t samples = current.time_samples[type] - seen.time_samples[type];
+		if (samples > 0) {
+			// events take fractions of timer's value unit, so average is kept fractional
+			const double nsec_per_unit =
+				chrono::duration::convert_to(chrono::time_unit::NSEC, chrono::duration(1, metrics::timer::value_unit)).count();
+			by_type[type].set(
+					(current.time_sum[type] - seen.time_sum[type]) / double(samples) / nsec_per_unit,
+					timestamp
+				);
+		}
+		else {
+			by_type[type].update_statistics(timestamp);
+		}
+	}
+}
+
+void update(const chrono::time_point& timestamp) {
+	const totals current_producers = producers_totals();
+	update_events(current_producers, producers_seen, produced, produced_by_event, timestamp);
+	update_times(current_producers, producers_seen, enqueue_time, timestamp);
+	producers_seen = current_producers;
+
+	const totals current_shards = shards_totals();
+	update_events(current_shards, shards_seen, processed, processed_by_event, timestamp);
+	update_times(current_shards, shards_seen, process_time, timestamp);
+	shards_seen = current_shards;
+}
+
+static void reset() {
+	config::metrics::counter events_opts;
+	events_opts.values.tags = statistics::tag::rate | statistics::tag::value;
+	events_opts.values.rate_unit = chrono::time_unit::SEC;
+	events_opts.values.moving_interval = chrono::duration(1, chrono::time_unit::SEC);
+
+	config::metrics::gauge time_opts;
+	time_opts.values.tags = statistics::tag::value | statistics::tag::moving_avg;
+	time_opts.values.moving_interval = chrono::duration(1, chrono::time_unit::SEC);
+
+	for (size_t type = 0; type < DESTINATION_TYPES_COUNT; ++type) {
+		produced[type] = metrics::counter(events_opts);
+		processed[type] = metrics::counter(events_opts);
+		for (size_t event = 0; event < EVENT_TYPES_COUNT; ++event) {
+			produced_by_event[type][event] = metrics::counter(events_opts);
+			processed_by_event[type][event] = metrics::counter(events_opts);
+		}
+
+		process_time[type] = metrics::gauge(time_opts);
+		enqueue_time[type] = metrics::gauge(time_opts);
+	}
+
+	// events counted before initialization are not accounted
+	producers_seen = producers_totals();
+	shards_seen = shards_totals();
+}
+
+void initialize() {
+	reset();
+}
+
+void finalize() {
+	reset();
+}
+
+} // namespace stats
+
+
+}} // namespace handystats::self_stats
@@ -0,0 +1,70 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_SELF_STATS_IMPL_HPP_
+#define HANDYSTATS_SELF_STATS_IMPL_HPP_
+
+#include <string>
+
+#include <handystats/chrono.hpp>
+#include <handystats/metrics/gauge.hpp>
+#include <handystats/metrics/counter.hpp>
+
+#include "message_queue_impl.hpp"
+
+/*
+ * Event path self-statistics (handystats.self.* metrics).
+ * Producers count events in per-thread blocks, processors count them per shard,
+ * so that accounting takes no shared writes. Only every SAMPLE_PERIOD-th event is timed.
+ * Counters are collected into metrics on dump.
+ */
+namespace handystats { namespace self_stats {
+
+static const size_t DESTINATION_TYPES_COUNT = message_queue::DESTINATION_TYPES_COUNT;
+// Max number of event types of a destination type
+static const size_t EVENT_TYPES_COUNT = 8;
+
+static const size_t SAMPLE_PERIOD = 64;
+
+// Producer side
+
+// Counts event sent by the calling thread, returns true if its push should be timed
+bool produced(const char& destination_type, const char& event_type);
+// Accounts timed push of the calling thread
+void enqueue_time(const char& destination_type, const chrono::duration& time);
+
+// Processor side, shard is modified by a single thread at a time
+
+// Counts event processed in the shard, returns true if its processing should be timed
+bool processed(const size_t& shard, const char& destination_type, const char& event_type);
+// Accounts timed processing of the shard's event
+void process_time(const size_t& shard, const char& destination_type, const chrono::duration& time);
+
+// Names used in metric names, nullptr for unknown types
+const char* destination_type_name(const size_t& destination_type);
+const char* event_type_name(const size_t& destination_type, const size_t& event_type);
+
+void initialize();
+void finalize();
+
+
+namespace stats {
+
+extern metrics::counter produced[DESTINATION_TYPES_COUNT];
+extern metrics::counter produced_by_event[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT];
+extern metrics::counter processed[DESTINATION_TYPES_COUNT];
+extern metrics::counter processed_by_event[DESTINATION_TYPES_COUNT][EVENT_TYPES_COUNT];
+extern metrics::gauge process_time[DESTINATION_TYPES_COUNT];
+extern metrics::gauge enqueue_time[DESTINATION_TYPES_COUNT];
+
+void update(const chrono::time_point&);
+
+void initialize();
+void finalize();
+
+} // namespace stats
+
+
+}} // namespace handystats::self_stats
+
+
+#endif // HANDYSTATS_SELF_STATS_IMPL_HPP_
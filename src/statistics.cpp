@@ -29,19 +29,88 @@ find_z(const long double& a, const long double& b, const long double& c) {
 
 namespace handystats {
 
+// histogram is materialized from bins for quantile and entropy
+template <>
+statistics::result_type<statistics::tag::histogram>::type
+statistics::get_impl<statistics::tag::histogram>() const;
+
 statistics::quantile_extractor::quantile_extractor(const statistics* const statistics)
-	: m_statistics(statistics)
-{}
+	: m_probabilities(statistics ? statistics->m_config.quantiles : std::vector<double>())
+	, m_values()
+	, m_values_computed(false)
+	, m_histogram()
+	, m_log_linear(statistics && statistics->log_linear())
+	, m_log_linear_histogram()
+	, m_sketch(statistics && statistics->sketch())
+	, m_quantile_sketch()
+{
+	if (m_log_linear) {
+		m_log_linear_histogram = statistics->current_log_linear_histogram();
+	}
+	else if (m_sketch) {
+		m_quantile_sketch = statistics->current_sketch();
+	}
+	else if (statistics) {
+		m_histogram = statistics->get_impl<tag::histogram>();
+	}
+}
 
 double statistics::quantile_extractor::at(const double& probability) const {
-	if (m_statistics == nullptr) {
-		return 0;
+	return sorted_at(std::vector<double>(1, probability))[0];
+}
+
+std::vector<double> statistics::quantile_extractor::at(const std::vector<double>& probabilities) const {
+	std::vector<size_t> order(probabilities.size());
+	for (size_t index = 0; index < order.size(); ++index) {
+		order[index] = index;
+	}
+	std::sort(order.begin(), order.end(),
+			[&probabilities] (const size_t& left, const size_t& right) {
+				return probabilities[left] < probabilities[right];
+			}
+		);
+
+	std::vector<double> sorted_probabilities(probabilities.size());
+	for (size_t index = 0; index < order.size(); ++index) {
+		sorted_probabilities[index] = probabilities[order[index]];
+	}
+
+	const std::vector<double>& sorted_values = sorted_at(sorted_probabilities);
+
+	std::vector<double> values(probabilities.size());
+	for (size_t index = 0; index < order.size(); ++index) {
+		values[order[index]] = sorted_values[index];
 	}
 
-	const auto& histogram = m_statistics->m_histogram;
+	return values;
+}
+
+const std::vector<double>& statistics::quantile_extractor::probabilities() const {
+	return m_probabilities;
+}
+
+const std::vector<double>& statistics::quantile_extractor::values() const {
+	if (!m_values_computed) {
+		m_values = at(m_probabilities);
+		m_values_computed = true;
+	}
+	return m_values;
+}
+
+// probabilities are ascending, so the histogram is walked once from the left
+std::vector<double> statistics::quantile_extractor::sorted_at(const std::vector<double>& probabilities) const {
+	if (m_log_linear) {
+		return m_log_linear_histogram.quantiles(probabilities);
+	}
+	if (m_sketch) {
+		return m_quantile_sketch.quantiles(probabilities);
+	}
+
+	const auto& histogram = m_histogram;
+	std::vector<double> values(probabilities.size(), 0.0);
 
 	if (histogram.size() == 0) {
-		return 0;
+		return values;
 	}
 
 	double moving_count = 0;
@@ -50,67 +119,86 @@ double statistics::quantile_extractor::at(const double& probability) const {
 	}
 
 	if (math_utils::cmp<double>(moving_count, 0) <= 0) {
-		return 0;
+		return values;
 	}
 
 	if (histogram.size() == 1) {
-		return std::get<BIN_CENTER>(histogram[0]);
+		std::fill(values.begin(), values.end(), std::get<BIN_CENTER>(histogram[0]));
+		return values;
 	}
 
-	double required_count = moving_count * probability;
-
-	int bin_index = -1;
-	for (; bin_index < (int)histogram.size(); ++bin_index) {
-		double volume =
+	// volume between centers of adjacent bins (or of the side bins and histogram's bounds)
+	auto volume = [&histogram] (const int& bin_index) {
+		return
 			(
 				(bin_index == -1 ? 0 : std::get<BIN_COUNT>(histogram[bin_index]))
 				+ (bin_index + 1 == histogram.size() ? 0 : std::get<BIN_COUNT>(histogram[bin_index + 1]))
 			) / 2.0;
+	};
 
-		if (math_utils::cmp(volume, required_count) > 0) break;
+	int bin_index = -1;
+	double passed_count = 0;
 
-		required_count -= volume;
-	}
+	for (size_t probability_index = 0; probability_index < probabilities.size(); ++probability_index) {
+		double required_count = moving_count * probabilities[probability_index] - passed_count;
 
-	bin_type left_bin;
-	bin_type right_bin;
+		for (; bin_index < (int)histogram.size(); ++bin_index) {
+			if (math_utils::cmp(volume(bin_index), required_count) > 0) break;
 
-	if (bin_index == -1) {
-		left_bin = bin_type{
-			2 * std::get<BIN_CENTER>(histogram[0]) -
-				math_utils::weighted_average(
-						std::get<BIN_CENTER>(histogram[0]), std::get<BIN_COUNT>(histogram[0]),
-						std::get<BIN_CENTER>(histogram[1]), std::get<BIN_COUNT>(histogram[1])
-					),
-			0,
-			time_point()
-		};
-		right_bin = histogram[0];
-	}
-	else if (bin_index + 1 < histogram.size()) {
-		left_bin = histogram[bin_index];
-		right_bin = histogram[bin_index + 1];
-	}
-	else {
-		left_bin = histogram[bin_index];
-		right_bin = bin_type{
-			2 * std::get<BIN_CENTER>(histogram[bin_index]) -
-				math_utils::weighted_average(
-						std::get<BIN_CENTER>(histogram[bin_index - 1]), std::get<BIN_COUNT>(histogram[bin_index - 1]),
-						std::get<BIN_CENTER>(histogram[bin_index]), std::get<BIN_COUNT>(histogram[bin_index])
-					),
-			0,
-			time_point()
-		};
-	}
+			required_count -= volume(bin_index);
+			passed_count += volume(bin_index);
+		}
+
+		// the whole volume is required, quantile is at the right bound
+		if (bin_index == (int)histogram.size()) {
+			--bin_index;
+			passed_count -= volume(bin_index);
+			required_count = volume(bin_index);
+		}
+
+		bin_type left_bin;
+		bin_type right_bin;
+
+		if (bin_index == -1) {
+			left_bin = bin_type{
+				2 * std::get<BIN_CENTER>(histogram[0]) -
+					math_utils::weighted_average(
+							std::get<BIN_CENTER>(histogram[0]), std::get<BIN_COUNT>(histogram[0]),
+							std::get<BIN_CENTER>(histogram[1]), std::get<BIN_COUNT>(histogram[1])
+						),
+				0,
+				time_point()
+			};
+			right_bin = histogram[0];
+		}
+		else if (bin_index + 1 < histogram.size()) {
+			left_bin = histogram[bin_index];
+			right_bin = histogram[bin_index + 1];
+		}
+		else {
+			left_bin = histogram[bin_index];
+			right_bin = bin_type{
+				2 * std::get<BIN_CENTER>(histogram[bin_index]) -
+					math_utils::weighted_average(
+							std::get<BIN_CENTER>(histogram[bin_index - 1]), std::get<BIN_COUNT>(histogram[bin_index - 1]),
+							std::get<BIN_CENTER>(histogram[bin_index]), std::get<BIN_COUNT>(histogram[bin_index])
+						),
+				0,
+				time_point()
+			};
+		}
+
+		const double& a = std::get<BIN_COUNT>(right_bin) - std::get<BIN_COUNT>(left_bin);
+		const double& b = 2 * std::get<BIN_COUNT>(left_bin);
+		const double& c = -2 * required_count;
 
-	const double& a = std::get<BIN_COUNT>(right_bin) - std::get<BIN_COUNT>(left_bin);
-	const double& b = 2 * std::get<BIN_COUNT>(left_bin);
-	const double& c = -2 * required_count;
+		const double& z = find_z(a, b, c);
 
-	const double& z = find_z(a, b, c);
+		values[probability_index] =
+			std::get<BIN_CENTER>(left_bin) + (std::get<BIN_CENTER>(right_bin) - std::get<BIN_CENTER>(left_bin)) * z;
+	}
 
-	return std::get<BIN_CENTER>(left_bin) + (std::get<BIN_CENTER>(right_bin) - std::get<BIN_CENTER>(left_bin)) * z;
+	return values;
 }
 
 const statistics::tag::type statistics::tag::empty;
@@ -128,6 +216,8 @@ const statistics::tag::type statistics::tag::quantile;
 const statistics::tag::type statistics::tag::timestamp;
 const statistics::tag::type statistics::tag::rate;
 const statistics::tag::type statistics::tag::entropy;
+const statistics::tag::type statistics::tag::moving_min;
+const statistics::tag::type statistics::tag::moving_max;
 
 statistics::tag::type statistics::tag::from_string(const std::string& tag_name) {
 	if (strcmp("value", tag_name.c_str()) == 0) {
@@ -172,6 +262,12 @@ statistics::tag::type statistics::tag::from_string(const std::string& tag_name)
 	if (strcmp("entropy", tag_name.c_str()) == 0) {
 		return entropy;
 	}
+	if (strcmp("moving-min", tag_name.c_str()) == 0) {
+		return moving_min;
+	}
+	if (strcmp("moving-max", tag_name.c_str()) == 0) {
+		return moving_max;
+	}
 
 	throw invalid_tag_error();
 }
@@ -180,10 +276,11 @@ bool statistics::enabled(const statistics::tag::type& t) const HANDYSTATS_NOEXCE
 	return m_config.tags & t;
 }
 
-bool statistics::computed(const statistics::tag::type& t) const HANDYSTATS_NOEXCEPT {
+// Dependencies of computed tags, resolved once into m_computed
+bool statistics::resolve_computed(const statistics::tag::type& t) const HANDYSTATS_NOEXCEPT {
 	switch (t) {
 	case tag::value:
-		return enabled(tag::value) || computed(tag::rate);
+		return enabled(tag::value) || resolve_computed(tag::rate);
 
 	case tag::min:
 		return enabled(tag::min);
@@ -192,34 +289,35 @@ bool statistics::computed(const statistics::tag::type& t) const HANDYSTATS_NOEXC
 		return enabled(tag::max);
 
 	case tag::count:
-		return enabled(tag::count) || computed(tag::avg);
+		return enabled(tag::count) || resolve_computed(tag::avg);
 
 	case tag::sum:
-		return enabled(tag::sum) || computed(tag::avg);
+		return enabled(tag::sum) || resolve_computed(tag::avg);
 
 	case tag::avg:
 		return enabled(tag::avg);
 
 	case tag::moving_count:
-		return enabled(tag::moving_count) || computed(tag::moving_avg);
+		return enabled(tag::moving_count) || resolve_computed(tag::moving_avg);
 
 	case tag::moving_sum:
-		return enabled(tag::moving_sum) || computed(tag::moving_avg);
+		return enabled(tag::moving_sum) || resolve_computed(tag::moving_avg);
 
 	case tag::moving_avg:
 		return enabled(tag::moving_avg);
 
 	case tag::histogram:
-		return enabled(tag::histogram) || computed(tag::quantile) || computed(tag::entropy);
+		return enabled(tag::histogram) || resolve_computed(tag::quantile) || resolve_computed(tag::entropy);
 
 	case tag::quantile:
 		return enabled(tag::quantile);
 
 	case tag::timestamp:
 		return enabled(tag::timestamp) ||
-			computed(tag::moving_count) || computed(tag::moving_sum) || computed(tag::moving_avg) ||
-			computed(tag::histogram) || computed(tag::quantile) ||
-			computed(tag::rate);
+			resolve_computed(tag::moving_count) || resolve_computed(tag::moving_sum) || resolve_computed(tag::moving_avg) ||
+			resolve_computed(tag::histogram) || resolve_computed(tag::quantile) ||
+			resolve_computed(tag::rate) ||
+			resolve_computed(tag::moving_min) || resolve_computed(tag::moving_max);
 
 	case tag::rate:
 		return enabled(tag::rate);
@@ -227,6 +325,12 @@ bool statistics::computed(const statistics::tag::type& t) const HANDYSTATS_NOEXC
 	case tag::entropy:
 		return enabled(tag::entropy);
 
+	case tag::moving_min:
+		return enabled(tag::moving_min);
+
+	case tag::moving_max:
+		return enabled(tag::moving_max);
+
 	default:
 		return false;
 	};
@@ -236,11 +340,51 @@ statistics::tag::type statistics::tags() const HANDYSTATS_NOEXCEPT {
 	return m_config.tags;
 }
 
+// Plans of computed tags of common configurations with specialized update kernels
+// default statistics of gauge, counter and timer
+static const statistics::tag::type DEFAULT_PLAN =
+	statistics::tag::value | statistics::tag::min | statistics::tag::max |
+	statistics::tag::count | statistics::tag::sum | statistics::tag::avg |
+	statistics::tag::moving_count | statistics::tag::moving_sum | statistics::tag::moving_avg |
+	statistics::tag::timestamp;
+// counter's rate
+static const statistics::tag::type RATE_PLAN =
+	statistics::tag::value | statistics::tag::rate | statistics::tag::timestamp;
+// default statistics with rate
+static const statistics::tag::type DEFAULT_RATE_PLAN = DEFAULT_PLAN | RATE_PLAN;
+// timer with histogram and quantiles
+static const statistics::tag::type HISTOGRAM_PLAN =
+	DEFAULT_PLAN | statistics::tag::histogram | statistics::tag::quantile;
+
 statistics::statistics(
 			const config::statistics& opts
 		)
 	: m_config(opts)
+	, m_computed(tag::empty)
 {
+	for (tag::type t = tag::value; t <= tag::moving_max; t <<= 1) {
+		if (resolve_computed(t)) {
+			m_computed |= t;
+		}
+	}
+
+	switch (m_computed) {
+	case DEFAULT_PLAN:
+		m_update_kernel = &statistics::update_kernel<DEFAULT_PLAN>;
+		break;
+	case RATE_PLAN:
+		m_update_kernel = &statistics::update_kernel<RATE_PLAN>;
+		break;
+	case DEFAULT_RATE_PLAN:
+		m_update_kernel = &statistics::update_kernel<DEFAULT_RATE_PLAN>;
+		break;
+	case HISTOGRAM_PLAN:
+		m_update_kernel = &statistics::update_kernel<HISTOGRAM_PLAN>;
+		break;
+	default:
+		m_update_kernel = &statistics::update_kernel<tag::empty>;
+	}
+
 	reset();
 }
 
@@ -252,178 +396,431 @@ void statistics::reset() {
 	m_count = 0;
 	m_moving_count = 0.0;
 	m_moving_sum = 0.0;
-	m_histogram.clear();
-	if (m_config.histogram_bins > 0) {
-		m_histogram.reserve(m_config.histogram_bins + 1);
-	}
+	m_bins.clear();
+	m_gaps.clear();
+	m_bins_seq = 0;
+	m_log_linear_histogram = log_linear_histogram(m_config.histogram_significant_digits);
+	m_quantile_sketch = quantile_sketch(m_config.sketch_relative_accuracy, m_config.sketch_max_buckets);
 	m_timestamp = time_point();
 	m_rate = 0;
 
 	m_data_timestamp = time_point();
+	m_interval_timestamp = time_point();
+
+	// windows of equal intervals share the ring
+	m_windows.clear();
+	m_interval_windows.clear();
+	if (window_computed()) {
+		for (auto interval = m_config.moving_intervals.cbegin(); interval != m_config.moving_intervals.cend(); ++interval) {
+			m_interval_windows.push_back(window_ring_index(*interval));
+		}
+	}
+	m_moving_window = moving_interval_windowed() ? window_ring_index(m_config.moving_interval) : m_windows.size();
 }
 
-double statistics::shift_interval_data(
-		const double& data, const statistics::time_point& data_timestamp,
+statistics::interval_shift statistics::shift_interval(
+		const statistics::time_point& data_timestamp,
+		const statistics::time_point& from_timestamp,
 		const statistics::time_point& timestamp
-	)
+	) const
 {
-	if (timestamp <= m_timestamp) return data;
+	interval_shift shift{false, 0, 0};
+
+	if (timestamp <= from_timestamp) return shift;
+
+	const auto& stale_interval = m_config.moving_interval - (timestamp - data_timestamp);
+	const auto& moving_interval = m_config.moving_interval - (from_timestamp - data_timestamp);
+
+	shift.shifted = true;
+	if (stale_interval.count() <= 0) return shift;
 
-	const auto& stale_interval = data_timestamp - (timestamp - m_config.moving_interval);
+	// timestamps could be of different units (e.g. default TICK time point and USEC timestamps),
+	// both intervals are compared in the finer one
+	const chrono::time_unit unit = std::min(stale_interval.unit(), moving_interval.unit(), std::less<chrono::time_unit>());
+	shift.stale_interval = chrono::duration::convert_to(unit, stale_interval).count();
+	shift.moving_interval = chrono::duration::convert_to(unit, moving_interval).count();
 
-	if (stale_interval.count() <= 0) return 0;
+	return shift;
+}
 
-	return data * stale_interval.count() / (m_config.moving_interval - (m_timestamp - data_timestamp)).count();
+statistics::interval_shift statistics::current_interval_shift() const {
+	return shift_interval(m_data_timestamp, m_interval_timestamp, m_timestamp);
 }
 
-double statistics::update_interval_data(
-		const double& data, const statistics::time_point& data_timestamp,
-		const statistics::value_type& value, const statistics::time_point& timestamp
+void statistics::update_interval_data(
+		const statistics::value_type& rate_delta, const statistics::value_type& value,
+		const statistics::time_point& timestamp
 	)
 {
-	if (timestamp <= m_timestamp) {
-		if (timestamp < m_timestamp - m_config.moving_interval) {
-			return data;
+	// windowed mode keeps rate, moving_count and moving_sum in window buckets
+	const bool rate = computed(tag::rate) && !windowed();
+	const bool moving_count = computed(tag::moving_count) && !windowed();
+	const bool moving_sum = computed(tag::moving_sum) && !windowed();
+	const bool histogram = log_linear();
+	const bool sketch = this->sketch();
+
+	if (!rate && !moving_count && !moving_sum && !histogram && !sketch) return;
+
+	if (timestamp > m_timestamp) {
+		const interval_shift& shift = shift_interval(m_data_timestamp, m_interval_timestamp, timestamp);
+
+		if (rate) m_rate = rate_delta + shift.apply(m_rate);
+		if (moving_count) m_moving_count = 1 + shift.apply(m_moving_count);
+		if (moving_sum) m_moving_sum = value + shift.apply(m_moving_sum);
+		if (histogram) {
+			m_log_linear_histogram.scale(shift.factor());
+			m_log_linear_histogram.add(value);
 		}
-		else {
-			return data + value;
+		if (sketch) {
+			m_quantile_sketch.scale(shift.factor());
+			m_quantile_sketch.add(value);
 		}
+
+		m_interval_timestamp = timestamp;
+		return;
 	}
-	else {
-		return value + shift_interval_data(data, data_timestamp, timestamp);
+
+	// late data is added to values as of m_timestamp,
+	// values are brought to m_timestamp anyway as data timestamp could change
+	const interval_shift& shift = current_interval_shift();
+	const bool expired = timestamp < m_timestamp - m_config.moving_interval;
+
+	if (rate) m_rate = shift.apply(m_rate) + (expired ? 0 : rate_delta);
+	if (moving_count) m_moving_count = shift.apply(m_moving_count) + (expired ? 0 : 1);
+	if (moving_sum) m_moving_sum = shift.apply(m_moving_sum) + (expired ? 0 : value);
+	if (histogram) {
+		m_log_linear_histogram.scale(shift.factor());
+		if (!expired) m_log_linear_histogram.add(value);
+	}
+	if (sketch) {
+		m_quantile_sketch.scale(shift.factor());
+		if (!expired) m_quantile_sketch.add(value);
 	}
 
-	return data;
+	m_interval_timestamp = m_timestamp;
 }
 
 
-void statistics::shift_histogram(const statistics::time_point& timestamp) {
-	if (m_config.histogram_bins == 0) return;
+bool statistics::windowed() const HANDYSTATS_NOEXCEPT {
+	return m_config.moving_window == config::statistics::BUCKETS;
+}
+
+bool statistics::moving_interval_windowed() const HANDYSTATS_NOEXCEPT {
+	return computed(tag::moving_min) || computed(tag::moving_max) ||
+		(windowed() && (computed(tag::moving_count) || computed(tag::moving_sum) || computed(tag::rate)));
+}
+
+bool statistics::window_computed() const HANDYSTATS_NOEXCEPT {
+	return moving_interval_windowed() ||
+		(!m_config.moving_intervals.empty() &&
+			(computed(tag::moving_count) || computed(tag::moving_sum) || computed(tag::rate)));
+}
+
+size_t statistics::window_ring_index(const statistics::duration& interval) {
+	for (size_t index = 0; index < m_windows.size(); ++index) {
+		if (m_windows[index].interval == interval) {
+			return index;
+		}
+	}
+
+	const int64_t& nsec = chrono::duration::convert_to(chrono::time_unit::NSEC, interval).count();
+	const window_bucket empty_bucket = {
+		std::numeric_limits<int64_t>::min(), 0, 0, 0,
+		std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::lowest()
+	};
+
+	window_ring ring;
+	ring.interval = interval;
+	ring.bucket_width = std::max<int64_t>(nsec / int64_t(std::max(m_config.moving_buckets, size_t(1))), 1);
+	ring.buckets.assign(std::max<int64_t>(nsec / ring.bucket_width, 1), empty_bucket);
+
+	m_windows.push_back(ring);
+	return m_windows.size() - 1;
+}
+
+int64_t statistics::window_index(const statistics::time_point& timestamp, const int64_t& bucket_width) const {
+	const int64_t& nsec = chrono::duration::convert_to(chrono::time_unit::NSEC, timestamp.time_since_epoch()).count();
+	// floor division for timestamps before epoch
+	return nsec >= 0 ? nsec / bucket_width : -((-nsec - 1) / bucket_width) - 1;
+}
 
-	for (auto bin = m_histogram.begin(); bin != m_histogram.end(); ++bin) {
-		auto& bin_count = std::get<BIN_COUNT>(*bin);
-		const auto& bin_timestamp = std::get<BIN_TIMESTAMP>(*bin);
+void statistics::update_window(
+		const statistics::value_type& rate_delta, const statistics::value_type& value,
+		const statistics::time_point& timestamp
+	)
+{
+	for (auto ring = m_windows.begin(); ring != m_windows.end(); ++ring) {
+		const int64_t& index = window_index(timestamp, ring->bucket_width);
+		const int64_t& window_size = ring->buckets.size();
+
+		// late data older than the window is dropped
+		if (timestamp < m_timestamp && index <= window_index(m_timestamp, ring->bucket_width) - window_size) continue;
+
+		window_bucket& bucket = ring->buckets[((index % window_size) + window_size) % window_size];
+		if (bucket.index > index) continue;
+
+		// bucket of expired sub-interval is reused
+		if (bucket.index < index) {
+			bucket.index = index;
+			bucket.count = 0;
+			bucket.sum = 0;
+			bucket.rate = 0;
+			bucket.min = std::numeric_limits<value_type>::max();
+			bucket.max = std::numeric_limits<value_type>::lowest();
+		}
 
-		bin_count = shift_interval_data(bin_count, bin_timestamp, timestamp);
+		bucket.count += 1;
+		bucket.sum += value;
+		bucket.rate += rate_delta;
+		bucket.min = std::min(bucket.min, value);
+		bucket.max = std::max(bucket.max, value);
 	}
 }
 
+statistics::window_bucket statistics::current_window(const window_ring& ring) const {
+	window_bucket window = {
+		0, 0, 0, 0,
+		std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::lowest()
+	};
+
+	const int64_t& current_index = window_index(m_timestamp, ring.bucket_width);
+	const int64_t& buckets = ring.buckets.size();
+	window.index = current_index;
+
+	for (auto bucket = ring.buckets.cbegin(); bucket != ring.buckets.cend(); ++bucket) {
+		if (bucket->index > current_index - buckets && bucket->index <= current_index) {
+			window.count += bucket->count;
+			window.sum += bucket->sum;
+			window.rate += bucket->rate;
+			window.min = std::min(window.min, bucket->min);
+			window.max = std::max(window.max, bucket->max);
+		}
+	}
+
+	return window;
+}
+
+int64_t statistics::current_window_length(const window_ring& ring) const {
+	const int64_t& nsec = chrono::duration::convert_to(chrono::time_unit::NSEC, m_timestamp.time_since_epoch()).count();
+	const int64_t& current_partial = nsec - window_index(m_timestamp, ring.bucket_width) * ring.bucket_width;
+	return std::max<int64_t>((int64_t(ring.buckets.size()) - 1) * ring.bucket_width + current_partial, 1);
+}
+
+double statistics::window_rate(const window_ring& ring, const window_bucket& window) const {
+	return window.rate * chrono::duration::convert_to(chrono::time_unit::NSEC, ring.interval).count() /
+		current_window_length(ring);
+}
+
+double statistics::rate_per_unit(const double& rate, const statistics::duration& interval) const {
+	if (std::less<chrono::time_unit>()(m_config.rate_unit, interval.unit())) {
+		const double& rate_factor = chrono::duration::convert_to(m_config.rate_unit, interval).count();
+		return rate / rate_factor;
+	}
+	else {
+		const double& rate_factor =
+			chrono::duration::convert_to(interval.unit(), chrono::duration(1, m_config.rate_unit)).count();
+		return rate * rate_factor / interval.count();
+	}
+}
+
+std::vector<statistics::moving_window_data> statistics::moving_windows() const {
+	std::vector<moving_window_data> windows;
+	windows.reserve(m_interval_windows.size());
+
+	for (size_t index = 0; index < m_interval_windows.size(); ++index) {
+		const window_ring& ring = m_windows[m_interval_windows[index]];
+		const window_bucket& window = current_window(ring);
+
+		moving_window_data data;
+		data.interval = m_config.moving_intervals[index];
+		data.moving_count = window.count;
+		data.moving_sum = window.sum;
+		data.moving_avg = window.count > 0 ? window.sum / window.count : 0;
+		data.moving_min = window.count > 0 ? window.min : 0;
+		data.moving_max = window.count > 0 ? window.max : 0;
+		data.rate = rate_per_unit(window_rate(ring, window), data.interval);
+		windows.push_back(data);
+	}
+
+	return windows;
+}
+
+// Bin's count has its own data and count timestamps
+double statistics::bin_count(const bin_data& bin, const statistics::time_point& timestamp) const {
+	return shift_interval(bin.timestamp, bin.count_timestamp, timestamp).apply(bin.count);
+}
+
 static double bin_merge_criteria(
-		const statistics::bin_type& left_bin,
-		const statistics::bin_type& right_bin
+		const statistics::value_type& left_center,
+		const statistics::value_type& right_center
 	)
 {
 	// possible variants:
 	// * distance between bins' centers
 	// * sum of bins' weights (number of elements)
 	// * other heuristics
+	// gaps are ordered once on insertion, so criteria could depend only on bins' centers
 
 	// distance between bins' centers
-	return std::get<statistics::BIN_CENTER>(right_bin) - std::get<statistics::BIN_CENTER>(left_bin);
+	return right_center - left_center;
+}
 
-	// sum of bins' weights
-	//return std::get<statistics::BIN_COUNT>(left_bin) + std::get<statistics::BIN_COUNT>(right_bin);
+void statistics::insert_gap(const statistics::bins_type::const_iterator& left, const statistics::bins_type::const_iterator& right) {
+	m_gaps.insert(gap_key{bin_merge_criteria(left->first.center, right->first.center), left->first});
+}
 
-	// heuristic -- minimum resulted bin square
-	//return (std::get<statistics::BIN_COUNT>(left_bin) + std::get<statistics::BIN_COUNT>(right_bin)) *
-	//	(std::get<statistics::BIN_CENTER>(right_bin) - std::get<statistics::BIN_CENTER>(left_bin));
+void statistics::erase_gap(const statistics::bins_type::const_iterator& left, const statistics::bins_type::const_iterator& right) {
+	m_gaps.erase(gap_key{bin_merge_criteria(left->first.center, right->first.center), left->first});
 }
 
-void statistics::update_histogram(const statistics::value_type& value, const statistics::time_point& timestamp)
-{
-	if (m_config.histogram_bins == 0) return;
+void statistics::merge_closest_bins(const statistics::time_point& timestamp) {
+	const auto left_iter = m_bins.find(m_gaps.begin()->left);
+	const auto right_iter = std::next(left_iter);
+	const auto next_iter = std::next(right_iter);
 
-	statistics::bin_type new_bin(value, 1.0, timestamp);
+	if (left_iter != m_bins.begin()) {
+		erase_gap(std::prev(left_iter), left_iter);
+	}
+	erase_gap(left_iter, right_iter);
+	if (next_iter != m_bins.end()) {
+		erase_gap(right_iter, next_iter);
+	}
 
-	auto insert_iter = std::lower_bound(m_histogram.begin(), m_histogram.end(), new_bin);
-	m_histogram.insert(insert_iter, new_bin);
+	const value_type& left_center = left_iter->first.center;
+	const value_type& right_center = right_iter->first.center;
+	const double left_count = bin_count(left_iter->second, timestamp);
+	const double right_count = bin_count(right_iter->second, timestamp);
 
-	shift_histogram(timestamp);
+	value_type center;
+	bin_data merged_bin;
+	merged_bin.count_timestamp = timestamp;
 
-	if (m_histogram.size() <= m_config.histogram_bins) {
-		return;
+	if (math_utils::cmp(left_count, 0.0) <= 0 &&
+			math_utils::cmp(right_count, 0.0) <= 0)
+	{
+		center = math_utils::weighted_average(left_center, 1, right_center, 1);
+		merged_bin.count = 0;
+		merged_bin.timestamp = time_point();
 	}
-
-	size_t best_merge_index = -1;
-	double best_merge_criteria = 0;
-	for (size_t index = 0; index < m_histogram.size() - 1; ++index) {
-		double merge_criteria = bin_merge_criteria(m_histogram[index], m_histogram[index + 1]);
-		if (best_merge_index == -1 || math_utils::cmp(merge_criteria, best_merge_criteria) < 0) {
-			best_merge_index = index;
-			best_merge_criteria = merge_criteria;
-		}
+	else {
+		center = math_utils::weighted_average(left_center, left_count, right_center, right_count);
+		merged_bin.count = left_count + right_count;
+		merged_bin.timestamp = std::max(left_iter->second.timestamp, right_iter->second.timestamp);
 	}
 
-	auto& left_bin = m_histogram[best_merge_index];
-	auto& right_bin = m_histogram[best_merge_index + 1];
+	// rounding must not move the bin past its neighbours
+	center = std::min(std::max(center, left_center), right_center);
 
-	if (math_utils::cmp(std::get<BIN_COUNT>(left_bin), 0.0) <= 0 &&
-			math_utils::cmp(std::get<BIN_COUNT>(right_bin), 0.0) <= 0)
-	{
-		std::get<BIN_CENTER>(left_bin) =
-			math_utils::weighted_average(
-					std::get<BIN_CENTER>(left_bin), 1,
-					std::get<BIN_CENTER>(right_bin), 1
-				);
+	// with equal centers merged bin takes the place of the bin with the same center
+	const bin_key merged_key{center, center == left_center ? left_iter->first.seq : right_iter->first.seq};
 
-		std::get<BIN_COUNT>(left_bin) = 0;
+	m_bins.erase(left_iter);
+	m_bins.erase(right_iter);
+	const auto merged_iter = m_bins.insert(next_iter, std::make_pair(merged_key, merged_bin));
 
-		std::get<BIN_TIMESTAMP>(left_bin) = time_point();
+	if (merged_iter != m_bins.begin()) {
+		insert_gap(std::prev(merged_iter), merged_iter);
 	}
-	else {
-		std::get<BIN_CENTER>(left_bin) =
-			math_utils::weighted_average(
-					std::get<BIN_CENTER>(left_bin), std::get<BIN_COUNT>(left_bin),
-					std::get<BIN_CENTER>(right_bin), std::get<BIN_COUNT>(right_bin)
-				);
+	if (next_iter != m_bins.end()) {
+		insert_gap(merged_iter, next_iter);
+	}
+}
+
+bool statistics::log_linear() const HANDYSTATS_NOEXCEPT {
+	return m_config.histogram_type == config::statistics::LOG_LINEAR && computed(tag::histogram);
+}
+
+log_linear_histogram statistics::current_log_linear_histogram() const {
+	log_linear_histogram histogram(m_log_linear_histogram);
+	histogram.scale(current_interval_shift().factor());
+	return histogram;
+}
+
+bool statistics::sketch() const HANDYSTATS_NOEXCEPT {
+	return m_config.histogram_type == config::statistics::SKETCH && computed(tag::histogram);
+}
+
+quantile_sketch statistics::current_sketch() const {
+	quantile_sketch sketch(m_quantile_sketch);
+	sketch.scale(current_interval_shift().factor());
+	return sketch;
+}
 
-		std::get<BIN_COUNT>(left_bin) += std::get<BIN_COUNT>(right_bin);
+void statistics::update_histogram(const statistics::value_type& value, const statistics::time_point& timestamp)
+{
+	if (m_config.histogram_bins == 0) return;
+
+	// m_timestamp is updated after the histogram, bin counts are shifted only forward
+	insert_bin(value, bin_data{1.0, timestamp, m_timestamp}, std::max(timestamp, m_timestamp));
+}
+
+void statistics::insert_bin(
+		const statistics::value_type& center, const statistics::bin_data& bin,
+		const statistics::time_point& counts_timestamp
+	)
+{
+	const auto bin_iter = m_bins.insert(std::make_pair(bin_key{center, m_bins_seq++}, bin)).first;
 
-		std::get<BIN_TIMESTAMP>(left_bin) = std::max(std::get<BIN_TIMESTAMP>(left_bin), std::get<BIN_TIMESTAMP>(right_bin));
+	const bool has_prev = bin_iter != m_bins.begin();
+	const bool has_next = std::next(bin_iter) != m_bins.end();
+
+	if (has_prev && has_next) {
+		erase_gap(std::prev(bin_iter), std::next(bin_iter));
+	}
+	if (has_prev) {
+		insert_gap(std::prev(bin_iter), bin_iter);
+	}
+	if (has_next) {
+		insert_gap(bin_iter, std::next(bin_iter));
 	}
 
-	m_histogram.erase(m_histogram.begin() + best_merge_index + 1);
+	if (m_bins.size() > m_config.histogram_bins) {
+		merge_closest_bins(counts_timestamp);
+	}
 }
 
 void statistics::update(const value_type& value, const time_point& timestamp) {
-	if (computed(tag::rate)) {
-		const value_type delta = value - m_value;
-		m_rate = update_interval_data(m_rate, m_data_timestamp, delta, timestamp);
+	(this->*m_update_kernel)(value, timestamp);
+}
+
+template <statistics::tag::type Plan>
+void statistics::update_kernel(const value_type& value, const time_point& timestamp) {
+	// generic kernel follows computed tags
+	const tag::type plan = Plan != tag::empty ? Plan : m_computed;
+
+	if (plan & (tag::rate | tag::moving_count | tag::moving_sum | tag::histogram)) {
+		update_interval_data(value - m_value, value, timestamp);
 	}
 
-	if (computed(tag::value)) {
+	if (!m_windows.empty()) {
+		update_window(value - m_value, value, timestamp);
+	}
+
+	if (plan & tag::value) {
 		m_value = value;
 	}
 
-	if (computed(tag::min)) {
+	if (plan & tag::min) {
 		m_min = std::min(m_min, value);
 	}
 
-	if (computed(tag::max)) {
+	if (plan & tag::max) {
 		m_max = std::max(m_max, value);
 	}
 
-	if (computed(tag::sum)) {
+	if (plan & tag::sum) {
 		m_sum += value;
 	}
 
-	if (computed(tag::count)) {
+	if (plan & tag::count) {
 		++m_count;
 	}
 
-	if (computed(tag::moving_count)) {
-		m_moving_count = update_interval_data(m_moving_count, m_data_timestamp, 1, timestamp);
-	}
-
-	if (computed(tag::moving_sum)) {
-		m_moving_sum = update_interval_data(m_moving_sum, m_data_timestamp, value, timestamp);
-	}
-
-	if (computed(tag::histogram)) {
+	if ((plan & tag::histogram) && !log_linear() && !sketch()) {
 		update_histogram(value, timestamp);
 	}
 
-	if (computed(tag::timestamp)) {
+	if (plan & tag::timestamp) {
 		m_timestamp = std::max(m_timestamp, timestamp);
 
 		m_data_timestamp = std::max(m_data_timestamp, timestamp);
@@ -433,24 +830,133 @@ void statistics::update(const value_type& value, const time_point& timestamp) {
 void statistics::update_time(const time_point& timestamp) {
 	if (timestamp <= m_timestamp) return;
 
-	if (computed(tag::rate)) {
-		m_rate = shift_interval_data(m_rate, m_data_timestamp, timestamp);
+	// moving statistics and histogram are shifted on read
+
+	if (computed(tag::timestamp)) {
+		m_timestamp = std::max(m_timestamp, timestamp);
 	}
+}
 
-	if (computed(tag::moving_count)) {
-		m_moving_count = shift_interval_data(m_moving_count, m_data_timestamp, timestamp);
+void statistics::merge(const statistics& other) {
+	if (&other == this) {
+		const statistics copy(other);
+		merge(copy);
+		return;
 	}
 
-	if (computed(tag::moving_sum)) {
-		m_moving_sum = shift_interval_data(m_moving_sum, m_data_timestamp, timestamp);
+	// other's moving data is taken as of the latest timestamp
+	const time_point& timestamp = std::max(m_timestamp, other.m_timestamp);
+	const interval_shift& shift = shift_interval(m_data_timestamp, m_interval_timestamp, timestamp);
+	const interval_shift& other_shift =
+		other.shift_interval(other.m_data_timestamp, other.m_interval_timestamp, timestamp);
+
+	if (computed(tag::value) && other.computed(tag::value) &&
+			(other.m_data_timestamp > m_data_timestamp || (m_count == 0 && other.m_count > 0)))
+	{
+		m_value = other.m_value;
 	}
 
-	if (computed(tag::histogram)) {
-		shift_histogram(timestamp);
+	if (computed(tag::min) && other.computed(tag::min)) {
+		m_min = std::min(m_min, other.m_min);
+	}
+
+	if (computed(tag::max) && other.computed(tag::max)) {
+		m_max = std::max(m_max, other.m_max);
+	}
+
+	if (computed(tag::sum) && other.computed(tag::sum)) {
+		m_sum += other.m_sum;
+	}
+
+	if (computed(tag::count) && other.computed(tag::count)) {
+		m_count += other.m_count;
+	}
+
+	// decayed moving data, stored as of m_interval_timestamp
+	if (computed(tag::rate) && other.computed(tag::rate)) {
+		m_rate = shift.apply(m_rate) + other_shift.apply(other.m_rate);
+	}
+	else {
+		m_rate = shift.apply(m_rate);
+	}
+
+	if (computed(tag::moving_count) && other.computed(tag::moving_count)) {
+		m_moving_count = shift.apply(m_moving_count) + other_shift.apply(other.m_moving_count);
+	}
+	else {
+		m_moving_count = shift.apply(m_moving_count);
+	}
+
+	if (computed(tag::moving_sum) && other.computed(tag::moving_sum)) {
+		m_moving_sum = shift.apply(m_moving_sum) + other_shift.apply(other.m_moving_sum);
+	}
+	else {
+		m_moving_sum = shift.apply(m_moving_sum);
+	}
+
+	m_log_linear_histogram.scale(shift.factor());
+	if (log_linear() && other.log_linear()) {
+		log_linear_histogram other_histogram(other.m_log_linear_histogram);
+		other_histogram.scale(other_shift.factor());
+		m_log_linear_histogram.merge(other_histogram);
+	}
+
+	m_quantile_sketch.scale(shift.factor());
+	if (sketch() && other.sketch()) {
+		quantile_sketch other_sketch(other.m_quantile_sketch);
+		other_sketch.scale(other_shift.factor());
+		m_quantile_sketch.merge(other_sketch);
+	}
+
+	m_interval_timestamp = timestamp;
+
+	// adaptive histogram's bins are inserted with their counts as of the latest timestamp
+	if (computed(tag::histogram) && !log_linear() && !sketch() && m_config.histogram_bins > 0 &&
+			other.computed(tag::histogram) && !other.log_linear() && !other.sketch())
+	{
+		for (auto bin_iter = other.m_bins.cbegin(); bin_iter != other.m_bins.cend(); ++bin_iter) {
+			insert_bin(
+					bin_iter->first.center,
+					bin_data{other.bin_count(bin_iter->second, timestamp), bin_iter->second.timestamp, timestamp},
+					timestamp
+				);
+		}
+	}
+
+	// window buckets of rings of the same interval and width are merged by sub-interval
+	for (auto ring = m_windows.begin(); ring != m_windows.end(); ++ring) {
+		const auto& other_ring = std::find_if(other.m_windows.cbegin(), other.m_windows.cend(),
+				[&ring] (const window_ring& other_ring) {
+					return other_ring.interval == ring->interval && other_ring.bucket_width == ring->bucket_width;
+				}
+			);
+		if (other_ring == other.m_windows.cend()) continue;
+
+		const int64_t& window_size = ring->buckets.size();
+		const int64_t& current_index = window_index(timestamp, ring->bucket_width);
+
+		for (auto other_bucket = other_ring->buckets.cbegin(); other_bucket != other_ring->buckets.cend(); ++other_bucket) {
+			if (other_bucket->count <= 0 || other_bucket->index <= current_index - window_size) continue;
+
+			window_bucket& bucket = ring->buckets[((other_bucket->index % window_size) + window_size) % window_size];
+			if (bucket.index > other_bucket->index) continue;
+
+			if (bucket.index < other_bucket->index) {
+				bucket = *other_bucket;
+				continue;
+			}
+
+			bucket.count += other_bucket->count;
+			bucket.sum += other_bucket->sum;
+			bucket.rate += other_bucket->rate;
+			bucket.min = std::min(bucket.min, other_bucket->min);
+			bucket.max = std::max(bucket.max, other_bucket->max);
+		}
 	}
 
 	if (computed(tag::timestamp)) {
-		m_timestamp = std::max(m_timestamp, timestamp);
+		m_timestamp = timestamp;
+		m_data_timestamp = std::max(m_data_timestamp, other.m_data_timestamp);
 	}
 }
 
@@ -537,7 +1043,10 @@ statistics::result_type<statistics::tag::moving_count>::type
 statistics::get_impl<statistics::tag::moving_count>() const
 {
 	if (computed(tag::moving_count)) {
-		return m_moving_count;
+		if (windowed()) {
+			return current_window(m_windows[m_moving_window]).count;
+		}
+		return current_interval_shift().apply(m_moving_count);
 	}
 	else {
 		throw invalid_tag_error();
@@ -549,7 +1058,10 @@ statistics::result_type<statistics::tag::moving_sum>::type
 statistics::get_impl<statistics::tag::moving_sum>() const
 {
 	if (computed(tag::moving_sum)) {
-		return m_moving_sum;
+		if (windowed()) {
+			return current_window(m_windows[m_moving_window]).sum;
+		}
+		return current_interval_shift().apply(m_moving_sum);
 	}
 	else {
 		throw invalid_tag_error();
@@ -561,11 +1073,24 @@ statistics::result_type<statistics::tag::moving_avg>::type
 statistics::get_impl<statistics::tag::moving_avg>() const
 {
 	if (computed(tag::moving_avg)) {
-		if (math_utils::cmp<result_type<tag::moving_count>::type>(m_moving_count, 0) <= 0) {
+		double moving_count = 0;
+		double moving_sum = 0;
+		if (windowed()) {
+			const window_bucket& window = current_window(m_windows[m_moving_window]);
+			moving_count = window.count;
+			moving_sum = window.sum;
+		}
+		else {
+			const interval_shift& shift = current_interval_shift();
+			moving_count = shift.apply(m_moving_count);
+			moving_sum = shift.apply(m_moving_sum);
+		}
+
+		if (math_utils::cmp<result_type<tag::moving_count>::type>(moving_count, 0) <= 0) {
 			return 0;
 		}
 		else {
-			return result_type<tag::moving_avg>::type(m_moving_sum) / m_moving_count;
+			return result_type<tag::moving_avg>::type(moving_sum) / moving_count;
 		}
 	}
 	else {
@@ -577,8 +1102,28 @@ template <>
 statistics::result_type<statistics::tag::histogram>::type
 statistics::get_impl<statistics::tag::histogram>() const
 {
-	if (computed(tag::histogram)) {
-		return m_histogram;
+	if (log_linear() || sketch()) {
+		// buckets are reported by their centers, bucket's timestamp is the last data timestamp
+		const std::vector<value_bucket>& buckets =
+			log_linear() ? current_log_linear_histogram().buckets() : current_sketch().buckets();
+		histogram_type histogram;
+		histogram.reserve(buckets.size());
+		for (auto bucket = buckets.cbegin(); bucket != buckets.cend(); ++bucket) {
+			histogram.push_back(
+					bin_type(bucket->lower + (bucket->upper - bucket->lower) / 2, bucket->count, m_data_timestamp)
+				);
+		}
+		return histogram;
+	}
+	else if (computed(tag::histogram)) {
+		histogram_type histogram;
+		histogram.reserve(m_bins.size());
+		for (auto bin_iter = m_bins.cbegin(); bin_iter != m_bins.cend(); ++bin_iter) {
+			histogram.push_back(
+					bin_type(bin_iter->first.center, bin_count(bin_iter->second, m_timestamp), bin_iter->second.timestamp)
+				);
+		}
+		return histogram;
 	}
 	else {
 		throw invalid_tag_error();
@@ -614,18 +1159,16 @@ statistics::result_type<statistics::tag::rate>::type
 statistics::get_impl<statistics::tag::rate>() const
 {
 	if (computed(tag::rate)) {
-		if (std::less<chrono::time_unit>()(m_config.rate_unit, m_config.moving_interval.unit())) {
-			const double& rate_factor =
-				chrono::duration::convert_to(m_config.rate_unit, m_config.moving_interval).count();
-			return double(m_rate) / rate_factor;
+		double rate = 0;
+		if (windowed()) {
+			// windowed rate is brought to the full moving interval
+			const window_ring& ring = m_windows[m_moving_window];
+			rate = window_rate(ring, current_window(ring));
 		}
 		else {
-			const double& rate_factor =
-				chrono::duration::convert_to(m_config.moving_interval.unit(),
-						chrono::duration(1, m_config.rate_unit)
-					).count();
-			return double(m_rate) * rate_factor / m_config.moving_interval.count();
+			rate = current_interval_shift().apply(m_rate);
 		}
+		return rate_per_unit(rate, m_config.moving_interval);
 	}
 	else {
 		throw invalid_tag_error();
@@ -637,7 +1180,7 @@ statistics::result_type<statistics::tag::entropy>::type
 statistics::get_impl<statistics::tag::entropy>() const
 {
 	if (computed(tag::entropy)) {
-		const auto& histogram = m_histogram;
+		const auto& histogram = get_impl<tag::histogram>();
 
 		if (histogram.size() <= 1) {
 			return 0;
@@ -683,6 +1226,32 @@ statistics::get_impl<statistics::tag::entropy>() const
 	}
 }
 
+template <>
+statistics::result_type<statistics::tag::moving_min>::type
+statistics::get_impl<statistics::tag::moving_min>() const
+{
+	if (computed(tag::moving_min)) {
+		const window_bucket& window = current_window(m_windows[m_moving_window]);
+		return window.count > 0 ? window.min : 0;
+	}
+	else {
+		throw invalid_tag_error();
+	}
+}
+
+template <>
+statistics::result_type<statistics::tag::moving_max>::type
+statistics::get_impl<statistics::tag::moving_max>() const
+{
+	if (computed(tag::moving_max)) {
+		const window_bucket& window = current_window(m_windows[m_moving_window]);
+		return window.count > 0 ? window.max : 0;
+	}
+	else {
+		throw invalid_tag_error();
+	}
+}
+
 // depricated iface
 statistics::value_type statistics::value() const
 {
@@ -18,9 +18,9 @@ TEST(AttributeEventsTest, TestAttributeSetDoubleEvent) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_DOUBLE);
 	ASSERT_NEAR(
-			boost::get<double>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			*reinterpret_cast<double*>(&message->event_data),
 			value,
 			1E-6
 		);
@@ -36,9 +36,9 @@ TEST(AttributeEventsTest, TestAttributeSetBoolEvent) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_BOOL);
 	ASSERT_EQ(
-			boost::get<bool>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			*reinterpret_cast<bool*>(&message->event_data),
 			value
 		);
 
@@ -53,9 +53,9 @@ TEST(AttributeEventsTest, TestAttributeSetIntEvent) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_INT);
 	ASSERT_EQ(
-			boost::get<int>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			*reinterpret_cast<int*>(&message->event_data),
 			value
 		);
 
@@ -70,9 +70,9 @@ TEST(AttributeEventsTest, TestAttributeSetUintEvent) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_UINT);
 	ASSERT_EQ(
-			boost::get<unsigned>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			*reinterpret_cast<unsigned*>(&message->event_data),
 			value
 		);
 
@@ -87,9 +87,9 @@ TEST(AttributeEventsTest, TestAttributeSetInt64Event) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_INT64);
 	ASSERT_EQ(
-			boost::get<int64_t>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			*reinterpret_cast<int64_t*>(&message->event_data),
 			value
 		);
 
@@ -104,9 +104,9 @@ TEST(AttributeEventsTest, TestAttributeSetUint64Event) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_UINT64);
 	ASSERT_EQ(
-			boost::get<uint64_t>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			*reinterpret_cast<uint64_t*>(&message->event_data),
 			value
 		);
 
@@ -121,11 +121,38 @@ TEST(AttributeEventsTest, TestAttributeSetStringEvent) {
 	ASSERT_EQ(message->destination_name, attribute_name);
 	ASSERT_EQ(message->destination_type, handystats::events::event_destination_type::ATTRIBUTE);
 
-	ASSERT_EQ(message->event_type, event_type::SET);
+	ASSERT_EQ(message->event_type, event_type::SET_STRING);
 	ASSERT_EQ(
-			boost::get<std::string>(*reinterpret_cast<handystats::metrics::attribute::value_type*>(message->event_data)),
+			message->event_string,
 			value
 		);
 
 	delete_event_message(message);
 }
+
+TEST(AttributeEventsTest, TestAttributeSetStringEventWithoutVariant) {
+	const char* attribute_name = "attr.test";
+	const std::string value = "attr.test.value";
+	auto message = create_set_event(attribute_name, value, handystats::metrics::attribute::clock::now());
+
+	ASSERT_EQ(message->destination_name, attribute_name);
+	ASSERT_EQ(message->event_type, event_type::SET_STRING);
+	ASSERT_EQ(message->event_string, value);
+
+	delete_event_message(message);
+}
+
+TEST(AttributeEventsTest, TestAttributeSetEventProcessing) {
+	const char* attribute_name = "attr.test";
+	handystats::metrics::attribute attribute;
+
+	auto int_message = create_set_event(attribute_name, handystats::metrics::attribute::value_type(-5), handystats::metrics::attribute::clock::now());
+	process_event(attribute, *int_message);
+	ASSERT_EQ(boost::get<int>(attribute.value()), -5);
+	delete_event_message(int_message);
+
+	auto string_message = create_set_event(attribute_name, std::string("value"), handystats::metrics::attribute::clock::now());
+	process_event(attribute, *string_message);
+	ASSERT_EQ(boost::get<std::string>(attribute.value()), "value");
+	delete_event_message(string_message);
+}
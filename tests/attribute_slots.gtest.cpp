@@ -0,0 +1,170 @@
+#include <vector>
+#include <thread>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "message_queue_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class AttributeSlotsTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(AttributeSlotsTest, HandleSetsBypassQueue) {
+	auto int_handle = HANDY_ATTRIBUTE_HANDLE("slot.attribute.int");
+	auto string_handle = HANDY_ATTRIBUTE_HANDLE("slot.attribute.string");
+
+	for (int step = 0; step <= 1000; ++step) {
+		HANDY_ATTRIBUTE_SET_INT(int_handle, step);
+		HANDY_ATTRIBUTE_SET_STRING(string_handle, "build-" + std::to_string(step));
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(boost::get<int>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.attribute.int")).value()), 1000);
+	ASSERT_EQ(
+			boost::get<std::string>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.attribute.string")).value()),
+			"build-1000"
+		);
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handystats.message_queue.pop_count"))
+				.values().get<handystats::statistics::tag::value>(),
+			0
+		);
+}
+
+TEST_F(AttributeSlotsTest, UnchangedValueIsKept) {
+	auto attribute_handle = HANDY_ATTRIBUTE_HANDLE("slot.attribute");
+
+	HANDY_ATTRIBUTE_SET_DOUBLE(attribute_handle, 0.5);
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	// value of other type is not equal
+	HANDY_ATTRIBUTE_SET_INT64(attribute_handle, 1);
+	HANDY_ATTRIBUTE_SET_INT64(attribute_handle, 1);
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(boost::get<int64_t>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.attribute")).value()), 1);
+
+	// unchanged value after dump is still in place
+	HANDY_ATTRIBUTE_SET_INT64(attribute_handle, 1);
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(boost::get<int64_t>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.attribute")).value()), 1);
+}
+
+TEST_F(AttributeSlotsTest, ValueIsSetAgainAfterReinitialization) {
+	auto attribute_handle = HANDY_ATTRIBUTE_HANDLE("slot.reinit.attribute");
+
+	HANDY_ATTRIBUTE_SET_BOOL(attribute_handle, true);
+
+	HANDY_FINALIZE();
+	HANDY_CONFIG_JSON(
+			"{\
+				\"metrics-dump\": {\
+					\"interval\": 10\
+				}\
+			}"
+		);
+	HANDY_INIT();
+
+	// metrics are cleared on finalization, so the same value is not skipped
+	HANDY_ATTRIBUTE_SET_BOOL(attribute_handle, true);
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(boost::get<bool>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.reinit.attribute")).value()), true);
+}
+
+TEST_F(AttributeSlotsTest, MultipleProducerThreads) {
+	const size_t THREADS_COUNT = 8;
+
+	auto attribute_handle = HANDY_ATTRIBUTE_HANDLE("slot.shared.attribute");
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		producers[index] = std::thread(
+				[index, &attribute_handle] () {
+					for (int step = 0; step < 1000; ++step) {
+						HANDY_ATTRIBUTE_SET_STRING(attribute_handle, "config-" + std::to_string(step % 3));
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	const std::string value =
+		boost::get<std::string>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.shared.attribute")).value());
+	ASSERT_TRUE(value == "config-0" || value == "config-1" || value == "config-2");
+}
+
+TEST_F(AttributeSlotsTest, HandleAndNameSetsAreOrdered) {
+	auto attribute_handle = HANDY_ATTRIBUTE_HANDLE("slot.ordered.attribute");
+
+	// set through the slot is applied on dump, after the queued one
+	HANDY_ATTRIBUTE_SET_STRING(attribute_handle, "A");
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+	HANDY_ATTRIBUTE_SET_STRING("slot.ordered.attribute", "B");
+	handystats::message_queue::wait_until_empty();
+	HANDY_ATTRIBUTE_SET_STRING(attribute_handle, "A");
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(
+			boost::get<std::string>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.ordered.attribute")).value()),
+			"A"
+		);
+
+	// queued set is later than the slot's pending one
+	HANDY_ATTRIBUTE_SET_STRING(attribute_handle, "C");
+	HANDY_ATTRIBUTE_SET_STRING("slot.ordered.attribute", "D");
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(
+			boost::get<std::string>(boost::get<handystats::metrics::attribute>(metrics_dump->at("slot.ordered.attribute")).value()),
+			"D"
+		);
+}
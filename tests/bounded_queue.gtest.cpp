@@ -0,0 +1,140 @@
+#include <chrono>
+#include <thread>
+#include <handystats/atomic.hpp>
+
+#include <gtest/gtest.h>
+
+#include <handystats/chrono.hpp>
+
+#include "events/event_message_impl.hpp"
+#include "message_queue_impl.hpp"
+#include "config_impl.hpp"
+
+#include <handystats/module.h>
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+namespace handystats {
+
+extern std::atomic<bool> enabled_flag;
+
+} // namespace handystats
+
+
+class BoundedQueueTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		handystats::config::message_queue_opts = handystats::config::message_queue();
+		handystats::config::message_queue_opts.capacity = CAPACITY;
+
+		handystats::message_queue::initialize();
+		handystats::enabled_flag.store(true, std::memory_order_release);
+	}
+	virtual void TearDown() {
+		handystats::message_queue::finalize();
+		handystats::enabled_flag.store(false, std::memory_order_release);
+
+		handystats::config::message_queue_opts = handystats::config::message_queue();
+	}
+
+	static const size_t CAPACITY = 100;
+};
+
+const size_t BoundedQueueTest::CAPACITY;
+
+static uint64_t dropped(const size_t& type) {
+	return handystats::message_queue::dropped_count[type].load();
+}
+
+TEST_F(BoundedQueueTest, DropNewestKeepsCapacity) {
+	handystats::config::message_queue_opts.overload_policy = handystats::config::message_queue::DROP_NEWEST;
+
+	for (size_t step = 0; step < 2 * CAPACITY; ++step) {
+		TEST_COUNTER_INCREMENT("counter.name", 1);
+	}
+	for (size_t step = 0; step < 10; ++step) {
+		TEST_GAUGE_SET("gauge.name", step);
+	}
+
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::COUNTER), CAPACITY);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::GAUGE), 10);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::TIMER), 0);
+
+	handystats::message_queue::stats::update(handystats::chrono::tsc_clock::now());
+
+	ASSERT_EQ(handystats::message_queue::stats::dropped.values().get<handystats::statistics::tag::value>(), CAPACITY + 10);
+	ASSERT_EQ(
+			handystats::message_queue::stats::dropped_by_type[handystats::events::event_destination_type::GAUGE]
+				.values().get<handystats::statistics::tag::value>(),
+			10
+		);
+
+	// dropped messages are accounted once
+	handystats::message_queue::stats::update(handystats::chrono::tsc_clock::now());
+	ASSERT_EQ(handystats::message_queue::stats::dropped.values().get<handystats::statistics::tag::value>(), CAPACITY + 10);
+
+	// room is available again after pop
+	delete_event_message(handystats::message_queue::pop());
+	TEST_COUNTER_INCREMENT("counter.name", 1);
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::COUNTER), CAPACITY);
+}
+
+TEST_F(BoundedQueueTest, SampleAboveHalfCapacity) {
+	handystats::config::message_queue_opts.overload_policy = handystats::config::message_queue::SAMPLE;
+	handystats::config::message_queue_opts.sample_every = 10;
+
+	for (size_t step = 0; step < CAPACITY / 2; ++step) {
+		TEST_COUNTER_INCREMENT("counter.name", 1);
+	}
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY / 2);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::COUNTER), 0);
+
+	for (size_t step = 0; step < 100; ++step) {
+		TEST_COUNTER_INCREMENT("counter.name", 1);
+	}
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY / 2 + 10);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::COUNTER), 90);
+
+	// full queue drops everything
+	for (size_t step = 0; step < 100 * CAPACITY; ++step) {
+		TEST_COUNTER_INCREMENT("counter.name", 1);
+	}
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY);
+}
+
+TEST_F(BoundedQueueTest, BlockWithTimeout) {
+	handystats::config::message_queue_opts.overload_policy = handystats::config::message_queue::BLOCK;
+	handystats::config::message_queue_opts.block_timeout =
+		handystats::chrono::duration(10, handystats::chrono::time_unit::MSEC);
+
+	for (size_t step = 0; step < CAPACITY; ++step) {
+		TEST_COUNTER_INCREMENT("counter.name", 1);
+	}
+
+	auto start_time = std::chrono::steady_clock::now();
+	TEST_COUNTER_INCREMENT("counter.name", 1);
+	ASSERT_GE(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds(10));
+
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::COUNTER), 1);
+
+	// blocked producer proceeds as soon as consumer makes room
+	std::thread consumer(
+			[] () {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				delete_event_message(handystats::message_queue::pop());
+			}
+		);
+
+	handystats::config::message_queue_opts.block_timeout = handystats::chrono::duration();
+	TEST_COUNTER_INCREMENT("counter.name", 1);
+	consumer.join();
+
+	ASSERT_EQ(handystats::message_queue::size(), CAPACITY);
+	ASSERT_EQ(dropped(handystats::events::event_destination_type::COUNTER), 1);
+}
@@ -0,0 +1,126 @@
+#include <vector>
+#include <set>
+#include <thread>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "events/event_message_impl.hpp"
+#include "events/event_message_pool_impl.hpp"
+#include "events/counter_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+using namespace handystats::events;
+
+static int64_t allocated_messages() {
+	pool::stats::update(handystats::chrono::tsc_clock::now());
+	return pool::stats::allocated.values().get<handystats::statistics::tag::value>();
+}
+
+TEST(EventMessagePoolTest, ReleasedMessagesAreReused) {
+	const size_t MESSAGES_COUNT = 1000;
+
+	std::vector<event_message*> messages(MESSAGES_COUNT);
+	for (auto& message : messages) {
+		message = pool::acquire();
+	}
+	ASSERT_EQ(std::set<event_message*>(messages.begin(), messages.end()).size(), MESSAGES_COUNT);
+
+	const auto allocated = allocated_messages();
+	ASSERT_GE(allocated, MESSAGES_COUNT);
+
+	for (int round = 0; round < 10; ++round) {
+		for (auto* message : messages) {
+			pool::release(message);
+		}
+		for (auto& message : messages) {
+			message = pool::acquire();
+		}
+	}
+
+	for (auto* message : messages) {
+		pool::release(message);
+	}
+
+	ASSERT_EQ(allocated_messages(), allocated);
+}
+
+TEST(EventMessagePoolTest, MessagesReleasedByOtherThreadReturnToOwner) {
+	const size_t MESSAGES_COUNT = 500;
+
+	std::vector<event_message*> messages(MESSAGES_COUNT);
+	for (auto& message : messages) {
+		message = counter::create_increment_event(std::string("pool.counter"), 1, handystats::chrono::tsc_clock::now());
+	}
+
+	const auto allocated = allocated_messages();
+
+	for (int round = 0; round < 10; ++round) {
+		std::thread releaser(
+				[&messages] () {
+					for (auto* message : messages) {
+						delete_event_message(message);
+					}
+				}
+			);
+		releaser.join();
+
+		for (auto& message : messages) {
+			message = counter::create_increment_event(std::string("pool.counter"), 1, handystats::chrono::tsc_clock::now());
+		}
+	}
+
+	for (auto* message : messages) {
+		delete_event_message(message);
+	}
+
+	ASSERT_EQ(allocated_messages(), allocated);
+}
+
+TEST(EventMessagePoolTest, PoolStatisticsAreDumped) {
+	HANDY_CONFIG_JSON(
+			"{\
+				\"metrics-dump\": {\
+					\"interval\": 10\
+				}\
+			}"
+		);
+	HANDY_INIT();
+
+	for (int step = 0; step < 1000; ++step) {
+		TEST_COUNTER_INCREMENT("test.counter", 1);
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_TRUE(metrics_dump->count("handystats.event_pool.allocated"));
+	ASSERT_TRUE(metrics_dump->count("handystats.event_pool.in_use"));
+
+	ASSERT_GT(
+			boost::get<handystats::metrics::gauge>(metrics_dump->at("handystats.event_pool.allocated"))
+				.values().get<handystats::statistics::tag::value>(),
+			0
+		);
+	ASSERT_EQ(
+			boost::get<handystats::metrics::gauge>(metrics_dump->at("handystats.event_pool.in_use"))
+				.values().get<handystats::statistics::tag::value>(),
+			0
+		);
+
+	HANDY_FINALIZE();
+}
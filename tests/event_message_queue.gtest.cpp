@@ -66,3 +66,32 @@ TEST_F(EventMessageQueueTest, PushDifferentMessages) {
 	ASSERT_EQ(handystats::message_queue::size(), 3);
 }
 
+
+TEST_F(EventMessageQueueTest, BatchPopPreservesOrder) {
+	const size_t MESSAGES_COUNT = 1000;
+	const size_t BATCH_SIZE = 64;
+
+	for (size_t index = 0; index < MESSAGES_COUNT; ++index) {
+		TEST_GAUGE_SET("gauge.name", index);
+	}
+
+	ASSERT_EQ(handystats::message_queue::size(), MESSAGES_COUNT);
+
+	handystats::events::event_message* messages[BATCH_SIZE];
+	size_t popped = 0;
+
+	while (size_t count = handystats::message_queue::pop(messages, BATCH_SIZE)) {
+		ASSERT_EQ(count, std::min(BATCH_SIZE, MESSAGES_COUNT - popped));
+
+		for (size_t index = 0; index < count; ++index) {
+			ASSERT_EQ(reinterpret_cast<const double&>(messages[index]->event_data), popped + index);
+			handystats::events::delete_event_message(messages[index]);
+		}
+
+		popped += count;
+		ASSERT_EQ(handystats::message_queue::size(), MESSAGES_COUNT - popped);
+	}
+
+	ASSERT_EQ(popped, MESSAGES_COUNT);
+	ASSERT_EQ(handystats::message_queue::stats::pop_count.values().get<handystats::statistics::tag::value>(), MESSAGES_COUNT);
+}
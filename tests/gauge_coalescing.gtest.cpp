@@ -0,0 +1,175 @@
+#include <vector>
+#include <thread>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "gauge_slots_impl.hpp"
+#include "message_queue_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class GaugeCoalescingTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"metrics\": {\
+						\"gauge\": {\
+							\"tags\": [\"value\", \"timestamp\"]\
+						}\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(GaugeCoalescingTest, LastValueGaugesAreCoalesced) {
+	ASSERT_TRUE(handystats::gauge_slots::enabled());
+
+	auto gauge_handle = HANDY_GAUGE_HANDLE("coalesced.gauge");
+
+	for (int step = 0; step <= 1000; ++step) {
+		HANDY_GAUGE_SET(gauge_handle, step);
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("coalesced.gauge"));
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), 1000);
+
+	// no events have passed through the message queue
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handystats.message_queue.pop_count"))
+				.values().get<handystats::statistics::tag::value>(),
+			0
+		);
+}
+
+TEST_F(GaugeCoalescingTest, MultipleProducerThreads) {
+	const size_t THREADS_COUNT = 8;
+
+	std::vector<handystats::metric_handle> handles;
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		handles.push_back(HANDY_GAUGE_HANDLE("coalesced.gauge." + std::to_string(index)));
+	}
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		producers[index] = std::thread(
+				[index, &handles] () {
+					for (int step = 0; step <= 1000; ++step) {
+						HANDY_GAUGE_SET(handles[index], step);
+						HANDY_GAUGE_SET(handles[(index + 1) % handles.size()], -step);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("coalesced.gauge." + std::to_string(index)));
+		const double value = gauge.values().get<handystats::statistics::tag::value>();
+		ASSERT_TRUE(value == 1000 || value == -1000);
+	}
+}
+
+TEST_F(GaugeCoalescingTest, NamedGaugesGoThroughQueue) {
+	HANDY_GAUGE_SET("named.gauge", 1);
+	HANDY_GAUGE_SET("named.gauge", 2);
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::gauge>(metrics_dump->at("named.gauge"))
+				.values().get<handystats::statistics::tag::value>(),
+			2
+		);
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handystats.message_queue.pop_count"))
+				.values().get<handystats::statistics::tag::value>(),
+			2
+		);
+}
+
+TEST(GaugeCoalescingConfigTest, GaugesWithPerSampleStatisticsAreNotCoalesced) {
+	HANDY_CONFIG_JSON(
+			"{\
+				\"metrics\": {\
+					\"gauge\": {\
+						\"tags\": [\"value\", \"max\"]\
+					}\
+				}\
+			}"
+		);
+	HANDY_INIT();
+
+	ASSERT_FALSE(handystats::gauge_slots::enabled());
+
+	HANDY_FINALIZE();
+}
+
+TEST_F(GaugeCoalescingTest, HandleAndNameSetsAreOrdered) {
+	auto gauge_handle = HANDY_GAUGE_HANDLE("ordered.gauge");
+
+	// coalesced set is applied on dump, after the queued one
+	HANDY_GAUGE_SET(gauge_handle, 1);
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+	HANDY_GAUGE_SET("ordered.gauge", 2);
+	HANDY_GAUGE_SET(gauge_handle, 3);
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(
+			boost::get<handystats::metrics::gauge>(metrics_dump->at("ordered.gauge"))
+				.values().get<handystats::statistics::tag::value>(),
+			3
+		);
+
+	// queued set is later than the coalesced one
+	HANDY_GAUGE_SET(gauge_handle, 4);
+	HANDY_GAUGE_SET("ordered.gauge", 5);
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(
+			boost::get<handystats::metrics::gauge>(metrics_dump->at("ordered.gauge"))
+				.values().get<handystats::statistics::tag::value>(),
+			5
+		);
+}
@@ -0,0 +1,227 @@
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include <handystats/statistics.hpp>
+#include <handystats/math_utils.hpp>
+
+#include <handystats/chrono.hpp>
+
+using handystats::statistics;
+
+// Straightforward histogram: every bin is shifted on each update, closest bins are found by linear scan
+class reference_histogram {
+public:
+	reference_histogram(const size_t& bins, const statistics::duration& moving_interval)
+		: m_bins(bins)
+		, m_moving_interval(moving_interval)
+	{}
+
+	void update(const statistics::value_type& value, const statistics::time_point& timestamp) {
+		statistics::bin_type new_bin(value, 1.0, timestamp);
+		m_histogram.insert(std::lower_bound(m_histogram.begin(), m_histogram.end(), new_bin), new_bin);
+
+		shift(timestamp);
+
+		if (m_histogram.size() > m_bins) {
+			size_t best_index = 0;
+			for (size_t index = 1; index + 1 < m_histogram.size(); ++index) {
+				if (gap(index) < gap(best_index)) {
+					best_index = index;
+				}
+			}
+
+			auto& left_bin = m_histogram[best_index];
+			const auto& right_bin = m_histogram[best_index + 1];
+			const double left_count = std::get<statistics::BIN_COUNT>(left_bin);
+			const double right_count = std::get<statistics::BIN_COUNT>(right_bin);
+
+			if (left_count <= 0 && right_count <= 0) {
+				left_bin = statistics::bin_type(
+						handystats::math_utils::weighted_average(std::get<statistics::BIN_CENTER>(left_bin), 1, std::get<statistics::BIN_CENTER>(right_bin), 1),
+						0,
+						statistics::time_point()
+					);
+			}
+			else {
+				left_bin = statistics::bin_type(
+						handystats::math_utils::weighted_average(
+							std::get<statistics::BIN_CENTER>(left_bin), left_count,
+							std::get<statistics::BIN_CENTER>(right_bin), right_count
+						),
+						left_count + right_count,
+						std::max(std::get<statistics::BIN_TIMESTAMP>(left_bin), std::get<statistics::BIN_TIMESTAMP>(right_bin))
+					);
+			}
+
+			m_histogram.erase(m_histogram.begin() + best_index + 1);
+		}
+
+		m_timestamp = std::max(m_timestamp, timestamp);
+	}
+
+	void update_time(const statistics::time_point& timestamp) {
+		shift(timestamp);
+		m_timestamp = std::max(m_timestamp, timestamp);
+	}
+
+	const statistics::histogram_type& histogram() const {
+		return m_histogram;
+	}
+
+private:
+	double gap(const size_t& index) const {
+		return std::get<statistics::BIN_CENTER>(m_histogram[index + 1]) - std::get<statistics::BIN_CENTER>(m_histogram[index]);
+	}
+
+	void shift(const statistics::time_point& timestamp) {
+		if (timestamp <= m_timestamp) return;
+
+		for (auto& bin : m_histogram) {
+			auto& count = std::get<statistics::BIN_COUNT>(bin);
+			const auto& stale_interval = std::get<statistics::BIN_TIMESTAMP>(bin) - (timestamp - m_moving_interval);
+			if (stale_interval.count() <= 0) {
+				count = 0;
+			}
+			else {
+				// intervals are compared in the finer time unit
+				const auto& moving_interval = m_moving_interval - (m_timestamp - std::get<statistics::BIN_TIMESTAMP>(bin));
+				const handystats::chrono::time_unit unit =
+					std::min(stale_interval.unit(), moving_interval.unit(), std::less<handystats::chrono::time_unit>());
+				count = count * handystats::chrono::duration::convert_to(unit, stale_interval).count() /
+					handystats::chrono::duration::convert_to(unit, moving_interval).count();
+			}
+		}
+	}
+
+	size_t m_bins;
+	statistics::duration m_moving_interval;
+	statistics::histogram_type m_histogram;
+	statistics::time_point m_timestamp;
+};
+
+class HistogramTest : public ::testing::TestWithParam<size_t> {
+protected:
+	virtual void SetUp() {
+		opts.histogram_bins = GetParam();
+		opts.moving_interval = handystats::chrono::duration(10, handystats::chrono::time_unit::MSEC);
+		opts.tags = statistics::tag::histogram;
+
+		srand(GetParam());
+	}
+
+	static statistics::time_point at(const int64_t& usec) {
+		return statistics::time_point(
+				handystats::chrono::duration(usec, handystats::chrono::time_unit::USEC),
+				handystats::chrono::clock_type::TSC
+			);
+	}
+
+	// quantile and entropy are computed from the histogram
+	void expect_same(const statistics& stats, const reference_histogram& reference) {
+		const auto& histogram = stats.get<statistics::tag::histogram>();
+		const auto& expected = reference.histogram();
+
+		ASSERT_EQ(histogram.size(), expected.size());
+		for (size_t index = 0; index < histogram.size(); ++index) {
+			ASSERT_NEAR(
+					std::get<statistics::BIN_CENTER>(histogram[index]),
+					std::get<statistics::BIN_CENTER>(expected[index]),
+					1E-9 * std::abs(std::get<statistics::BIN_CENTER>(expected[index]))
+				);
+			ASSERT_NEAR(
+					std::get<statistics::BIN_COUNT>(histogram[index]),
+					std::get<statistics::BIN_COUNT>(expected[index]),
+					1E-9 * std::max(1.0, std::get<statistics::BIN_COUNT>(expected[index]))
+				);
+			ASSERT_EQ(std::get<statistics::BIN_TIMESTAMP>(histogram[index]), std::get<statistics::BIN_TIMESTAMP>(expected[index]));
+		}
+
+	}
+
+	handystats::config::statistics opts;
+};
+
+TEST_P(HistogramTest, SameBinsAsEagerShift) {
+	statistics stats(opts);
+	reference_histogram reference(opts.histogram_bins, opts.moving_interval);
+
+	int64_t usec = 1;
+	for (size_t step = 0; step < 20000; ++step) {
+		const double value = (step % 3 == 0) ? double(rand() % 100) : 1000.0 * rand() / RAND_MAX;
+		usec += rand() % 3;
+
+		stats.update(value, at(usec));
+		reference.update(value, at(usec));
+
+		// late samples are not shifted
+		if (step % 50 == 0) {
+			stats.update(value, at(usec - 5));
+			reference.update(value, at(usec - 5));
+		}
+		if (step % 1000 == 0) {
+			expect_same(stats, reference);
+		}
+	}
+
+	expect_same(stats, reference);
+
+	// bins are decayed without updates
+	for (int64_t shift = 1000; shift <= 12000; shift += 1000) {
+		stats.update_time(at(usec + shift));
+		reference.update_time(at(usec + shift));
+		expect_same(stats, reference);
+	}
+}
+
+TEST_P(HistogramTest, CopiesAreIndependent) {
+	statistics stats(opts);
+
+	for (size_t step = 0; step < 1000; ++step) {
+		stats.update(rand() % 1000, at(step));
+	}
+
+	statistics copy = stats;
+	const auto& histogram = stats.get<statistics::tag::histogram>();
+
+	for (size_t step = 0; step < 1000; ++step) {
+		copy.update(rand() % 1000, at(1000 + step));
+	}
+
+	const auto& same_histogram = stats.get<statistics::tag::histogram>();
+	ASSERT_EQ(histogram.size(), same_histogram.size());
+	for (size_t index = 0; index < histogram.size(); ++index) {
+		ASSERT_EQ(histogram[index], same_histogram[index]);
+	}
+	ASSERT_EQ(copy.get<statistics::tag::histogram>().size(), std::min<size_t>(opts.histogram_bins, 1000));
+}
+
+INSTANTIATE_TEST_CASE_P(Bins, HistogramTest, ::testing::Values(1, 2, 10, 30, 100));
+
+// Fresh statistics' timestamp is TICK time point, while timestamps here are USEC:
+// intervals of the first shift are still compared in the same unit
+TEST(HistogramUnitTest, FirstBinOfCoarseTimestampsKeepsItsCount) {
+	handystats::config::statistics opts;
+	opts.moving_interval = handystats::chrono::duration(10, handystats::chrono::time_unit::MSEC);
+	opts.tags = statistics::tag::histogram;
+
+	auto at = [] (const int64_t& usec) {
+		return statistics::time_point(
+				handystats::chrono::duration(usec, handystats::chrono::time_unit::USEC),
+				handystats::chrono::clock_type::TSC
+			);
+	};
+
+	statistics stats(opts);
+	stats.update(10.0, at(0));
+
+	ASSERT_EQ(stats.get<statistics::tag::histogram>().size(), 1);
+	ASSERT_NEAR(std::get<statistics::BIN_COUNT>(stats.get<statistics::tag::histogram>()[0]), 1.0, 1E-6);
+
+	// half of moving interval later
+	stats.update_time(at(5000));
+	ASSERT_NEAR(std::get<statistics::BIN_COUNT>(stats.get<statistics::tag::histogram>()[0]), 0.5, 1E-6);
+}
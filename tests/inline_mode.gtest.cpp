@@ -0,0 +1,175 @@
+#include <vector>
+#include <thread>
+#include <string>
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "internal_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class InlineModeTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"core\": {\
+						\"mode\": \"inline\",\
+						\"processor-threads\": 4\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(InlineModeTest, ModeConfiguration) {
+	ASSERT_EQ(handystats::config::core_opts.mode, handystats::config::core::INLINE);
+	ASSERT_EQ(handystats::internal::shards.size(), 4);
+}
+
+TEST_F(InlineModeTest, EventsAreAppliedByProducer) {
+	for (int step = 0; step < 1000; ++step) {
+		HANDY_COUNTER_INCREMENT("inline.counter", 1);
+		HANDY_GAUGE_SET("inline.gauge", step);
+		HANDY_ATTRIBUTE_SET_STRING("inline.attribute", "value-" + std::to_string(step));
+	}
+
+	// metrics are updated right away, only dump is awaited
+	ASSERT_EQ(handystats::message_queue::size(), 0);
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("inline.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			1000
+		);
+
+	const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("inline.gauge"));
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), 999);
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::count>(), 1000);
+
+	ASSERT_EQ(
+			boost::get<std::string>(boost::get<handystats::metrics::attribute>(metrics_dump->at("inline.attribute")).value()),
+			"value-999"
+		);
+
+	// nothing has passed through the message queue
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handystats.message_queue.pop_count"))
+				.values().get<handystats::statistics::tag::value>(),
+			0
+		);
+}
+
+TEST_F(InlineModeTest, HandlesAndLiterals) {
+	auto counter_handle = HANDY_COUNTER_HANDLE("inline.handle.counter");
+	auto timer_handle = HANDY_TIMER_HANDLE("inline.handle.timer");
+
+	for (int step = 0; step < 100; ++step) {
+		HANDY_COUNTER_INCREMENT(counter_handle, 2);
+		HANDY_COUNTER_INCREMENT("inline.literal.counter", 3);
+		HANDY_TIMER_SET(timer_handle, handystats::chrono::duration(step, handystats::chrono::time_unit::USEC));
+	}
+
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("inline.handle.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			200
+		);
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("inline.literal.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			300
+		);
+	ASSERT_EQ(
+			boost::get<handystats::metrics::timer>(metrics_dump->at("inline.handle.timer"))
+				.values().get<handystats::statistics::tag::count>(),
+			100
+		);
+}
+
+TEST_F(InlineModeTest, MultipleProducerThreads) {
+	const size_t THREADS_COUNT = 8;
+	const size_t METRICS_COUNT = 16;
+	const size_t INCR_COUNT = 500;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[METRICS_COUNT, INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						for (size_t index = 0; index < METRICS_COUNT; ++index) {
+							HANDY_COUNTER_INCREMENT("inline.counter." + std::to_string(index), 1);
+						}
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (size_t index = 0; index < METRICS_COUNT; ++index) {
+		ASSERT_EQ(
+				boost::get<handystats::metrics::counter>(metrics_dump->at("inline.counter." + std::to_string(index)))
+					.values().get<handystats::statistics::tag::value>(),
+				THREADS_COUNT * INCR_COUNT
+			);
+	}
+}
+
+TEST_F(InlineModeTest, FinalizeWithActiveProducers) {
+	std::atomic<bool> stop_flag(false);
+
+	std::vector<std::thread> producers(4);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[&stop_flag] () {
+					while (!stop_flag.load()) {
+						HANDY_COUNTER_INCREMENT("inline.counter", 1);
+						HANDY_GAUGE_SET("inline.gauge", 1);
+					}
+				}
+			);
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	HANDY_FINALIZE();
+
+	stop_flag.store(true);
+	for (auto& producer : producers) {
+		producer.join();
+	}
+}
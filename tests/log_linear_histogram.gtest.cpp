@@ -0,0 +1,185 @@
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <handystats/statistics.hpp>
+#include <handystats/log_linear_histogram.hpp>
+#include <handystats/json/statistics_json_writer.hpp>
+#include <handystats/rapidjson/document.h>
+
+#include <handystats/chrono.hpp>
+
+#include "timestamps_helper.hpp"
+
+using handystats::statistics;
+using handystats::log_linear_histogram;
+
+class LogLinearHistogramTest : public ::testing::TestWithParam<size_t> {
+protected:
+	virtual void SetUp() {
+		srand(GetParam());
+
+		opts.histogram_type = handystats::config::statistics::LOG_LINEAR;
+		opts.histogram_significant_digits = GetParam();
+		opts.moving_interval = handystats::chrono::duration(1, handystats::chrono::time_unit::SEC);
+		opts.tags = statistics::tag::quantile | statistics::tag::histogram | statistics::tag::moving_count;
+	}
+
+	handystats::config::statistics opts;
+	handystats::chrono::test_timestamps<handystats::chrono::time_unit::USEC> at;
+};
+
+TEST_P(LogLinearHistogramTest, QuantilesWithinRelativeError) {
+	statistics stats(opts);
+	std::vector<double> values;
+
+	// all values are taken within single moving interval without decay
+	for (int64_t index = 0; index < 10000; ++index) {
+		const double value = std::exp(10.0 * rand() / RAND_MAX);
+		values.push_back(value);
+		stats.update(value, at(0));
+	}
+
+	std::sort(values.begin(), values.end());
+
+	const double relative_error = std::pow(10.0, -double(GetParam()));
+	const auto& quantile = stats.get<statistics::tag::quantile>();
+
+	const double probabilities[] = {0.01, 0.25, 0.5, 0.9, 0.99, 0.999};
+	for (const double& probability : probabilities) {
+		const double exact = values[size_t(std::ceil(probability * values.size())) - 1];
+		EXPECT_NEAR(quantile.at(probability), exact, exact * relative_error) << "p = " << probability;
+	}
+}
+
+TEST_P(LogLinearHistogramTest, BucketsDecayAsMovingCount) {
+	statistics stats(opts);
+
+	for (int64_t index = 0; index < 3000; ++index) {
+		stats.update(-50.0 + rand() % 1000, at(index * 1000));
+		if (index % 7 == 0) {
+			stats.update_time(at(index * 1000 + 500));
+		}
+
+		if (index % 100 == 0) {
+			const auto& histogram = stats.get<statistics::tag::histogram>();
+
+			double count = 0;
+			for (size_t bin = 0; bin < histogram.size(); ++bin) {
+				count += std::get<statistics::BIN_COUNT>(histogram[bin]);
+				if (bin > 0) {
+					ASSERT_LT(std::get<statistics::BIN_CENTER>(histogram[bin - 1]), std::get<statistics::BIN_CENTER>(histogram[bin]));
+				}
+			}
+
+			const double moving_count = stats.get<statistics::tag::moving_count>();
+			ASSERT_NEAR(count, moving_count, moving_count * 1E-9);
+		}
+	}
+
+	// expired histogram is empty
+	stats.update_time(at(3000 * 1000 + 2000000));
+	ASSERT_NEAR(stats.get<statistics::tag::quantile>().at(0.5), 0, 1E-9);
+}
+
+TEST_P(LogLinearHistogramTest, MergeAddsBuckets) {
+	log_linear_histogram left(GetParam());
+	log_linear_histogram right(GetParam());
+	log_linear_histogram both(GetParam());
+
+	for (size_t index = 0; index < 1000; ++index) {
+		const double value = (rand() % 2 ? 1 : -1) * std::exp(20.0 * rand() / RAND_MAX - 10.0);
+		(index % 3 ? left : right).add(value);
+		both.add(value);
+	}
+	left.scale(0.5);
+	left.add(0.0, 2.0);
+	both.add(0.0, 2.0);
+
+	left.merge(right);
+
+	const auto& merged_buckets = left.buckets();
+	const auto& expected_buckets = both.buckets();
+
+	ASSERT_EQ(merged_buckets.size(), expected_buckets.size());
+	ASSERT_GT(left.count(), 0.5 * both.count());
+	for (size_t index = 0; index < merged_buckets.size(); ++index) {
+		ASSERT_EQ(merged_buckets[index].lower, expected_buckets[index].lower);
+		ASSERT_EQ(merged_buckets[index].upper, expected_buckets[index].upper);
+		ASSERT_LE(merged_buckets[index].count, expected_buckets[index].count + 1E-9);
+		ASSERT_LE(
+				(expected_buckets[index].upper - expected_buckets[index].lower),
+				std::max(std::abs(expected_buckets[index].lower), std::abs(expected_buckets[index].upper)) * left.relative_error()
+			);
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(SignificantDigits, LogLinearHistogramTest, ::testing::Values(1, 2, 3));
+
+TEST(LogLinearHistogramOutliersTest, DistantValuesAreKeptSparsely) {
+	log_linear_histogram histogram(log_linear_histogram::MAX_SIGNIFICANT_DIGITS);
+
+	// power of two ranges in between aren't allocated and walked
+	const double values[] = {-1E300, -1E-300, 1E-300, 1.0, 1E6, 1E300};
+	for (size_t round = 0; round < 1000; ++round) {
+		for (const double& value : values) {
+			histogram.add(value);
+		}
+	}
+
+	const auto& buckets = histogram.buckets();
+	ASSERT_EQ(buckets.size(), 6);
+	for (size_t index = 0; index < buckets.size(); ++index) {
+		ASSERT_LE(buckets[index].lower, values[index]);
+		ASSERT_GE(buckets[index].upper, values[index]);
+		ASSERT_EQ(buckets[index].count, 1000);
+	}
+
+	// probabilities in the middle of each value's share
+	std::vector<double> probabilities;
+	for (size_t index = 0; index < 6; ++index) {
+		probabilities.push_back((index + 0.5) / 6);
+	}
+	const auto& quantiles = histogram.quantiles(probabilities);
+	for (size_t index = 0; index < quantiles.size(); ++index) {
+		EXPECT_NEAR(quantiles[index], values[index], std::abs(values[index]) * histogram.relative_error());
+	}
+
+	histogram.merge(histogram);
+	ASSERT_EQ(histogram.count(), 12000);
+}
+
+TEST(LogLinearHistogramConfigTest, HistogramTypeFromJson) {
+	rapidjson::Document config;
+	config.Parse<0>(
+			"{\
+				\"histogram-type\": \"log-linear\",\
+				\"histogram-significant-digits\": 3,\
+				\"tags\": [\"histogram\", \"quantile\"]\
+			}"
+		);
+
+	handystats::config::statistics opts;
+	opts.configure(config);
+
+	ASSERT_EQ(opts.histogram_type, handystats::config::statistics::LOG_LINEAR);
+	ASSERT_EQ(opts.histogram_significant_digits, 3);
+
+	statistics stats(opts);
+	const auto& timestamp = statistics::clock::now();
+	stats.update(100, timestamp);
+	stats.update(1000, timestamp);
+
+	rapidjson::Value json_value;
+	rapidjson::MemoryPoolAllocator<> allocator;
+	handystats::json::write_to_json_value(&stats, &json_value, allocator);
+
+	ASSERT_TRUE(json_value["histogram"].IsArray());
+	ASSERT_EQ(json_value["histogram"].Size(), 2);
+	ASSERT_NEAR(json_value["histogram"][0u][0u].GetDouble(), 100, 100 * 1E-3);
+	ASSERT_NEAR(json_value["p50"].GetDouble(), 100, 100 * 1E-3);
+}
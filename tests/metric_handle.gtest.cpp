@@ -0,0 +1,136 @@
+#include <vector>
+#include <thread>
+#include <string>
+#include <map>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+class MetricHandleTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(MetricHandleTest, SameNameResolvesToSameHandle) {
+	auto first_handle = HANDY_COUNTER_HANDLE("handle.test.same");
+	auto second_handle = HANDY_GAUGE_HANDLE(std::string("handle.test.same"));
+	auto other_handle = HANDY_COUNTER_HANDLE("handle.test.other");
+
+	ASSERT_TRUE(first_handle.valid());
+	ASSERT_TRUE(other_handle.valid());
+	ASSERT_EQ(first_handle.id, second_handle.id);
+	ASSERT_NE(first_handle.id, other_handle.id);
+}
+
+TEST_F(MetricHandleTest, HandleAndNameEventsGoToSameMetric) {
+	const size_t THREADS_COUNT = 4;
+	const size_t INCR_COUNT = 1000;
+
+	auto counter_handle = HANDY_COUNTER_HANDLE("handle.counter");
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[counter_handle, INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						HANDY_COUNTER_INCREMENT(counter_handle);
+						HANDY_COUNTER_INCREMENT("handle.counter");
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handle.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			2 * THREADS_COUNT * INCR_COUNT
+		);
+}
+
+TEST_F(MetricHandleTest, AllMetricTypesAcceptHandles) {
+	auto gauge_handle = HANDY_GAUGE_HANDLE("handle.gauge");
+	auto timer_handle = HANDY_TIMER_HANDLE("handle.timer");
+	auto attribute_handle = HANDY_ATTRIBUTE_HANDLE("handle.attribute");
+
+	HANDY_GAUGE_INIT(gauge_handle, 1);
+	HANDY_GAUGE_SET(gauge_handle, 10);
+
+	HANDY_TIMER_START(timer_handle);
+	HANDY_TIMER_STOP(timer_handle);
+	HANDY_TIMER_SET(timer_handle, handystats::chrono::duration(1, handystats::chrono::time_unit::MSEC));
+
+	HANDY_ATTRIBUTE_SET_INT(attribute_handle, 5);
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("handle.gauge"));
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), 10);
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::count>(), 2);
+
+	const auto& timer = boost::get<handystats::metrics::timer>(metrics_dump->at("handle.timer"));
+	ASSERT_EQ(timer.values().get<handystats::statistics::tag::count>(), 2);
+
+	const auto& attribute = boost::get<handystats::metrics::attribute>(metrics_dump->at("handle.attribute"));
+	ASSERT_EQ(boost::get<int>(attribute.value()), 5);
+}
+
+TEST_F(MetricHandleTest, HandlesSurviveReinitialization) {
+	auto counter_handle = HANDY_COUNTER_HANDLE("handle.reinit.counter");
+
+	HANDY_COUNTER_INCREMENT(counter_handle, 10);
+
+	HANDY_FINALIZE();
+	HANDY_CONFIG_JSON(
+			"{\
+				\"metrics-dump\": {\
+					\"interval\": 10\
+				}\
+			}"
+		);
+	HANDY_INIT();
+
+	HANDY_COUNTER_INCREMENT(counter_handle, 3);
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handle.reinit.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			3
+		);
+}
@@ -0,0 +1,148 @@
+#include <vector>
+#include <thread>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <map>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/metric_literal.hpp>
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+static_assert(handystats::fnv1a_hash("", 0) == 0xcbf29ce484222325ULL, "FNV-1a hash of empty string");
+static_assert(handystats::fnv1a_hash("a", 1) == 0xaf63dc4c8601ec8cULL, "FNV-1a hash of \"a\"");
+
+using namespace handystats::literals;
+
+static_assert(("foobar"_metric).hash == 0x85944171f73967e8ULL, "FNV-1a hash of \"foobar\"");
+static_assert(("foo\0bar"_metric).hash == ("foo"_metric).hash, "hash stops at NUL as strlen() does");
+
+class MetricLiteralTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(MetricLiteralTest, LiteralAndStringNamesGoToSameMetric) {
+	const size_t THREADS_COUNT = 4;
+	const size_t INCR_COUNT = 1000;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[INCR_COUNT] () {
+					const char* name_ptr = "literal.counter";
+					char name_buffer[32];
+					strcpy(name_buffer, "literal.counter");
+
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						HANDY_COUNTER_INCREMENT("literal.counter"_metric);
+						HANDY_COUNTER_INCREMENT("literal.counter");
+						HANDY_COUNTER_INCREMENT(std::string("literal.counter"));
+						HANDY_COUNTER_INCREMENT(name_ptr);
+						HANDY_COUNTER_INCREMENT(name_buffer);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("literal.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			5 * THREADS_COUNT * INCR_COUNT
+		);
+}
+
+TEST_F(MetricLiteralTest, MutableBufferNameIsCopied) {
+	char name_buffer[32];
+
+	for (int index = 0; index < 10; ++index) {
+		sprintf(name_buffer, "literal.gauge.%d", index);
+		HANDY_GAUGE_SET(name_buffer, index);
+	}
+	memset(name_buffer, 0, sizeof(name_buffer));
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (int index = 0; index < 10; ++index) {
+		const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("literal.gauge." + std::to_string(index)));
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), index);
+	}
+}
+
+TEST_F(MetricLiteralTest, OversizedArrayNameGoesToSameMetric) {
+	static const char name[64] = "oversized.counter";
+
+	for (int step = 0; step < 10; ++step) {
+		HANDY_COUNTER_INCREMENT(name);
+		HANDY_COUNTER_INCREMENT("oversized.counter"_metric);
+		HANDY_COUNTER_INCREMENT(handystats::metric_literal(name, sizeof(name)));
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("oversized.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			30
+		);
+}
+
+TEST_F(MetricLiteralTest, ScopedHelpersWithLiteralNames) {
+	for (int step = 0; step < 100; ++step) {
+		HANDY_TIMER_SCOPE("literal.timer"_metric);
+		HANDY_COUNTER_SCOPE("literal.scoped.counter"_metric, 2);
+		HANDY_ATTRIBUTE_SET_INT("literal.attribute"_metric, step);
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::timer>(metrics_dump->at("literal.timer"))
+				.values().get<handystats::statistics::tag::count>(),
+			100
+		);
+
+	const auto& counter = boost::get<handystats::metrics::counter>(metrics_dump->at("literal.scoped.counter"));
+	ASSERT_EQ(counter.values().get<handystats::statistics::tag::value>(), 0);
+
+	const auto& attribute = boost::get<handystats::metrics::attribute>(metrics_dump->at("literal.attribute"));
+	ASSERT_EQ(boost::get<int>(attribute.value()), 99);
+}
@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <handystats/metric_literal.hpp>
+
+#include "metrics_table_impl.hpp"
+
+using handystats::internal::metrics_table;
+
+TEST(MetricsTableTest, HashIsConsistentWithLiteralHash) {
+	const char name[] = "metrics.table.hash";
+	ASSERT_EQ(metrics_table::hash(name, sizeof(name) - 1), handystats::metric_literal(name, sizeof(name) - 1).hash);
+}
+
+TEST(MetricsTableTest, InsertReturnsStableIndices) {
+	const size_t METRICS_COUNT = 10000;
+
+	metrics_table table;
+	std::vector<metrics_table::index_type> indices;
+
+	for (size_t index = 0; index < METRICS_COUNT; ++index) {
+		indices.push_back(table.insert("metric." + std::to_string(index)));
+		table.at(indices.back()).second = reinterpret_cast<handystats::metrics::counter*>(index + 1);
+	}
+
+	ASSERT_EQ(table.size(), METRICS_COUNT);
+
+	for (size_t index = 0; index < METRICS_COUNT; ++index) {
+		const std::string name = "metric." + std::to_string(index);
+		ASSERT_EQ(table.insert(name), indices[index]);
+		ASSERT_EQ(table.find(name), indices[index]);
+		ASSERT_EQ(table.at(indices[index]).first, name);
+		ASSERT_EQ(boost::get<handystats::metrics::counter*>(table[name]), reinterpret_cast<handystats::metrics::counter*>(index + 1));
+	}
+
+	ASSERT_EQ(table.size(), METRICS_COUNT);
+	ASSERT_EQ(table.find("metric.unknown"), metrics_table::INVALID_INDEX);
+}
+
+TEST(MetricsTableTest, SortedIndexFollowsInsertions) {
+	metrics_table table;
+
+	std::vector<std::string> names;
+	for (int step = 0; step < 5; ++step) {
+		for (int index = 0; index < 100; ++index) {
+			names.push_back("metric." + std::to_string((index * 37 + step * 11) % 1000) + "." + std::to_string(step));
+			table.insert(names.back());
+		}
+
+		const auto& sorted_index = table.sorted_index();
+		ASSERT_EQ(sorted_index.size(), table.size());
+
+		std::vector<std::string> sorted_names;
+		for (auto index : sorted_index) {
+			sorted_names.push_back(table.at(index).first);
+		}
+
+		std::vector<std::string> expected_names(names);
+		std::sort(expected_names.begin(), expected_names.end());
+		expected_names.erase(std::unique(expected_names.begin(), expected_names.end()), expected_names.end());
+
+		ASSERT_EQ(sorted_names, expected_names);
+	}
+}
+
+TEST(MetricsTableTest, ClearRemovesAllEntries) {
+	metrics_table table;
+
+	for (int index = 0; index < 1000; ++index) {
+		table.insert("metric." + std::to_string(index));
+	}
+
+	table.clear();
+
+	ASSERT_TRUE(table.empty());
+	ASSERT_TRUE(table.sorted_index().empty());
+	ASSERT_EQ(table.find("metric.0"), metrics_table::INVALID_INDEX);
+
+	ASSERT_EQ(table.insert("metric.0"), 0);
+}
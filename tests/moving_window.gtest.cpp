@@ -0,0 +1,275 @@
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include <handystats/statistics.hpp>
+#include <handystats/json/statistics_json_writer.hpp>
+#include <handystats/rapidjson/document.h>
+
+#include <handystats/chrono.hpp>
+
+#include "timestamps_helper.hpp"
+
+using handystats::statistics;
+
+class MovingWindowTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		srand(1);
+
+		opts.moving_window = handystats::config::statistics::BUCKETS;
+		opts.moving_buckets = 10;
+		opts.moving_interval = handystats::chrono::duration(1000, handystats::chrono::time_unit::MSEC);
+		opts.tags =
+			statistics::tag::moving_count | statistics::tag::moving_sum | statistics::tag::moving_avg |
+			statistics::tag::moving_min | statistics::tag::moving_max;
+	}
+
+	// 1000 msec / 10 buckets by default
+	static int64_t bucket_index(const statistics::time_point& timestamp, const int64_t& bucket_width = 100 * 1000 * 1000) {
+		return handystats::chrono::duration::convert_to(
+				handystats::chrono::time_unit::NSEC, timestamp.time_since_epoch()
+			).count() / bucket_width;
+	}
+
+	handystats::config::statistics opts;
+	handystats::chrono::test_timestamps<handystats::chrono::time_unit::MSEC> at;
+};
+
+TEST_F(MovingWindowTest, ExactWindowStatistics) {
+	statistics stats(opts);
+
+	std::vector<std::pair<statistics::time_point, double>> data;
+	statistics::time_point last_time = at(0);
+
+	int64_t msec = 0;
+	for (size_t step = 0; step < 2000; ++step) {
+		// bursts, idle periods and late data
+		msec += (step % 200 < 150) ? rand() % 20 : 100 + rand() % 1000;
+		const int64_t data_msec = (rand() % 10 == 0) ? msec - rand() % 1500 : msec;
+		const double value = rand() % 1000 - 300;
+
+		const statistics::time_point& timestamp = at(data_msec);
+		const int64_t& current_index = bucket_index(std::max(timestamp, last_time));
+		// data older than the window is dropped
+		if (timestamp >= last_time || bucket_index(timestamp) > current_index - 10) {
+			data.push_back(std::make_pair(timestamp, value));
+		}
+
+		stats.update(value, timestamp);
+		last_time = std::max(last_time, timestamp);
+
+		if (step % 5 == 0) {
+			last_time = std::max(last_time, at(msec + rand() % 300));
+			stats.update_time(last_time);
+		}
+
+		const int64_t& index = bucket_index(last_time);
+		double count = 0;
+		double sum = 0;
+		double min = std::numeric_limits<double>::max();
+		double max = std::numeric_limits<double>::lowest();
+		for (auto iter = data.cbegin(); iter != data.cend(); ++iter) {
+			const int64_t& data_index = bucket_index(iter->first);
+			if (data_index > index - 10 && data_index <= index) {
+				count += 1;
+				sum += iter->second;
+				min = std::min(min, iter->second);
+				max = std::max(max, iter->second);
+			}
+		}
+
+		ASSERT_EQ(stats.get<statistics::tag::moving_count>(), count) << "step " << step;
+		ASSERT_NEAR(stats.get<statistics::tag::moving_sum>(), sum, 1E-6) << "step " << step;
+		ASSERT_NEAR(stats.get<statistics::tag::moving_avg>(), count > 0 ? sum / count : 0, 1E-6) << "step " << step;
+		ASSERT_EQ(stats.get<statistics::tag::moving_min>(), count > 0 ? min : 0) << "step " << step;
+		ASSERT_EQ(stats.get<statistics::tag::moving_max>(), count > 0 ? max : 0) << "step " << step;
+	}
+}
+
+TEST_F(MovingWindowTest, NoDriftAfterBurst) {
+	statistics stats(opts);
+
+	for (int64_t msec = 0; msec < 100; ++msec) {
+		stats.update(1000, at(msec));
+	}
+	for (int64_t msec = 100; msec < 900; msec += 10) {
+		stats.update(10, at(msec));
+	}
+
+	// burst is within the window
+	ASSERT_NEAR(stats.get<statistics::tag::moving_avg>(), (100 * 1000.0 + 80 * 10.0) / 180, 1E-9);
+	ASSERT_EQ(stats.get<statistics::tag::moving_max>(), 1000);
+
+	// burst is out of the window
+	stats.update_time(at(1100));
+	ASSERT_NEAR(stats.get<statistics::tag::moving_avg>(), 10, 1E-9);
+	ASSERT_EQ(stats.get<statistics::tag::moving_max>(), 10);
+
+	// idle
+	stats.update_time(at(2000));
+	ASSERT_EQ(stats.get<statistics::tag::moving_count>(), 0);
+	ASSERT_EQ(stats.get<statistics::tag::moving_avg>(), 0);
+}
+
+TEST_F(MovingWindowTest, ConstantRate) {
+	opts.tags = statistics::tag::rate;
+	opts.rate_unit = handystats::chrono::time_unit::SEC;
+	statistics stats(opts);
+
+	// counter incremented by 5 every 10 msec -- 500 per second
+	for (int64_t msec = 0; msec <= 5000; msec += 10) {
+		stats.update(msec / 2, at(msec));
+		if (msec >= 1000) {
+			ASSERT_NEAR(stats.get<statistics::tag::rate>(), 500, 500 * 0.02) << "msec " << msec;
+		}
+	}
+}
+
+TEST_F(MovingWindowTest, WindowFromJson) {
+	rapidjson::Document config;
+	config.Parse<0>(
+			"{\
+				\"moving-window\": \"buckets\",\
+				\"moving-buckets\": 4,\
+				\"tags\": [\"moving-min\", \"moving-max\"]\
+			}"
+		);
+
+	handystats::config::statistics json_opts;
+	json_opts.configure(config);
+
+	ASSERT_EQ(json_opts.moving_window, handystats::config::statistics::BUCKETS);
+	ASSERT_EQ(json_opts.moving_buckets, 4);
+
+	statistics stats(json_opts);
+	const auto& timestamp = statistics::clock::now();
+	stats.update(-5, timestamp);
+	stats.update(7, timestamp);
+
+	rapidjson::Value json_value;
+	rapidjson::MemoryPoolAllocator<> allocator;
+	handystats::json::write_to_json_value(&stats, &json_value, allocator);
+
+	ASSERT_EQ(json_value["moving-min"].GetDouble(), -5);
+	ASSERT_EQ(json_value["moving-max"].GetDouble(), 7);
+}
+
+TEST_F(MovingWindowTest, MultipleIntervalsExactWindows) {
+	// 10 buckets of each window: 1 sec buckets of 10s window, 100 msec of 1s window, 6 sec of 1m window
+	opts.moving_window = handystats::config::statistics::DECAY;
+	opts.moving_intervals = {
+		handystats::chrono::duration(10, handystats::chrono::time_unit::SEC),
+		handystats::chrono::duration(1000, handystats::chrono::time_unit::MSEC),
+		handystats::chrono::duration(1, handystats::chrono::time_unit::MIN)
+	};
+	const int64_t windows_bucket_widths[] = {1000 * 1000 * 1000, 100 * 1000 * 1000, 6000ll * 1000 * 1000};
+	statistics stats(opts);
+
+	std::vector<std::pair<statistics::time_point, double>> data;
+	int64_t msec = 0;
+	for (size_t step = 0; step < 3000; ++step) {
+		msec += (step % 300 < 250) ? rand() % 50 : 1000 + rand() % 20000;
+		const double value = rand() % 1000 - 300;
+
+		data.push_back(std::make_pair(at(msec), value));
+		stats.update(value, at(msec));
+
+		if (step % 7 != 0) continue;
+
+		const auto& windows = stats.moving_windows();
+		ASSERT_EQ(windows.size(), 3);
+
+		for (size_t window = 0; window < windows.size(); ++window) {
+			const int64_t& index = bucket_index(at(msec), windows_bucket_widths[window]);
+			ASSERT_EQ(windows[window].interval, opts.moving_intervals[window]);
+
+			double count = 0;
+			double sum = 0;
+			double min = std::numeric_limits<double>::max();
+			double max = std::numeric_limits<double>::lowest();
+			for (auto iter = data.cbegin(); iter != data.cend(); ++iter) {
+				const int64_t& data_index = bucket_index(iter->first, windows_bucket_widths[window]);
+				if (data_index > index - 10 && data_index <= index) {
+					count += 1;
+					sum += iter->second;
+					min = std::min(min, iter->second);
+					max = std::max(max, iter->second);
+				}
+			}
+
+			ASSERT_EQ(windows[window].moving_count, count) << "step " << step << ", window " << window;
+			ASSERT_NEAR(windows[window].moving_sum, sum, 1E-6) << "step " << step << ", window " << window;
+			ASSERT_NEAR(windows[window].moving_avg, count > 0 ? sum / count : 0, 1E-6) << "step " << step;
+			ASSERT_EQ(windows[window].moving_min, count > 0 ? min : 0) << "step " << step << ", window " << window;
+			ASSERT_EQ(windows[window].moving_max, count > 0 ? max : 0) << "step " << step << ", window " << window;
+		}
+
+		// moving interval's own statistics are kept
+		const auto& window = std::find_if(windows.cbegin(), windows.cend(),
+				[this] (const statistics::moving_window_data& window) { return window.interval == opts.moving_interval; }
+			);
+		ASSERT_EQ(stats.get<statistics::tag::moving_min>(), window->moving_min);
+		ASSERT_EQ(stats.get<statistics::tag::moving_max>(), window->moving_max);
+	}
+}
+
+TEST_F(MovingWindowTest, MultipleIntervalsRate) {
+	opts.tags = statistics::tag::rate;
+	opts.rate_unit = handystats::chrono::time_unit::SEC;
+	opts.moving_intervals = {
+		handystats::chrono::duration(1, handystats::chrono::time_unit::SEC),
+		handystats::chrono::duration(10, handystats::chrono::time_unit::SEC)
+	};
+	statistics stats(opts);
+
+	// counter incremented by 5 every 10 msec -- 500 per second
+	for (int64_t msec = 0; msec <= 20000; msec += 10) {
+		stats.update(msec / 2, at(msec));
+	}
+
+	const auto& windows = stats.moving_windows();
+	ASSERT_EQ(windows.size(), 2);
+	ASSERT_NEAR(windows[0].rate, 500, 500 * 0.02);
+	ASSERT_NEAR(windows[1].rate, 500, 500 * 0.02);
+	ASSERT_NEAR(stats.get<statistics::tag::rate>(), 500, 500 * 0.02);
+}
+
+TEST_F(MovingWindowTest, MultipleIntervalsDump) {
+	rapidjson::Document config;
+	config.Parse<0>(
+			"{\
+				\"moving-intervals\": [1000, 10000, 60000, 1500],\
+				\"tags\": [\"moving-count\", \"moving-max\"]\
+			}"
+		);
+
+	handystats::config::statistics json_opts;
+	json_opts.configure(config);
+
+	ASSERT_EQ(json_opts.moving_intervals.size(), 4);
+	ASSERT_EQ(json_opts.moving_intervals[2], handystats::chrono::duration(1, handystats::chrono::time_unit::MIN));
+
+	statistics stats(json_opts);
+	const auto& timestamp = statistics::clock::now();
+	stats.update(-5, timestamp - handystats::chrono::duration(5, handystats::chrono::time_unit::SEC));
+	stats.update(7, timestamp);
+
+	rapidjson::Value json_value;
+	rapidjson::MemoryPoolAllocator<> allocator;
+	handystats::json::write_to_json_value(&stats, &json_value, allocator);
+
+	ASSERT_EQ(json_value["1s"]["moving-count"].GetDouble(), 1);
+	ASSERT_EQ(json_value["1500ms"]["moving-count"].GetDouble(), 1);
+	ASSERT_EQ(json_value["10s"]["moving-count"].GetDouble(), 2);
+	ASSERT_EQ(json_value["1m"]["moving-count"].GetDouble(), 2);
+	ASSERT_EQ(json_value["1m"]["moving-max"].GetDouble(), 7);
+	ASSERT_FALSE(json_value["1m"].HasMember("moving-sum"));
+
+	ASSERT_EQ(handystats::json::interval_name(handystats::chrono::duration(5, handystats::chrono::time_unit::MIN)), "5m");
+	ASSERT_EQ(handystats::json::interval_name(handystats::chrono::duration(2, handystats::chrono::time_unit::HOUR)), "2h");
+}
@@ -0,0 +1,253 @@
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <map>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class PackedQueueTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"message-queue\": {\
+						\"topology\": \"packed\",\
+						\"log-capacity\": 4096\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(PackedQueueTest, TopologyConfiguration) {
+	ASSERT_EQ(handystats::config::message_queue_opts.topology, handystats::config::message_queue::PACKED);
+	ASSERT_EQ(handystats::config::message_queue_opts.log_capacity, 4096);
+}
+
+TEST_F(PackedQueueTest, MultipleProducerThreads) {
+	const size_t THREADS_COUNT = 8;
+	const size_t INCR_COUNT = 1000;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < producers.size(); ++index) {
+		producers[index] = std::thread(
+				[index, INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter", 1);
+						TEST_COUNTER_INCREMENT("test.counter." + std::to_string(index), 1);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			THREADS_COUNT * INCR_COUNT
+		);
+
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		ASSERT_EQ(
+				boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter." + std::to_string(index)))
+					.values().get<handystats::statistics::tag::value>(),
+				INCR_COUNT
+			);
+	}
+}
+
+TEST_F(PackedQueueTest, EventsOrderWithinThreadIsPreserved) {
+	const size_t THREADS_COUNT = 4;
+	const size_t STEPS_COUNT = 500;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < producers.size(); ++index) {
+		producers[index] = std::thread(
+				[index, STEPS_COUNT] () {
+					const std::string gauge_name = "test.gauge." + std::to_string(index);
+					for (size_t step = 0; step <= STEPS_COUNT; ++step) {
+						TEST_GAUGE_SET(gauge_name.substr(), step);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("test.gauge." + std::to_string(index)));
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), STEPS_COUNT);
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::count>(), STEPS_COUNT + 1);
+	}
+}
+
+TEST_F(PackedQueueTest, AttributeValuesAreDecoded) {
+	// long names and strings wrap around small log many times
+	const std::string long_value(1000, 'x');
+
+	for (int step = 0; step < 100; ++step) {
+		HANDY_ATTRIBUTE_SET_BOOL("test.attribute.bool", step % 2 == 1);
+		HANDY_ATTRIBUTE_SET_INT("test.attribute.int", -step);
+		HANDY_ATTRIBUTE_SET_UINT("test.attribute.uint", unsigned(step));
+		HANDY_ATTRIBUTE_SET_INT64("test.attribute.int64", -int64_t(step) << 40);
+		HANDY_ATTRIBUTE_SET_UINT64("test.attribute.uint64", uint64_t(step) << 40);
+		HANDY_ATTRIBUTE_SET_DOUBLE("test.attribute.double", step / 4.0);
+		HANDY_ATTRIBUTE_SET_STRING(std::string("test.attribute.string.") + long_value, long_value + std::to_string(step));
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(boost::get<bool>(boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.bool")).value()), true);
+	ASSERT_EQ(boost::get<int>(boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.int")).value()), -99);
+	ASSERT_EQ(boost::get<unsigned>(boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.uint")).value()), 99);
+	ASSERT_EQ(
+			boost::get<int64_t>(boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.int64")).value()),
+			-int64_t(99) << 40
+		);
+	ASSERT_EQ(
+			boost::get<uint64_t>(boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.uint64")).value()),
+			uint64_t(99) << 40
+		);
+	ASSERT_EQ(boost::get<double>(boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.double")).value()), 24.75);
+	ASSERT_EQ(
+			boost::get<std::string>(
+				boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.string." + long_value)).value()
+			),
+			long_value + "99"
+		);
+}
+
+TEST_F(PackedQueueTest, LiteralAndHandleDestinations) {
+	auto counter_handle = HANDY_COUNTER_HANDLE("test.handle.counter");
+
+	for (int step = 0; step < 1000; ++step) {
+		HANDY_COUNTER_INCREMENT("test.literal.counter", 1);
+		HANDY_COUNTER_INCREMENT(counter_handle, 2);
+		HANDY_TIMER_SET("test.literal.timer", handystats::chrono::duration(step, handystats::chrono::time_unit::USEC));
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.literal.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			1000
+		);
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.handle.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			2000
+		);
+	ASSERT_EQ(
+			boost::get<handystats::metrics::timer>(metrics_dump->at("test.literal.timer"))
+				.values().get<handystats::statistics::tag::count>(),
+			1000
+		);
+}
+
+TEST_F(PackedQueueTest, ExitedThreadsLogsAreDrained) {
+	for (int round = 0; round < 10; ++round) {
+		std::thread producer(
+				[] () {
+					for (int step = 0; step < 100; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter", 1);
+					}
+				}
+			);
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	ASSERT_EQ(handystats::message_queue::size(), 0);
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			1000
+		);
+}
+
+TEST_F(PackedQueueTest, LargeRecordsInAdoptedLog) {
+	// exited thread's log is adopted with its producer-side cached tail left behind
+	std::thread(
+			[] () {
+				for (int step = 0; step < 100; ++step) {
+					TEST_COUNTER_INCREMENT("test.counter", 1);
+				}
+			}
+		).join();
+
+	handystats::message_queue::wait_until_empty();
+
+	// records with padding take more than half of the log, so that they are admitted only with fresh tail
+	const std::string long_value(1900, 'x');
+	std::thread(
+			[&long_value] () {
+				for (int step = 0; step < 100; ++step) {
+					HANDY_ATTRIBUTE_SET_STRING("test.attribute.large", long_value + std::to_string(step));
+				}
+			}
+		).join();
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<std::string>(
+				boost::get<handystats::metrics::attribute>(metrics_dump->at("test.attribute.large")).value()
+			),
+			long_value + "99"
+		);
+}
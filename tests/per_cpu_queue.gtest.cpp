@@ -0,0 +1,178 @@
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include <sched.h>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "cpu_topology_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class PerCpuQueueTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"message-queue\": {\
+						\"topology\": \"per-cpu\"\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST(CpuTopologyTest, CpusAreOrderedByNode) {
+	const size_t cpus_count = handystats::cpu_topology::cpus_count();
+	ASSERT_GT(cpus_count, 0);
+
+	std::vector<size_t> cpus = handystats::cpu_topology::cpus_by_node();
+	ASSERT_EQ(cpus.size(), cpus_count);
+
+	for (size_t index = 1; index < cpus.size(); ++index) {
+		ASSERT_LE(handystats::cpu_topology::node_of(cpus[index - 1]), handystats::cpu_topology::node_of(cpus[index]));
+	}
+
+	std::sort(cpus.begin(), cpus.end());
+	for (size_t cpu = 0; cpu < cpus_count; ++cpu) {
+		ASSERT_EQ(cpus[cpu], cpu);
+	}
+
+	ASSERT_LT(handystats::cpu_topology::current_cpu(), cpus_count);
+}
+
+TEST_F(PerCpuQueueTest, TopologyConfiguration) {
+	ASSERT_EQ(handystats::config::message_queue_opts.topology, handystats::config::message_queue::PER_CPU);
+}
+
+TEST_F(PerCpuQueueTest, MultipleProducerThreads) {
+	const size_t THREADS_COUNT = 16;
+	const size_t INCR_COUNT = 1000;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < producers.size(); ++index) {
+		producers[index] = std::thread(
+				[index, INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter", 1);
+						TEST_COUNTER_INCREMENT("test.counter." + std::to_string(index), 1);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			THREADS_COUNT * INCR_COUNT
+		);
+
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		ASSERT_EQ(
+				boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter." + std::to_string(index)))
+					.values().get<handystats::statistics::tag::value>(),
+				INCR_COUNT
+			);
+	}
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handystats.message_queue.pop_count"))
+				.values().get<handystats::statistics::tag::value>(),
+			2 * THREADS_COUNT * INCR_COUNT
+		);
+}
+
+TEST_F(PerCpuQueueTest, EventsOrderOfMigratingThreadIsPreserved) {
+	const size_t STEPS_COUNT = 5000;
+	const size_t cpus_count = handystats::cpu_topology::cpus_count();
+
+	std::thread producer(
+			[STEPS_COUNT, cpus_count] () {
+				for (size_t step = 0; step <= STEPS_COUNT; ++step) {
+					// thread is moved over CPUs while its previous queues still hold events
+					if (step % 100 == 0) {
+						cpu_set_t cpu_set;
+						CPU_ZERO(&cpu_set);
+						CPU_SET((step / 100) % cpus_count, &cpu_set);
+						sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+					}
+					TEST_GAUGE_SET("test.gauge", step);
+				}
+			}
+		);
+	producer.join();
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("test.gauge"));
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), STEPS_COUNT);
+	ASSERT_EQ(gauge.values().get<handystats::statistics::tag::count>(), STEPS_COUNT + 1);
+}
+
+TEST_F(PerCpuQueueTest, QueuesAreDrainedOnReinitialization) {
+	for (int step = 0; step < 1000; ++step) {
+		TEST_COUNTER_INCREMENT("test.counter", 1);
+	}
+
+	HANDY_FINALIZE();
+	ASSERT_EQ(handystats::message_queue::size(), 0);
+
+	HANDY_CONFIG_JSON(
+			"{\
+				\"message-queue\": {\
+					\"topology\": \"per-cpu\"\
+				},\
+				\"metrics-dump\": {\
+					\"interval\": 10\
+				}\
+			}"
+		);
+	HANDY_INIT();
+
+	TEST_COUNTER_INCREMENT("test.counter", 1);
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			1
+		);
+}
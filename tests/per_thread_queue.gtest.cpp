@@ -0,0 +1,185 @@
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <map>
+#include <memory>
+
+#include <pthread.h>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class PerThreadQueueTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"message-queue\": {\
+						\"topology\": \"per-thread\",\
+						\"ring-capacity\": 16\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(PerThreadQueueTest, TopologyConfiguration) {
+	ASSERT_EQ(handystats::config::message_queue_opts.topology, handystats::config::message_queue::PER_THREAD);
+	ASSERT_EQ(handystats::config::message_queue_opts.ring_capacity, 16);
+}
+
+TEST_F(PerThreadQueueTest, MultipleProducerThreads) {
+	const size_t THREADS_COUNT = 8;
+	const size_t INCR_COUNT = 1000;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < producers.size(); ++index) {
+		producers[index] = std::thread(
+				[index, INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter", 1);
+						TEST_COUNTER_INCREMENT("test.counter." + std::to_string(index), 1);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			THREADS_COUNT * INCR_COUNT
+		);
+
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		ASSERT_EQ(
+				boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter." + std::to_string(index)))
+					.values().get<handystats::statistics::tag::value>(),
+				INCR_COUNT
+			);
+	}
+}
+
+TEST_F(PerThreadQueueTest, EventsOrderWithinThreadIsPreserved) {
+	const size_t THREADS_COUNT = 4;
+	const size_t STEPS_COUNT = 500;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (size_t index = 0; index < producers.size(); ++index) {
+		producers[index] = std::thread(
+				[index, STEPS_COUNT] () {
+					const std::string gauge_name = "test.gauge." + std::to_string(index);
+					for (size_t step = 0; step <= STEPS_COUNT; ++step) {
+						TEST_GAUGE_SET(gauge_name.substr(), step);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (size_t index = 0; index < THREADS_COUNT; ++index) {
+		const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("test.gauge." + std::to_string(index)));
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), STEPS_COUNT);
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::count>(), STEPS_COUNT + 1);
+	}
+}
+
+TEST_F(PerThreadQueueTest, ExitedThreadsRingsAreDrained) {
+	for (int round = 0; round < 10; ++round) {
+		std::thread producer(
+				[] () {
+					for (int step = 0; step < 100; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter", 1);
+					}
+				}
+			);
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	ASSERT_EQ(handystats::message_queue::size(), 0);
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			1000
+		);
+}
+
+// key is created after handystats' thread keys, so its destructor runs after theirs
+static void increment_on_thread_exit(void*) {
+	TEST_COUNTER_INCREMENT("test.counter", 1);
+}
+
+TEST_F(PerThreadQueueTest, EventsOfExitingThreadDestructorsAreKept) {
+	TEST_COUNTER_INCREMENT("test.counter", 1);
+
+	pthread_key_t exit_key;
+	pthread_key_create(&exit_key, increment_on_thread_exit);
+
+	for (int round = 0; round < 10; ++round) {
+		std::thread producer(
+				[exit_key] () {
+					pthread_setspecific(exit_key, &exit_key);
+					TEST_COUNTER_INCREMENT("test.counter", 1);
+				}
+			);
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			21
+		);
+
+	pthread_key_delete(exit_key);
+}
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <thread>
+#include <string>
+#include <sched.h>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "message_queue_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class ProcessorIdleTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		// processor parks immediately and for long if nobody wakes it up
+		HANDY_CONFIG_JSON(
+				"{\
+					\"core\": {\
+						\"idle-spins\": 0,\
+						\"idle-yields\": 0,\
+						\"idle-park-timeout\": 10000,\
+						\"processor-affinity\": [0],\
+						\"processor-policy\": \"idle\",\
+						\"processor-nice\": 10\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 0\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(ProcessorIdleTest, CoreConfiguration) {
+	ASSERT_EQ(handystats::config::core_opts.idle_spins, 0);
+	ASSERT_EQ(handystats::config::core_opts.idle_yields, 0);
+	ASSERT_EQ(handystats::config::core_opts.idle_park_timeout,
+			handystats::chrono::duration(10, handystats::chrono::time_unit::SEC));
+	ASSERT_EQ(handystats::config::core_opts.processor_affinity, std::vector<int>(1, 0));
+	ASSERT_EQ(handystats::config::core_opts.processor_policy, SCHED_IDLE);
+	ASSERT_TRUE(handystats::config::core_opts.processor_nice_enabled);
+	ASSERT_EQ(handystats::config::core_opts.processor_nice, 10);
+}
+
+TEST_F(ProcessorIdleTest, ParkedProcessorIsWokenByProducer) {
+	for (int round = 0; round < 10; ++round) {
+		// let processor park
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		auto start_time = std::chrono::steady_clock::now();
+
+		TEST_COUNTER_INCREMENT("test.counter");
+		handystats::message_queue::wait_until_empty();
+
+		ASSERT_LT(std::chrono::steady_clock::now() - start_time, std::chrono::seconds(1));
+	}
+}
+
+TEST_F(ProcessorIdleTest, FinalizeWakesParkedProcessor) {
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	auto start_time = std::chrono::steady_clock::now();
+
+	HANDY_FINALIZE();
+
+	ASSERT_LT(std::chrono::steady_clock::now() - start_time, std::chrono::seconds(1));
+}
@@ -0,0 +1,122 @@
+#include <thread>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "message_queue_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class ProducerBufferTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"message-queue\": {\
+						\"producer-buffer\": 16,\
+						\"producer-buffer-age\": 100000\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+
+	static uint64_t counter_value(const char* name) {
+		handystats::message_queue::wait_until_empty();
+		handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+		auto metrics_dump = HANDY_METRICS_DUMP();
+		if (metrics_dump->find(name) == metrics_dump->end()) {
+			return 0;
+		}
+		return boost::get<handystats::metrics::counter>(metrics_dump->at(name))
+			.values().get<handystats::statistics::tag::value>();
+	}
+};
+
+TEST_F(ProducerBufferTest, BufferConfiguration) {
+	ASSERT_EQ(handystats::config::message_queue_opts.producer_buffer_size, 16);
+	ASSERT_EQ(handystats::config::message_queue_opts.producer_buffer_age,
+			handystats::chrono::duration(100, handystats::chrono::time_unit::SEC));
+}
+
+TEST_F(ProducerBufferTest, FlushBySize) {
+	for (int step = 0; step < 40; ++step) {
+		TEST_COUNTER_INCREMENT("test.counter", 1);
+	}
+
+	// two full chains are published, the rest is kept in thread's buffer
+	ASSERT_EQ(counter_value("test.counter"), 32);
+
+	HANDY_FLUSH_THREAD();
+	ASSERT_EQ(counter_value("test.counter"), 40);
+}
+
+TEST_F(ProducerBufferTest, FlushByAge) {
+	handystats::config::message_queue_opts.producer_buffer_age = handystats::chrono::duration(1, handystats::chrono::time_unit::MSEC);
+
+	TEST_COUNTER_INCREMENT("test.counter", 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	TEST_COUNTER_INCREMENT("test.counter", 1);
+	// the last event gets stale in the buffer as well
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+	ASSERT_EQ(counter_value("test.counter"), 2);
+}
+
+TEST_F(ProducerBufferTest, FlushOnThreadExit) {
+	const size_t THREADS_COUNT = 8;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[] () {
+					for (int step = 0; step < 100; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter", 1);
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	ASSERT_EQ(counter_value("test.counter"), THREADS_COUNT * 100);
+}
+
+TEST_F(ProducerBufferTest, StaleBufferOfIdleThreadIsFlushed) {
+	handystats::config::message_queue_opts.producer_buffer_age = handystats::chrono::duration(1, handystats::chrono::time_unit::MSEC);
+
+	std::thread producer(
+			[] () {
+				TEST_COUNTER_INCREMENT("test.counter", 1);
+				// thread stays idle with buffered event
+				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			}
+		);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	ASSERT_EQ(counter_value("test.counter"), 1);
+
+	producer.join();
+}
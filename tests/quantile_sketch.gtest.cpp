@@ -0,0 +1,179 @@
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <handystats/statistics.hpp>
+#include <handystats/quantile_sketch.hpp>
+#include <handystats/rapidjson/document.h>
+
+#include <handystats/chrono.hpp>
+
+using handystats::statistics;
+using handystats::quantile_sketch;
+
+class QuantileSketchTest : public ::testing::TestWithParam<double> {
+protected:
+	virtual void SetUp() {
+		srand(1);
+	}
+
+	// heavy-tailed values of unknown range: from 1 to ~1e9
+	static double random_value() {
+		return std::floor(std::exp(20.0 * std::pow(double(rand()) / RAND_MAX, 2)));
+	}
+
+	static double exact_quantile(const std::vector<double>& sorted_values, const double& probability) {
+		return sorted_values[size_t(std::ceil(probability * sorted_values.size())) - 1];
+	}
+};
+
+TEST_P(QuantileSketchTest, QuantilesWithinRelativeAccuracy) {
+	// enough buckets for the whole range
+	quantile_sketch sketch(GetParam(), 10000);
+	std::vector<double> values;
+
+	for (size_t index = 0; index < 20000; ++index) {
+		const double value = (index % 10 == 0 ? -1 : 1) * random_value();
+		values.push_back(value);
+		sketch.add(value);
+	}
+
+	std::sort(values.begin(), values.end());
+
+	const double probabilities[] = {0.01, 0.05, 0.25, 0.5, 0.9, 0.99, 0.999};
+	for (const double& probability : probabilities) {
+		const double exact = exact_quantile(values, probability);
+		// bound is inclusive, values on buckets' bounds are off by rounding
+		EXPECT_NEAR(sketch.quantile(probability), exact, std::abs(exact) * GetParam() * (1 + 1E-9)) << "p = " << probability;
+	}
+}
+
+TEST_P(QuantileSketchTest, CollapsedSketchKeepsTail) {
+	const size_t MAX_BUCKETS = 64;
+	quantile_sketch sketch(GetParam(), MAX_BUCKETS);
+	std::vector<double> values;
+
+	for (size_t index = 0; index < 20000; ++index) {
+		const double value = random_value();
+		values.push_back(value);
+		sketch.add(value);
+	}
+
+	std::sort(values.begin(), values.end());
+
+	const auto& buckets = sketch.buckets();
+	ASSERT_EQ(buckets.size(), MAX_BUCKETS);
+	ASSERT_NEAR(sketch.count(), values.size(), 1E-6);
+
+	// values below the lowest bucket are collapsed into it
+	const double& collapsed_bound = buckets.front().upper;
+	ASSERT_GT(collapsed_bound, values.front());
+
+	const double probabilities[] = {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0};
+	for (const double& probability : probabilities) {
+		const double exact = exact_quantile(values, probability);
+		const double& quantile = sketch.quantile(probability);
+		if (exact <= collapsed_bound) {
+			// the lowest bucket's value overestimates collapsed values
+			EXPECT_GE(quantile * (1 + GetParam()), exact) << "p = " << probability;
+			EXPECT_LE(quantile, collapsed_bound) << "p = " << probability;
+		}
+		else {
+			EXPECT_NEAR(quantile, exact, exact * GetParam() * (1 + 1E-9)) << "p = " << probability;
+		}
+	}
+}
+
+TEST_P(QuantileSketchTest, MergeEqualsCombinedSketch) {
+	quantile_sketch left(GetParam(), 10000);
+	quantile_sketch right(GetParam(), 10000);
+	quantile_sketch both(GetParam(), 10000);
+
+	for (size_t index = 0; index < 5000; ++index) {
+		const double value = (index % 7 == 0 ? 0 : 1) * random_value();
+		(index % 2 ? left : right).add(value);
+		both.add(value);
+	}
+	right.scale(0.25);
+	right.scale(4.0);
+
+	left.merge(right);
+
+	const auto& merged_buckets = left.buckets();
+	const auto& expected_buckets = both.buckets();
+
+	ASSERT_EQ(merged_buckets.size(), expected_buckets.size());
+	for (size_t index = 0; index < merged_buckets.size(); ++index) {
+		ASSERT_DOUBLE_EQ(merged_buckets[index].lower, expected_buckets[index].lower);
+		ASSERT_DOUBLE_EQ(merged_buckets[index].upper, expected_buckets[index].upper);
+		ASSERT_NEAR(merged_buckets[index].count, expected_buckets[index].count, 1E-9);
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(RelativeAccuracy, QuantileSketchTest, ::testing::Values(0.005, 0.01, 0.05));
+
+TEST(QuantileSketchDefaultTest, LognormalWithinRelativeAccuracy) {
+	const handystats::config::statistics opts;
+	quantile_sketch sketch(opts.sketch_relative_accuracy, opts.sketch_max_buckets);
+
+	// lognormal(8, 2) values, Box-Muller transform
+	srand(1);
+	std::vector<double> values;
+	for (size_t index = 0; index < 100000; ++index) {
+		const double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+		const double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+		const double value = std::exp(8 + 2 * std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2));
+		values.push_back(value);
+		sketch.add(value);
+	}
+
+	std::sort(values.begin(), values.end());
+
+	ASSERT_LE(sketch.buckets().size(), opts.sketch_max_buckets);
+
+	const double probabilities[] = {0.0001, 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 0.9999};
+	for (const double& probability : probabilities) {
+		const double exact = values[size_t(std::ceil(probability * values.size())) - 1];
+		EXPECT_NEAR(sketch.quantile(probability), exact, exact * opts.sketch_relative_accuracy * (1 + 1E-9))
+			<< "p = " << probability;
+	}
+}
+
+TEST(QuantileSketchConfigTest, SketchFromJson) {
+	rapidjson::Document config;
+	config.Parse<0>(
+			"{\
+				\"histogram-type\": \"sketch\",\
+				\"sketch-relative-accuracy\": 0.02,\
+				\"sketch-max-buckets\": 32,\
+				\"tags\": [\"quantile\", \"moving-count\"]\
+			}"
+		);
+
+	handystats::config::statistics opts;
+	opts.configure(config);
+
+	ASSERT_EQ(opts.histogram_type, handystats::config::statistics::SKETCH);
+	ASSERT_DOUBLE_EQ(opts.sketch_relative_accuracy, 0.02);
+	ASSERT_EQ(opts.sketch_max_buckets, 32);
+
+	statistics stats(opts);
+	const auto& base_time = statistics::clock::now();
+	for (int64_t index = 0; index < 1000; ++index) {
+		stats.update(index + 1, base_time + handystats::chrono::duration(index, handystats::chrono::time_unit::USEC));
+	}
+
+	const auto& histogram = stats.get<statistics::tag::histogram>();
+	ASSERT_LE(histogram.size(), 32);
+
+	double count = 0;
+	for (size_t bin = 0; bin < histogram.size(); ++bin) {
+		count += std::get<statistics::BIN_COUNT>(histogram[bin]);
+	}
+	ASSERT_NEAR(count, stats.get<statistics::tag::moving_count>(), 1E-6);
+
+	ASSERT_NEAR(stats.get<statistics::tag::quantile>().at(0.99), 990, 990 * 0.02);
+}
@@ -0,0 +1,119 @@
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <handystats/statistics.hpp>
+#include <handystats/json/statistics_json_writer.hpp>
+#include <handystats/rapidjson/document.h>
+
+#include <handystats/chrono.hpp>
+
+using handystats::statistics;
+
+class QuantilesTest : public ::testing::TestWithParam<handystats::config::statistics::histogram_kind> {
+protected:
+	virtual void SetUp() {
+		srand(1);
+
+		opts.histogram_type = GetParam();
+		opts.histogram_bins = 30;
+		opts.moving_interval = handystats::chrono::duration(1, handystats::chrono::time_unit::SEC);
+		opts.tags = statistics::tag::quantile;
+	}
+
+	handystats::config::statistics opts;
+};
+
+TEST_P(QuantilesTest, SinglePassMatchesSeparateQuantiles) {
+	statistics stats(opts);
+
+	const auto& base_time = handystats::chrono::tsc_clock::now();
+	for (int64_t index = 0; index < 5000; ++index) {
+		stats.update(
+				std::exp(10.0 * rand() / RAND_MAX),
+				base_time + handystats::chrono::duration(index, handystats::chrono::time_unit::USEC)
+			);
+	}
+
+	const auto& quantile = stats.get<statistics::tag::quantile>();
+
+	// unordered with duplicates and bounds
+	const std::vector<double> probabilities = {0.999, 0.5, 0.0, 0.99, 0.25, 1.0, 0.5, 0.9};
+	const std::vector<double>& values = quantile.at(probabilities);
+
+	ASSERT_EQ(values.size(), probabilities.size());
+	for (size_t index = 0; index < probabilities.size(); ++index) {
+		const double expected = quantile.at(probabilities[index]);
+		// adaptive histogram's interpolation at the side bins (a double root) amplifies rounding of the counts sum
+		ASSERT_NEAR(values[index], expected, std::abs(expected) * 1E-6) << "p = " << probabilities[index];
+	}
+
+	for (size_t index = 1; index < probabilities.size(); ++index) {
+		if (probabilities[index - 1] < probabilities[index]) {
+			ASSERT_LE(values[index - 1], values[index]);
+		}
+	}
+}
+
+TEST_P(QuantilesTest, ConfiguredQuantilesInJson) {
+	rapidjson::Document config;
+	config.Parse<0>("{\"quantiles\": [0.5, 0.99, 0.999]}");
+	opts.configure(config);
+
+	statistics stats(opts);
+	const auto& timestamp = handystats::chrono::tsc_clock::now();
+	for (int value = 1; value <= 1000; ++value) {
+		stats.update(value, timestamp);
+	}
+
+	const auto& quantile = stats.get<statistics::tag::quantile>();
+	ASSERT_EQ(quantile.probabilities(), std::vector<double>({0.5, 0.99, 0.999}));
+	ASSERT_EQ(&quantile.values(), &quantile.values());
+
+	rapidjson::Value json_value;
+	rapidjson::MemoryPoolAllocator<> allocator;
+	handystats::json::write_to_json_value(&stats, &json_value, allocator);
+
+	ASSERT_FALSE(json_value.HasMember("p25"));
+	ASSERT_FALSE(json_value.HasMember("p95"));
+	ASSERT_NEAR(json_value["p50"].GetDouble(), 500, 500 * 0.05);
+	ASSERT_NEAR(json_value["p99"].GetDouble(), 990, 990 * 0.05);
+	ASSERT_NEAR(json_value["p999"].GetDouble(), 999, 999 * 0.05);
+}
+
+INSTANTIATE_TEST_CASE_P(HistogramTypes, QuantilesTest,
+		::testing::Values(
+			handystats::config::statistics::ADAPTIVE,
+			handystats::config::statistics::LOG_LINEAR,
+			handystats::config::statistics::SKETCH
+		)
+	);
+
+TEST(QuantileNameTest, PercentNames) {
+	ASSERT_EQ(handystats::json::quantile_name(0.25), "p25");
+	ASSERT_EQ(handystats::json::quantile_name(0.5), "p50");
+	ASSERT_EQ(handystats::json::quantile_name(0.95), "p95");
+	ASSERT_EQ(handystats::json::quantile_name(0.999), "p999");
+	ASSERT_EQ(handystats::json::quantile_name(0.9999), "p9999");
+	ASSERT_EQ(handystats::json::quantile_name(1.0), "p100");
+}
+
+TEST(QuantileNameTest, FractionalPercentsBelowTenAreUnambiguous) {
+	ASSERT_EQ(handystats::json::quantile_name(0.991), "p991");
+	ASSERT_EQ(handystats::json::quantile_name(0.0991), "p9_91");
+	ASSERT_EQ(handystats::json::quantile_name(0.05), "p5");
+	ASSERT_EQ(handystats::json::quantile_name(0.001), "p0_1");
+}
+
+TEST(QuantileConfigTest, DuplicateQuantilesAreReportedOnce) {
+	rapidjson::Document config;
+	config.Parse<0>("{\"quantiles\": [0.99, 0.5, 0.99, 0.5]}");
+
+	handystats::config::statistics opts;
+	opts.configure(config);
+
+	ASSERT_EQ(opts.quantiles, std::vector<double>({0.5, 0.99}));
+}
@@ -0,0 +1,165 @@
+#include <vector>
+#include <thread>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class SelfStatsTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"core\": {\
+						\"processor-threads\": 2\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+static int64_t counter_value(
+		const std::map<std::string, handystats::metrics::metric_variant>& metrics_dump,
+		const std::string& name
+	)
+{
+	return boost::get<handystats::metrics::counter>(metrics_dump.at(name))
+		.values().get<handystats::statistics::tag::value>();
+}
+
+// processing could still be in progress when the queue gets empty
+static std::shared_ptr<const std::map<std::string, handystats::metrics::metric_variant>>
+wait_processed(const std::string& name, const int64_t& count) {
+	handystats::message_queue::wait_until_empty();
+
+	while (true) {
+		handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+		auto metrics_dump = HANDY_METRICS_DUMP();
+		if (counter_value(*metrics_dump, name) >= count) {
+			return metrics_dump;
+		}
+	}
+}
+
+TEST_F(SelfStatsTest, EventsAreCountedByType) {
+	const size_t THREADS_COUNT = 4;
+	const size_t INCR_COUNT = 1000;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						TEST_COUNTER_INCREMENT("test.counter." + std::to_string(step % 8), 1);
+						TEST_TIMER_SET("test.timer", handystats::chrono::duration(step, handystats::chrono::time_unit::USEC));
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	auto metrics_dump = wait_processed("handystats.self.processed.timer", THREADS_COUNT * INCR_COUNT);
+
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.counter"), THREADS_COUNT * INCR_COUNT);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.counter.increment"), THREADS_COUNT * INCR_COUNT);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.counter.decrement"), 0);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.timer.set"), THREADS_COUNT * INCR_COUNT);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.gauge"), 0);
+
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.processed.counter.increment"), THREADS_COUNT * INCR_COUNT);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.processed.timer.set"), THREADS_COUNT * INCR_COUNT);
+
+	// times are sampled
+	const auto& process_time =
+		boost::get<handystats::metrics::gauge>(metrics_dump->at("handystats.self.process_time.counter"));
+	ASSERT_GT(process_time.values().get<handystats::statistics::tag::value>(), 0);
+
+	const auto& enqueue_time =
+		boost::get<handystats::metrics::gauge>(metrics_dump->at("handystats.self.enqueue_time.timer"));
+	ASSERT_GT(enqueue_time.values().get<handystats::statistics::tag::value>(), 0);
+}
+
+TEST_F(SelfStatsTest, HandleSetsAreCounted) {
+	auto gauge_handle = HANDY_GAUGE_HANDLE("test.gauge");
+	auto attribute_handle = HANDY_ATTRIBUTE_HANDLE("test.attribute");
+
+	for (int step = 0; step < 100; ++step) {
+		HANDY_GAUGE_SET(gauge_handle, step);
+		HANDY_ATTRIBUTE_SET_INT(attribute_handle, step);
+	}
+
+	auto metrics_dump = wait_processed("handystats.self.produced.gauge", 100);
+
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.gauge.set"), 100);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.attribute.set_int"), 100);
+	// sets coalesced in slots are processed at most once per dump
+	ASSERT_GE(counter_value(*metrics_dump, "handystats.self.processed.gauge.set"), 1);
+}
+
+TEST_F(SelfStatsTest, CountersStartFromZeroAfterReinit) {
+	for (int step = 0; step < 100; ++step) {
+		TEST_COUNTER_INCREMENT("test.counter", 1);
+	}
+	wait_processed("handystats.self.processed.counter", 100);
+
+	HANDY_FINALIZE();
+	HANDY_INIT();
+
+	for (int step = 0; step < 10; ++step) {
+		TEST_COUNTER_INCREMENT("test.counter", 1);
+	}
+
+	auto metrics_dump = wait_processed("handystats.self.processed.counter", 10);
+
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.produced.counter"), 10);
+	ASSERT_EQ(counter_value(*metrics_dump, "handystats.self.processed.counter"), 10);
+}
+
+TEST(SelfStatsConfigTest, SelfStatsCouldBeDisabled) {
+	HANDY_CONFIG_JSON(
+			"{\
+				\"metrics-dump\": {\
+					\"interval\": 10,\
+					\"self-stats\": false\
+				}\
+			}"
+		);
+	HANDY_INIT();
+
+	for (int step = 0; step < 100; ++step) {
+		TEST_COUNTER_INCREMENT("test.counter", 1);
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+	ASSERT_EQ(counter_value(*metrics_dump, "test.counter"), 100);
+	ASSERT_EQ(metrics_dump->count("handystats.self.produced.counter"), 0);
+	ASSERT_EQ(metrics_dump->count("handystats.self.processed.counter.increment"), 0);
+
+	HANDY_FINALIZE();
+}
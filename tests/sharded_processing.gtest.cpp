@@ -0,0 +1,141 @@
+#include <vector>
+#include <thread>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <handystats/core.hpp>
+#include <handystats/measuring_points.hpp>
+#include <handystats/metrics_dump.hpp>
+#include <handystats/module.h>
+
+#include "config_impl.hpp"
+#include "internal_impl.hpp"
+
+#include "message_queue_helper.hpp"
+#include "metrics_dump_helper.hpp"
+
+#ifndef _HAVE_HANDY_MODULE_TEST
+#define _HAVE_HANDY_MODULE_TEST 1
+#endif
+HANDY_MODULE(TEST)
+
+class ShardedProcessingTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		HANDY_CONFIG_JSON(
+				"{\
+					\"core\": {\
+						\"processor-threads\": 4\
+					},\
+					\"metrics-dump\": {\
+						\"interval\": 10\
+					}\
+				}"
+			);
+
+		HANDY_INIT();
+	}
+	virtual void TearDown() {
+		HANDY_FINALIZE();
+	}
+};
+
+TEST_F(ShardedProcessingTest, ShardsConfiguration) {
+	ASSERT_EQ(handystats::config::core_opts.processor_threads, 4);
+	ASSERT_EQ(handystats::internal::shards.size(), 4);
+}
+
+TEST_F(ShardedProcessingTest, MetricsAreMergedIntoSingleDump) {
+	const size_t THREADS_COUNT = 8;
+	const size_t METRICS_COUNT = 64;
+	const size_t INCR_COUNT = 100;
+
+	std::vector<std::thread> producers(THREADS_COUNT);
+	for (auto& producer : producers) {
+		producer = std::thread(
+				[METRICS_COUNT, INCR_COUNT] () {
+					for (size_t step = 0; step < INCR_COUNT; ++step) {
+						for (size_t index = 0; index < METRICS_COUNT; ++index) {
+							TEST_COUNTER_INCREMENT("test.counter." + std::to_string(index), 1);
+						}
+					}
+				}
+			);
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (size_t index = 0; index < METRICS_COUNT; ++index) {
+		ASSERT_EQ(
+				boost::get<handystats::metrics::counter>(metrics_dump->at("test.counter." + std::to_string(index)))
+					.values().get<handystats::statistics::tag::value>(),
+				THREADS_COUNT * INCR_COUNT
+			);
+	}
+
+	// metrics are spread over shards
+	size_t populated_shards = 0;
+	for (auto* metrics_shard : handystats::internal::shards) {
+		if (metrics_shard->size.load() > 0) {
+			++populated_shards;
+		}
+	}
+	ASSERT_GT(populated_shards, 1);
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("handystats.message_queue.pop_count"))
+				.values().get<handystats::statistics::tag::value>(),
+			THREADS_COUNT * INCR_COUNT * METRICS_COUNT
+		);
+}
+
+TEST_F(ShardedProcessingTest, NameLiteralAndHandleGoToSameShard) {
+	auto counter_handle = HANDY_COUNTER_HANDLE("test.shared.counter");
+
+	for (int step = 0; step < 100; ++step) {
+		TEST_COUNTER_INCREMENT("test.shared.counter", 1);
+		TEST_COUNTER_INCREMENT(std::string("test.shared.counter"), 1);
+		HANDY_COUNTER_INCREMENT(counter_handle, 1);
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	ASSERT_EQ(
+			boost::get<handystats::metrics::counter>(metrics_dump->at("test.shared.counter"))
+				.values().get<handystats::statistics::tag::value>(),
+			300
+		);
+}
+
+TEST_F(ShardedProcessingTest, EventsOrderWithinMetricIsPreserved) {
+	const size_t GAUGES_COUNT = 16;
+	const size_t STEPS_COUNT = 500;
+
+	for (size_t step = 0; step <= STEPS_COUNT; ++step) {
+		for (size_t index = 0; index < GAUGES_COUNT; ++index) {
+			TEST_GAUGE_SET("test.gauge." + std::to_string(index), step);
+		}
+	}
+
+	handystats::message_queue::wait_until_empty();
+	handystats::metrics_dump::wait_until(handystats::chrono::system_clock::now());
+
+	auto metrics_dump = HANDY_METRICS_DUMP();
+
+	for (size_t index = 0; index < GAUGES_COUNT; ++index) {
+		const auto& gauge = boost::get<handystats::metrics::gauge>(metrics_dump->at("test.gauge." + std::to_string(index)));
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::value>(), STEPS_COUNT);
+		ASSERT_EQ(gauge.values().get<handystats::statistics::tag::count>(), STEPS_COUNT + 1);
+	}
+}
@@ -1,5 +1,8 @@
 #include <thread>
 #include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
 
 #include <gtest/gtest.h>
 
@@ -7,6 +10,8 @@
 
 #include <handystats/chrono.hpp>
 
+#include "timestamps_helper.hpp"
+
 class IncrementalStatisticsTest : public ::testing::Test {
 protected:
 	virtual void SetUp() {
@@ -248,6 +253,103 @@ TEST_F(IncrementalStatisticsTest, ZeroRateTest) {
 		);
 }
 
+// Moving interval data shifted on every update and update_time
+struct eager_interval_data {
+	handystats::chrono::duration moving_interval;
+	double data;
+	handystats::statistics::time_point data_timestamp;
+	handystats::statistics::time_point timestamp;
+
+	double shift(const handystats::statistics::time_point& new_timestamp) const {
+		if (new_timestamp <= timestamp) return data;
+
+		const auto& stale_interval = data_timestamp - (new_timestamp - moving_interval);
+		if (stale_interval.count() <= 0) return 0;
+
+		return data * stale_interval.count() / (moving_interval - (timestamp - data_timestamp)).count();
+	}
+
+	void update(const double& value, const handystats::statistics::time_point& new_timestamp) {
+		if (new_timestamp <= timestamp) {
+			if (!(new_timestamp < timestamp - moving_interval)) {
+				data += value;
+			}
+		}
+		else {
+			data = value + shift(new_timestamp);
+		}
+
+		timestamp = std::max(timestamp, new_timestamp);
+		data_timestamp = std::max(data_timestamp, new_timestamp);
+	}
+
+	void update_time(const handystats::statistics::time_point& new_timestamp) {
+		data = shift(new_timestamp);
+		timestamp = std::max(timestamp, new_timestamp);
+	}
+};
+
+TEST_F(IncrementalStatisticsTest, LazyShiftMatchesEagerShift) {
+	opts.rate_unit = handystats::chrono::time_unit::SEC;
+	opts.moving_interval = handystats::chrono::duration(1000, handystats::chrono::time_unit::MSEC);
+	opts.tags = handystats::statistics::tag::rate | handystats::statistics::tag::moving_avg;
+
+	stats = handystats::statistics(opts);
+
+	eager_interval_data rate{opts.moving_interval, 0};
+	eager_interval_data moving_count{opts.moving_interval, 0};
+	eager_interval_data moving_sum{opts.moving_interval, 0};
+
+	auto expect_same = [&] () {
+		const double count = moving_count.data;
+		ASSERT_NEAR(stats.get<handystats::statistics::tag::rate>(), rate.data, 1E-9 * std::max(1.0, std::abs(rate.data)));
+		ASSERT_NEAR(stats.get<handystats::statistics::tag::moving_count>(), count, 1E-9 * std::max(1.0, count));
+		ASSERT_NEAR(stats.get<handystats::statistics::tag::moving_sum>(), moving_sum.data, 1E-9 * std::max(1.0, moving_sum.data));
+		if (count > 1E-9) {
+			ASSERT_NEAR(stats.get<handystats::statistics::tag::moving_avg>(), moving_sum.data / count, 1E-6);
+		}
+	};
+
+	const handystats::chrono::test_timestamps<handystats::chrono::time_unit::MSEC> at;
+
+	srand(42);
+
+	double last_value = 0;
+	int64_t msec = 1;
+	for (size_t step = 0; step < 10000; ++step) {
+		// mostly in order, some late and expired samples, some gaps longer than moving interval
+		int64_t timestamp_msec = msec;
+		switch (rand() % 20) {
+			case 0: timestamp_msec = msec - rand() % 500; break;
+			case 1: timestamp_msec = msec - 1500; break;
+			case 2: msec += 2000; timestamp_msec = msec; break;
+			default: msec += rand() % 10; timestamp_msec = msec; break;
+		}
+
+		const double value = rand() % 1000;
+
+		stats.update(value, at(timestamp_msec));
+		rate.update(value - last_value, at(timestamp_msec));
+		moving_count.update(1, at(timestamp_msec));
+		moving_sum.update(value, at(timestamp_msec));
+		last_value = value;
+
+		if (step % 7 == 0) {
+			msec += rand() % 100;
+			stats.update_time(at(msec));
+			rate.update_time(at(msec));
+			moving_count.update_time(at(msec));
+			moving_sum.update_time(at(msec));
+		}
+
+		if (step % 100 == 0) {
+			expect_same();
+		}
+	}
+
+	expect_same();
+}
+
 class StatisticsTagDependency : public ::testing::Test {
 protected:
 	virtual void SetUp() {
@@ -352,3 +454,80 @@ TEST_F(StatisticsTagDependency, HistogramStatisticsCheck) {
 	ASSERT_FALSE(stats.computed(handystats::statistics::tag::moving_sum));
 	ASSERT_FALSE(stats.computed(handystats::statistics::tag::quantile));
 }
+
+TEST_F(StatisticsTagDependency, RateStatisticsCheck) {
+	opts.tags = handystats::statistics::tag::rate;
+	stats = handystats::statistics(opts);
+
+	ASSERT_TRUE(stats.computed(handystats::statistics::tag::rate));
+	ASSERT_TRUE(stats.computed(handystats::statistics::tag::value));
+	ASSERT_TRUE(stats.computed(handystats::statistics::tag::timestamp));
+
+	ASSERT_FALSE(stats.computed(handystats::statistics::tag::moving_count));
+	ASSERT_FALSE(stats.computed(handystats::statistics::tag::histogram));
+	ASSERT_FALSE(stats.computed(handystats::statistics::tag::min));
+}
+
+// Configurations of specialized update kernels compared with the generic kernel,
+// moving-max doesn't affect other statistics but takes the generic kernel
+TEST_F(StatisticsTagDependency, SpecializedKernelsMatchGenericKernel) {
+	using handystats::statistics;
+
+	const statistics::tag::type default_tags = handystats::config::statistics().tags;
+	const statistics::tag::type plans[] = {
+		default_tags,
+		statistics::tag::rate,
+		default_tags | statistics::tag::rate,
+		default_tags | statistics::tag::quantile
+	};
+	const handystats::config::statistics::histogram_kind histogram_types[] = {
+		handystats::config::statistics::ADAPTIVE,
+		handystats::config::statistics::LOG_LINEAR,
+		handystats::config::statistics::SKETCH
+	};
+
+	for (const auto& plan : plans) {
+		for (const auto& histogram_type : histogram_types) {
+			opts.tags = plan;
+			opts.histogram_type = histogram_type;
+			statistics specialized(opts);
+			opts.tags = plan | statistics::tag::moving_max;
+			statistics generic(opts);
+
+			srand(1);
+			const auto& base_time = handystats::chrono::tsc_clock::now();
+			for (int64_t step = 0; step < 10000; ++step) {
+				const double value = rand() % 1000;
+				const auto& timestamp = base_time + handystats::chrono::duration(step * 100, handystats::chrono::time_unit::USEC);
+				specialized.update(value, timestamp);
+				generic.update(value, timestamp);
+			}
+
+			for (statistics::tag::type t = statistics::tag::value; t <= statistics::tag::moving_max; t <<= 1) {
+				ASSERT_EQ(specialized.computed(t), generic.computed(t) && t != statistics::tag::moving_max) << "tag " << t;
+			}
+
+			if (specialized.computed(statistics::tag::value)) {
+				ASSERT_EQ(specialized.get<statistics::tag::value>(), generic.get<statistics::tag::value>());
+			}
+			if (specialized.computed(statistics::tag::min)) {
+				ASSERT_EQ(specialized.get<statistics::tag::min>(), generic.get<statistics::tag::min>());
+				ASSERT_EQ(specialized.get<statistics::tag::max>(), generic.get<statistics::tag::max>());
+				ASSERT_EQ(specialized.get<statistics::tag::count>(), generic.get<statistics::tag::count>());
+				ASSERT_EQ(specialized.get<statistics::tag::sum>(), generic.get<statistics::tag::sum>());
+				ASSERT_EQ(specialized.get<statistics::tag::moving_count>(), generic.get<statistics::tag::moving_count>());
+				ASSERT_EQ(specialized.get<statistics::tag::moving_sum>(), generic.get<statistics::tag::moving_sum>());
+			}
+			if (specialized.computed(statistics::tag::rate)) {
+				ASSERT_EQ(specialized.get<statistics::tag::rate>(), generic.get<statistics::tag::rate>());
+			}
+			if (specialized.computed(statistics::tag::quantile)) {
+				ASSERT_EQ(
+						specialized.get<statistics::tag::quantile>().values(),
+						generic.get<statistics::tag::quantile>().values()
+					);
+			}
+			ASSERT_EQ(specialized.get<statistics::tag::timestamp>(), generic.get<statistics::tag::timestamp>());
+		}
+	}
+}
@@ -0,0 +1,260 @@
+#include <vector>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <handystats/statistics.hpp>
+
+#include <handystats/chrono.hpp>
+
+#include "timestamps_helper.hpp"
+
+using handystats::statistics;
+
+// Random stream of updates is split into random partitions,
+// merge of partitions' statistics is compared with statistics of the whole stream.
+class StatisticsMergeTest : public ::testing::TestWithParam<int> {
+protected:
+	struct update_type {
+		statistics::time_point timestamp;
+		double value;
+		size_t partition;
+	};
+
+	virtual void SetUp() {
+		srand(GetParam());
+
+		partitions = 2 + rand() % 7;
+
+		int64_t usec = 0;
+		for (size_t index = 0; index < 3000; ++index) {
+			// bursts and idle periods
+			usec += (index % 500 < 400) ? rand() % 2000 : rand() % 200000;
+			updates.push_back(update_type{at(usec), double(rand() % 10000) / 10 - 300, size_t(rand()) % partitions});
+		}
+		end_time = at(usec + rand() % 500000);
+
+		opts.moving_interval = handystats::chrono::duration(1000, handystats::chrono::time_unit::MSEC);
+		opts.rate_unit = handystats::chrono::time_unit::SEC;
+	}
+
+	// returns whole stream's statistics and merge of partitions' statistics
+	std::pair<statistics, statistics> run() const {
+		statistics whole(opts);
+		std::vector<statistics> parts(partitions, statistics(opts));
+
+		for (auto update = updates.cbegin(); update != updates.cend(); ++update) {
+			whole.update(update->value, update->timestamp);
+			parts[update->partition].update(update->value, update->timestamp);
+		}
+
+		whole.update_time(end_time);
+
+		statistics merged(opts);
+		for (auto part = parts.begin(); part != parts.end(); ++part) {
+			part->update_time(end_time);
+			merged.merge(*part);
+		}
+
+		return std::make_pair(whole, merged);
+	}
+
+	static void expect_relative(const double& actual, const double& expected, const char* name) {
+		EXPECT_NEAR(actual, expected, std::max(std::abs(expected), 1.0) * 1E-9) << name;
+	}
+
+	handystats::config::statistics opts;
+	handystats::chrono::test_timestamps<handystats::chrono::time_unit::USEC> at;
+	statistics::time_point end_time;
+	size_t partitions;
+	std::vector<update_type> updates;
+};
+
+TEST_P(StatisticsMergeTest, TotalsMatchWholeStream) {
+	opts.tags =
+		statistics::tag::value | statistics::tag::min | statistics::tag::max |
+		statistics::tag::count | statistics::tag::sum | statistics::tag::avg |
+		statistics::tag::timestamp;
+
+	const auto& result = run();
+	const statistics& whole = result.first;
+	const statistics& merged = result.second;
+
+	ASSERT_EQ(merged.get<statistics::tag::count>(), whole.get<statistics::tag::count>());
+	ASSERT_EQ(merged.get<statistics::tag::min>(), whole.get<statistics::tag::min>());
+	ASSERT_EQ(merged.get<statistics::tag::max>(), whole.get<statistics::tag::max>());
+	ASSERT_EQ(merged.get<statistics::tag::value>(), whole.get<statistics::tag::value>());
+	ASSERT_EQ(merged.get<statistics::tag::timestamp>(), whole.get<statistics::tag::timestamp>());
+	expect_relative(merged.get<statistics::tag::sum>(), whole.get<statistics::tag::sum>(), "sum");
+	expect_relative(merged.get<statistics::tag::avg>(), whole.get<statistics::tag::avg>(), "avg");
+}
+
+TEST_P(StatisticsMergeTest, WindowMatchesWholeStream) {
+	opts.moving_window = handystats::config::statistics::BUCKETS;
+	opts.tags =
+		statistics::tag::moving_count | statistics::tag::moving_sum | statistics::tag::moving_avg |
+		statistics::tag::moving_min | statistics::tag::moving_max;
+
+	const auto& result = run();
+	const statistics& whole = result.first;
+	const statistics& merged = result.second;
+
+	ASSERT_EQ(merged.get<statistics::tag::moving_count>(), whole.get<statistics::tag::moving_count>());
+	ASSERT_EQ(merged.get<statistics::tag::moving_min>(), whole.get<statistics::tag::moving_min>());
+	ASSERT_EQ(merged.get<statistics::tag::moving_max>(), whole.get<statistics::tag::moving_max>());
+	expect_relative(merged.get<statistics::tag::moving_sum>(), whole.get<statistics::tag::moving_sum>(), "moving-sum");
+	expect_relative(merged.get<statistics::tag::moving_avg>(), whole.get<statistics::tag::moving_avg>(), "moving-avg");
+}
+
+TEST_P(StatisticsMergeTest, CountersRateIsSumOfRates) {
+	// partitions are per-thread counters, the whole stream is their total
+	opts.moving_window = handystats::config::statistics::BUCKETS;
+	opts.tags = statistics::tag::rate;
+
+	statistics whole(opts);
+	std::vector<statistics> parts(partitions, statistics(opts));
+	std::vector<double> counters(partitions, 0);
+	double total = 0;
+
+	for (auto update = updates.cbegin(); update != updates.cend(); ++update) {
+		const double increment = std::abs(update->value);
+		counters[update->partition] += increment;
+		total += increment;
+		whole.update(total, update->timestamp);
+		parts[update->partition].update(counters[update->partition], update->timestamp);
+	}
+
+	whole.update_time(end_time);
+	statistics merged(opts);
+	for (auto part = parts.begin(); part != parts.end(); ++part) {
+		part->update_time(end_time);
+		merged.merge(*part);
+	}
+
+	expect_relative(merged.get<statistics::tag::rate>(), whole.get<statistics::tag::rate>(), "rate");
+}
+
+TEST_P(StatisticsMergeTest, DecayedDataIsSumOfPartitions) {
+	const handystats::config::statistics::histogram_kind histogram_types[] = {
+		handystats::config::statistics::LOG_LINEAR,
+		handystats::config::statistics::SKETCH
+	};
+
+	for (const auto& histogram_type : histogram_types) {
+		opts.histogram_type = histogram_type;
+		opts.sketch_max_buckets = 10000;
+		opts.tags =
+			statistics::tag::moving_count | statistics::tag::moving_sum | statistics::tag::rate |
+			statistics::tag::histogram;
+
+		std::vector<statistics> parts(partitions, statistics(opts));
+		for (auto update = updates.cbegin(); update != updates.cend(); ++update) {
+			parts[update->partition].update(update->value, update->timestamp);
+		}
+
+		statistics merged(opts);
+		double moving_count = 0;
+		double moving_sum = 0;
+		double rate = 0;
+		std::map<double, double> bins;
+
+		for (auto part = parts.begin(); part != parts.end(); ++part) {
+			part->update_time(end_time);
+			merged.merge(*part);
+
+			moving_count += part->get<statistics::tag::moving_count>();
+			moving_sum += part->get<statistics::tag::moving_sum>();
+			rate += part->get<statistics::tag::rate>();
+			const auto& histogram = part->get<statistics::tag::histogram>();
+			for (auto bin = histogram.cbegin(); bin != histogram.cend(); ++bin) {
+				bins[std::get<statistics::BIN_CENTER>(*bin)] += std::get<statistics::BIN_COUNT>(*bin);
+			}
+		}
+
+		expect_relative(merged.get<statistics::tag::moving_count>(), moving_count, "moving-count");
+		expect_relative(merged.get<statistics::tag::moving_sum>(), moving_sum, "moving-sum");
+		expect_relative(merged.get<statistics::tag::rate>(), rate, "rate");
+
+		const auto& histogram = merged.get<statistics::tag::histogram>();
+		size_t bins_count = 0;
+		for (auto bin = histogram.cbegin(); bin != histogram.cend(); ++bin) {
+			if (std::get<statistics::BIN_COUNT>(*bin) > 1E-9) {
+				++bins_count;
+				expect_relative(std::get<statistics::BIN_COUNT>(*bin), bins[std::get<statistics::BIN_CENTER>(*bin)], "bin");
+			}
+		}
+		size_t expected_bins_count = 0;
+		for (auto bin = bins.cbegin(); bin != bins.cend(); ++bin) {
+			expected_bins_count += bin->second > 1E-9;
+		}
+		ASSERT_EQ(bins_count, expected_bins_count);
+	}
+}
+
+TEST_P(StatisticsMergeTest, AdaptiveHistogramKeepsCount) {
+	opts.histogram_bins = 30;
+	opts.tags = statistics::tag::histogram | statistics::tag::quantile | statistics::tag::moving_count;
+
+	// no decay within single timestamp
+	statistics whole(opts);
+	std::vector<statistics> parts(partitions, statistics(opts));
+	for (auto update = updates.cbegin(); update != updates.cend(); ++update) {
+		whole.update(update->value, end_time);
+		parts[update->partition].update(update->value, end_time);
+	}
+
+	statistics merged(opts);
+	double expected_count = 0;
+	for (auto part = parts.cbegin(); part != parts.cend(); ++part) {
+		merged.merge(*part);
+
+		const auto& histogram = part->get<statistics::tag::histogram>();
+		for (auto bin = histogram.cbegin(); bin != histogram.cend(); ++bin) {
+			expected_count += std::get<statistics::BIN_COUNT>(*bin);
+		}
+	}
+
+	const auto& histogram = merged.get<statistics::tag::histogram>();
+	ASSERT_LE(histogram.size(), opts.histogram_bins);
+
+	double count = 0;
+	for (auto bin = histogram.cbegin(); bin != histogram.cend(); ++bin) {
+		count += std::get<statistics::BIN_COUNT>(*bin);
+	}
+	expect_relative(count, expected_count, "count");
+
+	// values are uniform in [-300, 700)
+	const double probabilities[] = {0.1, 0.5, 0.9};
+	for (const double& probability : probabilities) {
+		EXPECT_NEAR(
+				merged.get<statistics::tag::quantile>().at(probability),
+				whole.get<statistics::tag::quantile>().at(probability),
+				1000 * 0.05
+			) << "p = " << probability;
+	}
+}
+
+TEST_P(StatisticsMergeTest, MergeWithItself) {
+	opts.tags = statistics::tag::count | statistics::tag::sum | statistics::tag::moving_count;
+
+	statistics stats(opts);
+	for (auto update = updates.cbegin(); update != updates.cend(); ++update) {
+		stats.update(update->value, update->timestamp);
+	}
+
+	const size_t count = stats.get<statistics::tag::count>();
+	const double sum = stats.get<statistics::tag::sum>();
+	const double moving_count = stats.get<statistics::tag::moving_count>();
+
+	stats.merge(stats);
+
+	ASSERT_EQ(stats.get<statistics::tag::count>(), 2 * count);
+	expect_relative(stats.get<statistics::tag::sum>(), 2 * sum, "sum");
+	expect_relative(stats.get<statistics::tag::moving_count>(), 2 * moving_count, "moving-count");
+}
+
+INSTANTIATE_TEST_CASE_P(RandomStreams, StatisticsMergeTest, ::testing::Range(1, 9));
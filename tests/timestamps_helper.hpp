@@ -0,0 +1,29 @@
+// Copyright (c) 2014 Yandex LLC. All rights reserved.
+
+#ifndef HANDYSTATS_TESTS_TIMESTAMPS_HELPER_HPP_
+#define HANDYSTATS_TESTS_TIMESTAMPS_HELPER_HPP_
+
+#include <cstdint>
+
+#include <handystats/chrono.hpp>
+
+namespace handystats { namespace chrono {
+
+// Test timestamps are TSC ticks as in measuring points,
+// at(count) is count of Unit since the helper's construction
+template <time_unit Unit>
+struct test_timestamps {
+	test_timestamps()
+		: base_time(tsc_clock::now())
+	{}
+
+	time_point operator() (const int64_t& count) const {
+		return base_time + duration(count, Unit);
+	}
+
+	time_point base_time;
+};
+
+}} // namespace handystats::chrono
+
+#endif // HANDYSTATS_TESTS_TIMESTAMPS_HELPER_HPP_